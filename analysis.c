@@ -2,6 +2,25 @@
 #include <string.h>
 #include <ctype.h>
 #include "analysis.h"
+#include "dictionaries.h"
+#include "format.h"
+#include "symbol_table.h"
+
+// Find the next identifier-like word at or after *cursor and advance past it.
+// Returns its length, or 0 when the line has no more words.
+static int nextWord(const char **cursor, const char **word) {
+    const char *current = *cursor;
+
+    while (*current != '\0' && !isalnum((unsigned char)*current) && *current != '_') {
+        current++;
+    }
+    *word = current;
+    while (isalnum((unsigned char)*current) || *current == '_') {
+        current++;
+    }
+    *cursor = current;
+    return (int)(current - *word);
+}
 
 // Check for syntax errors
 void checkSyntaxErrors(const char *line, int lineNumber) {
@@ -62,41 +81,43 @@ void checkSyntaxErrors(const char *line, int lineNumber) {
 }
 // Count standard and user-defined functions
 void countFunctions(const char *line, int *stdFuncCount, int *userFuncCount) {
-    const char *stdFuncs[] = {"printf", "scanf", "gets", "puts", "fscanf", "malloc", "free", "strlen"};
     const char *userFuncs[] = {"main", "addSymbol", "lookupSymbol", "printSymbolTable"};
+    const char *word;
+    int length;
 
-    for (int i = 0; i < sizeof(stdFuncs) / sizeof(stdFuncs[0]); i++) {
-        if (strstr(line, stdFuncs[i]) != NULL && 
-            (line == strstr(line, stdFuncs[i]) || !isalnum(line[strstr(line, stdFuncs[i]) - line - 1]))) {
+    while ((length = nextWord(&line, &word)) > 0) {
+        if (lookupStdLibFunction(word, length) >= 0) {
             (*stdFuncCount)++;
+            continue;
         }
-    }
-
-    for (int i = 0; i < sizeof(userFuncs) / sizeof(userFuncs[0]); i++) {
-        if (strstr(line, userFuncs[i]) != NULL && 
-            (line == strstr(line, userFuncs[i]) || !isalnum(line[strstr(line, userFuncs[i]) - line - 1]))) {
-            (*userFuncCount)++;
+        for (int i = 0; i < sizeof(userFuncs) / sizeof(userFuncs[0]); i++) {
+            if (strncmp(word, userFuncs[i], length) == 0 && userFuncs[i][length] == '\0') {
+                (*userFuncCount)++;
+            }
         }
     }
 }
 
 // Identify C keywords
 void identifyKeywords(const char *line) {
-    const char *keywords[] = {"int", "char", "double", "float", "for", "while", "if", "else", "return", "void", "struct", "typedef"};
-    for (int i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
-        if (strstr(line, keywords[i]) != NULL && 
-            (line == strstr(line, keywords[i]) || !isalnum(line[strstr(line, keywords[i]) - line - 1]))) {
-            printf("Keyword Found: %s\n", keywords[i]);
+    const char *word;
+    int length;
+
+    while ((length = nextWord(&line, &word)) > 0) {
+        int keyword = lookupKeyword(word, length);
+        if (keyword >= 0) {
+            printf("Keyword Found: %s\n", keywordNames[keyword]);
         }
     }
 }
 
 // Track standard library functions
 void trackLibraryFunctions(const char *line, int *libFuncCount) {
-    const char *libFuncs[] = {"printf", "scanf", "gets", "puts", "fscanf", "malloc", "free", "strlen", "strcpy", "strcat"};
-    for (int i = 0; i < sizeof(libFuncs) / sizeof(libFuncs[0]); i++) {
-        if (strstr(line, libFuncs[i]) != NULL && 
-            (line == strstr(line, libFuncs[i]) || !isalnum(line[strstr(line, libFuncs[i]) - line - 1]))) {
+    const char *word;
+    int length;
+
+    while ((length = nextWord(&line, &word)) > 0) {
+        if (lookupStdLibFunction(word, length) >= 0) {
             (*libFuncCount)++;
         }
     }
@@ -113,10 +134,242 @@ void analyzeVariableDeclarations(const char *line) {
     }
 }
 
-// Detect type mismatches (placeholder)
+// What a declared type can be handed to a conversion as
+typedef enum {
+    TYPE_UNKNOWN,           // A struct, typedef or anything else not checked
+    TYPE_CHAR,
+    TYPE_INTEGER,           // int, short, long, unsigned
+    TYPE_FLOAT,
+    TYPE_DOUBLE,
+    TYPE_STRING,            // char array or pointer
+    TYPE_POINTER            // Any other array or pointer, or an address taken with '&'
+} ArgumentType;
+
+// Parsed format strings by flavor, so a literal repeated through the file is parsed once
+static Arena formatArena = {0};
+static FormatCache formatCaches[2];
+static int formatCachesReady = 0;
+
+// What a symbol table type name ("int", "char *", "double[]") stands for
+static ArgumentType argumentType(const char *type) {
+    int indirect = strchr(type, '*') != NULL || strchr(type, '[') != NULL;
+
+    if (strncmp(type, "char", 4) == 0) {
+        return indirect ? TYPE_STRING : TYPE_CHAR;
+    }
+    if (indirect) {
+        return TYPE_POINTER;
+    }
+    if (strcmp(type, "float") == 0) {
+        return TYPE_FLOAT;
+    }
+    if (strcmp(type, "double") == 0) {
+        return TYPE_DOUBLE;
+    }
+    if (strcmp(type, "int") == 0 || strcmp(type, "short") == 0 || strcmp(type, "long") == 0 ||
+        strncmp(type, "unsigned", 8) == 0) {
+        return TYPE_INTEGER;
+    }
+    return TYPE_UNKNOWN;
+}
+
+// Whether an argument of the given type suits a conversion. scanf wants
+// the address of exactly the type, printf a value that promotes to it.
+static int typeMatches(FormatFlavor flavor, const FormatSpec *spec, ArgumentType type) {
+    switch (spec->conversion) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            return type == TYPE_INTEGER || (type == TYPE_CHAR && (flavor == FORMAT_PRINTF || spec->length == FORMAT_LENGTH_HH));
+        case 'c':
+            return type == TYPE_CHAR || (flavor == FORMAT_PRINTF && type == TYPE_INTEGER);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (flavor == FORMAT_PRINTF) {
+                return type == TYPE_FLOAT || type == TYPE_DOUBLE;
+            }
+            return spec->length == FORMAT_LENGTH_L ? type == TYPE_DOUBLE
+                 : spec->length == FORMAT_LENGTH_NONE ? type == TYPE_FLOAT : 1;
+        case 's': case '[':
+            return type == TYPE_STRING;
+        case 'p':
+            return type == TYPE_POINTER || type == TYPE_STRING;
+        default:
+            return 1;
+    }
+}
+
+// Move *cursor, at the ',' before an argument, past the argument, setting
+// *argument and *length to it without surrounding blanks. Returns 0 when
+// there is no further argument.
+static int nextArgument(const char **cursor, const char **argument, int *length) {
+    const char *current = *cursor;
+    int depth = 0;
+
+    while (*current == ' ' || *current == '\t') current++;
+    if (*current != ',') {
+        return 0;
+    }
+    current++;
+    while (*current == ' ' || *current == '\t') current++;
+
+    *argument = current;
+    for (; *current != '\0' && *current != '\n'; current++) {
+        if (*current == '"' || *current == '\'') {
+            char quote = *current;
+            for (current++; *current != '\0' && *current != quote; current++) {
+                if (*current == '\\' && current[1] != '\0') current++;
+            }
+            if (*current == '\0') break;
+        } else if (*current == '(' || *current == '[' || *current == '{') {
+            depth++;
+        } else if (*current == ')' || *current == ']' || *current == '}') {
+            if (depth == 0) break;
+            depth--;
+        } else if (*current == ',' && depth == 0) {
+            break;
+        }
+    }
+
+    *length = (int)(current - *argument);
+    while (*length > 0 && ((*argument)[*length - 1] == ' ' || (*argument)[*length - 1] == '\t')) {
+        (*length)--;
+    }
+    *cursor = current;
+    return 1;
+}
+
+// The length of a specification as written in its literal, from its '%'
+// through its conversion byte, and through the ']' closing a scanset
+static int specLength(const char *literal, const FormatSpec *spec) {
+    const char *start = literal + spec->offset;
+    const char *current = start + 1;
+
+    while (*current != '\0' && *current != '"' && (unsigned char)*current != spec->conversion) {
+        current++;
+    }
+    if (spec->conversion == '[' && *current == '[') {
+        current++;
+        if (*current == '^') current++;
+        if (*current == ']') current++;
+        while (*current != '\0' && *current != '"' && *current != ']') current++;
+    }
+    if (*current != '\0' && *current != '"') {
+        current++;
+    }
+    return (int)(current - start);
+}
+
+// Check one argument, when it is a plain variable or its address, against
+// its conversion, found at its offset in the literal, through the
+// variable's type in the symbol table
+static void checkArgument(FormatFlavor flavor, const char *literal, const FormatSpec *spec,
+                          const char *argument, int length, int lineNumber) {
+    const char *function = flavor == FORMAT_PRINTF ? "printf" : "scanf";
+    int address = length > 0 && argument[0] == '&';
+    char name[NAME_LENGTH];
+    Symbol symbol;
+
+    if (address) {
+        argument++;
+        length--;
+        while (length > 0 && (*argument == ' ' || *argument == '\t')) {
+            argument++;
+            length--;
+        }
+    }
+    if (length == 0 || length >= NAME_LENGTH || spec->conversion == 0) {
+        return;
+    }
+    for (int i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)argument[i]) && argument[i] != '_') {
+            return; // An expression: its type is not known here
+        }
+    }
+
+    memcpy(name, argument, length);
+    name[length] = '\0';
+    if (!lookupSymbol(name, 1, &symbol) || symbol.isFunction) {
+        return;
+    }
+
+    const char *typeName = symbolText(symbol.type);
+    ArgumentType type = argumentType(typeName);
+    if (type == TYPE_UNKNOWN) {
+        return;
+    }
+
+    if (flavor == FORMAT_SCANF && !address && type != TYPE_STRING && type != TYPE_POINTER) {
+        printf("Error at line %d: Missing '&' before '%s' in scanf.\n", lineNumber, name);
+        return;
+    }
+    if (flavor == FORMAT_PRINTF && address) {
+        type = TYPE_POINTER;
+        typeName = "pointer";
+    }
+    if (!typeMatches(flavor, spec, type)) {
+        printf("Error at line %d: Format specifier '%.*s' does not match type '%s' of '%s' in %s.\n",
+               lineNumber, specLength(literal, spec), literal + spec->offset, typeName, name, function);
+    }
+}
+
+// Check the arguments of each printf and scanf call on a line against the
+// conversions of its format string
 void detectTypeMismatches(const char *line, int lineNumber) {
-    // Placeholder for type mismatch detection logic
-    // For now, do nothing to avoid spurious messages
+    const char *cursor = line;
+    const char *word;
+    int length;
+
+    if (!formatCachesReady) {
+        formatCacheInit(&formatCaches[FORMAT_PRINTF], &formatArena, FORMAT_PRINTF);
+        formatCacheInit(&formatCaches[FORMAT_SCANF], &formatArena, FORMAT_SCANF);
+        formatCachesReady = 1;
+    }
+
+    while ((length = nextWord(&cursor, &word)) > 0) {
+        FormatFlavor flavor;
+        if (length == 6 && strncmp(word, "printf", 6) == 0) {
+            flavor = FORMAT_PRINTF;
+        } else if (length == 5 && strncmp(word, "scanf", 5) == 0) {
+            flavor = FORMAT_SCANF;
+        } else {
+            continue;
+        }
+
+        // The call's first argument must be the format string literal
+        const char *current = cursor;
+        while (*current == ' ' || *current == '\t') current++;
+        if (*current != '(') continue;
+        current++;
+        while (*current == ' ' || *current == '\t') current++;
+        if (*current != '"') continue;
+
+        const char *start = ++current;
+        while (*current != '\0' && *current != '"') {
+            if (*current == '\\' && current[1] != '\0') current++;
+            current++;
+        }
+        if (*current != '"') continue;
+
+        const FormatString *format = formatCompile(&formatCaches[flavor], start, (int)(current - start));
+        const char *argument;
+        int argumentLength;
+
+        cursor = current + 1;
+        for (int i = 0; i < format->count; i++) {
+            const FormatSpec *spec = &format->specs[i];
+            int stars = !!(spec->flags & FORMAT_STAR_WIDTH) + !!(spec->flags & FORMAT_STAR_PRECISION);
+
+            // '*' widths and precisions take ints of their own; suppressed scanf conversions take nothing
+            for (int star = 0; star < stars; star++) {
+                nextArgument(&cursor, &argument, &argumentLength);
+            }
+            if (spec->flags & FORMAT_SUPPRESSED) {
+                continue;
+            }
+            if (!nextArgument(&cursor, &argument, &argumentLength)) {
+                break;
+            }
+            checkArgument(flavor, start, spec, argument, argumentLength, lineNumber);
+        }
+    }
 }
 
 // Check for complex expressions
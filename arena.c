@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_BLOCK_SIZE (256 * 1024)   // Default size of a block
+#define ARENA_ALIGNMENT 16              // Alignment of every allocation
+#define ARENA_MIN_CAPACITY 64           // First capacity used by arenaGrowArray
+
+#define ALIGN_UP(n) (((n) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+struct ArenaBlock {
+    ArenaBlock *next;   // Previously filled block
+    size_t size;        // Usable bytes in this block
+    size_t used;        // Bytes handed out so far
+};
+
+// Usable memory starts right after the (aligned) block header
+static unsigned char *blockData(ArenaBlock *block) {
+    return (unsigned char *)block + ALIGN_UP(sizeof(ArenaBlock));
+}
+
+// Allocate uninitialized, aligned memory from the arena
+void *arenaAlloc(Arena *arena, size_t size) {
+    ArenaBlock *block = arena->head;
+    size = ALIGN_UP(size ? size : 1);
+
+    if (!block || block->size - block->used < size) {
+        size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+
+        block = malloc(ALIGN_UP(sizeof(ArenaBlock)) + blockSize);
+        if (!block) {
+            printf("Error: Out of memory (arena block of %zu bytes)\n", blockSize);
+            exit(1);
+        }
+        block->size = blockSize;
+        block->used = 0;
+
+        // Oversized requests get a block of their own; keep filling the current one
+        if (arena->head && blockSize == size) {
+            block->next = arena->head->next;
+            arena->head->next = block;
+            block->used = size;
+            return blockData(block);
+        }
+
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void *result = blockData(block) + block->used;
+    block->used += size;
+    return result;
+}
+
+// Resize an allocation, extending it in place when it is the last one in the current block
+void *arenaGrow(Arena *arena, void *block, size_t oldSize, size_t newSize) {
+    ArenaBlock *head = arena->head;
+
+    if (block && head) {
+        unsigned char *data = blockData(head);
+        size_t start = (unsigned char *)block - data;
+
+        if ((unsigned char *)block >= data && start + ALIGN_UP(oldSize) == head->used &&
+            start + ALIGN_UP(newSize) <= head->size) {
+            head->used = start + ALIGN_UP(newSize);
+            return block;
+        }
+    }
+
+    void *result = arenaAlloc(arena, newSize);
+    if (block && oldSize) {
+        memcpy(result, block, oldSize < newSize ? oldSize : newSize);
+    }
+    return result;
+}
+
+// Make room for one more element in an arena-backed array, doubling its capacity when full
+void *arenaGrowArray(Arena *arena, void *array, int count, int *capacity, size_t elementSize) {
+    if (count < *capacity) {
+        return array;
+    }
+
+    int newCapacity = *capacity ? *capacity * 2 : ARENA_MIN_CAPACITY;
+    array = arenaGrow(arena, array, (size_t)*capacity * elementSize, (size_t)newCapacity * elementSize);
+    *capacity = newCapacity;
+    return array;
+}
+
+// Copy length bytes of text into the arena as a NUL-terminated string
+char *arenaStrndup(Arena *arena, const char *text, size_t length) {
+    char *copy = arenaAlloc(arena, length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Move every block of from into arena, leaving from empty; arena goes on
+// allocating from its own current block
+void arenaAdopt(Arena *arena, Arena *from) {
+    ArenaBlock *tail = from->head;
+
+    if (!tail) {
+        return;
+    }
+    if (!arena->head) {
+        arena->head = from->head;
+        from->head = NULL;
+        return;
+    }
+
+    while (tail->next) {
+        tail = tail->next;
+    }
+    tail->next = arena->head->next;
+    arena->head->next = from->head;
+    from->head = NULL;
+}
+
+// Release every block owned by the arena
+void arenaFree(Arena *arena) {
+    ArenaBlock *block = arena->head;
+
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
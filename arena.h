@@ -0,0 +1,21 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// A bump allocator: memory is carved out of large blocks and released all at once
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;   // Block currently being allocated from
+} Arena;
+
+// Function prototypes
+void *arenaAlloc(Arena *arena, size_t size);
+void *arenaGrow(Arena *arena, void *block, size_t oldSize, size_t newSize);
+void *arenaGrowArray(Arena *arena, void *array, int count, int *capacity, size_t elementSize);
+char *arenaStrndup(Arena *arena, const char *text, size_t length);
+void arenaAdopt(Arena *arena, Arena *from);
+void arenaFree(Arena *arena);
+
+#endif // ARENA_H
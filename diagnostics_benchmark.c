@@ -0,0 +1,178 @@
+/* Diagnostic output benchmark.
+ *
+ * Analyzes an input full of errors once, then times printing every error
+ * it found: with one line-buffered printf per error, once and twice (as it
+ * is found and again in the results, as latest.c used to), through a file
+ * sink, and through a null sink, which leaves only the rendering. The two
+ * savings are reported apart: buffering compares printf and the file sink
+ * printing each error once, and duplicate output compares printf printing
+ * each error twice and once. latest.c is compiled in directly, so its
+ * main() is renamed out of the way, and told to keep every error it prints
+ * in errors[].
+ *
+ *     gcc -O2 -o diagnostics_benchmark diagnostics_benchmark.c arena.c simd_scan.c dictionaries.c intern.c thread_pool.c scope.c fuzzy.c suggest.c format.c parser.c sink.c profile.c -pthread
+ *     ./diagnostics_benchmark [source_file] [repetitions]
+ *
+ * Without a file, a synthetic input with about 200,000 errors is generated.
+ * The printf and file runs write to /dev/null.
+ */
+#include <time.h>
+
+#define main latestMain
+#define KEEP_ERROR_RECORDS
+#include "latest.c"
+#undef main
+
+#define BENCH_DEFAULT_COPIES 20000
+#define BENCH_DEFAULT_REPETITIONS 5
+#define BENCH_DISCARD_PATH "/dev/null"
+
+/* One unit of the synthetic input, inside main(): ten errors, give or take */
+static const char *benchSnippet =
+    "    int count\n"
+    "    total = count + missing\n"
+    "    printf(\"%q %d %s\\n\", count);\n"
+    "    scanf(\"%d\", count);\n"
+    "    Printf(\"%d\", 'ab');\n"
+    "    values[count] = (count + 1];\n";
+
+/**
+ * Returns a monotonic timestamp in seconds
+ */
+static double benchNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * Prints every error the way latest.c did before the sink: rendered into a
+ * message buffer and printf'd as found, a write per line; if twice, then
+ * rendered and printf'd again in the results
+ */
+static void benchPrintfErrors(FILE *file, bool twice) {
+    char message[MAX_ERROR_MSG_LENGTH];
+
+    for (int i = 0; i < errorCount; i++) {
+        formatError(&errors[i], message, sizeof(message));
+        fprintf(file, "Error at line %d, column %d: %s\n", errorLine(&errors[i]), errorColumn(&errors[i]), message);
+    }
+    for (int i = 0; twice && i < errorCount; i++) {
+        formatError(&errors[i], message, sizeof(message));
+        fprintf(file, "Error #%d at line %d, column %d: %s\n", i + 1, errorLine(&errors[i]), errorColumn(&errors[i]), message);
+    }
+}
+
+/**
+ * Emits every error once through the output sink
+ */
+static void benchSinkErrors() {
+    for (int i = 0; i < errorCount; i++) {
+        emitError(&errors[i]);
+    }
+}
+
+/**
+ * Times one printf run over the errors into a line-buffered discard file
+ */
+static double benchPrintfRun(bool twice) {
+    FILE *file = fopen(BENCH_DISCARD_PATH, "w");
+    if (file == NULL) {
+        printf("Error: Cannot open %s\n", BENCH_DISCARD_PATH);
+        exit(1);
+    }
+    setvbuf(file, NULL, _IOLBF, BUFSIZ);
+    double start = benchNow();
+    benchPrintfErrors(file, twice);
+    fflush(file);
+    double elapsed = benchNow() - start;
+    fclose(file);
+    return elapsed;
+}
+
+/**
+ * Reports the best time of a run over the errors, in ms and errors per second
+ */
+static void benchReport(const char *name, double best) {
+    printf("  %-34s %9.2f ms  %8.2f M errors/s\n", name, best * 1e3, errorCount / best / 1e6);
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_REPETITIONS;
+
+    if (argc > 1) {
+        readSourceFile(argv[1]);
+    } else {
+        size_t snippetLength = strlen(benchSnippet);
+        const char *head = "int main() {\n";
+        const char *tail = "}\n";
+        size_t length = strlen(head) + BENCH_DEFAULT_COPIES * snippetLength + strlen(tail);
+
+        sourceCode = malloc(length + 1 + SIMD_SCAN_PADDING);
+        if (sourceCode == NULL) {
+            printf("Error: Out of memory\n");
+            exit(1);
+        }
+        char *end = sourceCode;
+        end += sprintf(end, "%s", head);
+        for (int i = 0; i < BENCH_DEFAULT_COPIES; i++) {
+            memcpy(end, benchSnippet, snippetLength);
+            end += snippetLength;
+        }
+        end += sprintf(end, "%s", tail);
+        sourceLength = length;
+        memset(sourceCode + sourceLength, 0, 1 + SIMD_SCAN_PADDING);
+        indexLines();
+    }
+
+    // The analysis itself prints into a null sink
+    simdScanInit(SIMD_AVX2);
+    sinkOpenNull(&output);
+    double start = benchNow();
+    tokenize();
+    analyzeCode();
+    double analysis = benchNow() - start;
+
+    printf("Input: %.1f MB, %d errors (%zu bytes each), analyzed in %.1f ms; best of %d runs\n",
+           sourceLength / 1e6, errorCount, sizeof(Error), analysis * 1e3, repetitions);
+    if (errorCount == 0) {
+        return 0;
+    }
+
+    double best[4] = {1e9, 1e9, 1e9, 1e9};
+    for (int r = 0; r < repetitions; r++) {
+        double elapsed = benchPrintfRun(true);
+        best[0] = elapsed < best[0] ? elapsed : best[0];
+
+        elapsed = benchPrintfRun(false);
+        best[1] = elapsed < best[1] ? elapsed : best[1];
+
+        if (!sinkOpenFile(&output, BENCH_DISCARD_PATH)) {
+            printf("Error: Cannot open %s\n", BENCH_DISCARD_PATH);
+            exit(1);
+        }
+        start = benchNow();
+        benchSinkErrors();
+        sinkClose(&output);
+        elapsed = benchNow() - start;
+        best[2] = elapsed < best[2] ? elapsed : best[2];
+
+        sinkOpenNull(&output);
+        start = benchNow();
+        benchSinkErrors();
+        sinkClose(&output);
+        elapsed = benchNow() - start;
+        best[3] = elapsed < best[3] ? elapsed : best[3];
+    }
+
+    benchReport("printf per error, twice:", best[0]);
+    benchReport("printf per error, once:", best[1]);
+    benchReport("file sink, once:", best[2]);
+    benchReport("null sink (rendering only):", best[3]);
+    printf("Buffering (printf once / file sink): %.2fx\n", best[1] / best[2]);
+    printf("Duplicate output (printf twice / once): %.2fx\n", best[0] / best[1]);
+
+    releaseSourceFile();
+    arenaFree(&analysisArena);
+    return 0;
+}
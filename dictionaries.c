@@ -0,0 +1,270 @@
+/* Generated by gen_dictionaries.c - do not edit */
+#include <string.h>
+#include "dictionaries.h"
+
+static unsigned int dictionaryHash(const char *text, int length) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static unsigned int dictionaryMix(unsigned int hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    return hash ^ (hash >> 16);
+}
+
+const char *const keywordNames[KEYWORD_COUNT] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do",
+    "double", "else", "enum", "extern", "float", "for", "goto", "if",
+    "int", "long", "register", "return", "short", "signed", "sizeof", "static",
+    "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while"
+};
+
+static const unsigned char keywordLengths[KEYWORD_COUNT] = {
+    4, 5, 4, 4, 5, 8, 7, 2, 6, 4, 4, 6, 5, 3, 4, 2,
+    3, 4, 8, 6, 5, 6, 6, 6, 6, 6, 7, 5, 8, 4, 8, 5
+};
+
+static const unsigned int keywordSeeds[16] = {
+    0, 2, 0, 6, 0, 3, 3, 0, 4, 0, 0, 0, 0, 2, 1, 3
+};
+
+static const short keywordSlots[64] = {
+    -1, -1, 12, -1, -1, 19, 6, -1, -1, -1, 13, 1, 0, 25, 20, -1,
+    27, 7, 29, -1, 16, -1, 4, -1, -1, 14, -1, -1, 9, 2, -1, 30,
+    -1, -1, 23, -1, 28, 22, 8, -1, -1, 10, 21, -1, 24, 18, -1, 31,
+    3, 5, -1, 17, 26, -1, -1, -1, -1, 11, -1, -1, 15, -1, -1, -1
+};
+
+/**
+ * Returns the index in keywordNames[] of a C keyword, or -1
+ */
+int lookupKeyword(const char *text, int length) {
+    if (length <= 0 || length > 8) {
+        return -1;
+    }
+
+    unsigned int hash = dictionaryHash(text, length);
+    int index = keywordSlots[dictionaryMix(hash ^ keywordSeeds[hash & 15]) & 63];
+    if (index < 0 || keywordLengths[index] != length || memcmp(keywordNames[index], text, length) != 0) {
+        return -1;
+    }
+    return index;
+}
+
+const char *const stdLibFunctionNames[STDLIB_FUNCTION_COUNT] = {
+    "assert", "cabs", "cabsf", "cabsl", "cacos", "cacosf", "cacosl", "cacosh",
+    "cacoshf", "cacoshl", "carg", "cargf", "cargl", "casin", "casinf", "casinl",
+    "casinh", "casinhf", "casinhl", "catan", "catanf", "catanl", "catanh", "catanhf",
+    "catanhl", "ccos", "ccosf", "ccosl", "ccosh", "ccoshf", "ccoshl", "cexp",
+    "cexpf", "cexpl", "cimag", "cimagf", "cimagl", "clog", "clogf", "clogl",
+    "conj", "conjf", "conjl", "cpow", "cpowf", "cpowl", "cproj", "cprojf",
+    "cprojl", "creal", "crealf", "creall", "csin", "csinf", "csinl", "csinh",
+    "csinhf", "csinhl", "csqrt", "csqrtf", "csqrtl", "ctan", "ctanf", "ctanl",
+    "ctanh", "ctanhf", "ctanhl", "CMPLX", "CMPLXF", "CMPLXL", "isalnum", "isalpha",
+    "isblank", "iscntrl", "isdigit", "isgraph", "islower", "isprint", "ispunct", "isspace",
+    "isupper", "isxdigit", "tolower", "toupper", "feclearexcept", "fegetexceptflag", "feraiseexcept", "fesetexceptflag",
+    "fetestexcept", "fegetround", "fesetround", "fegetenv", "feholdexcept", "fesetenv", "feupdateenv", "imaxabs",
+    "imaxdiv", "strtoimax", "strtoumax", "wcstoimax", "wcstoumax", "setlocale", "localeconv", "fpclassify",
+    "isfinite", "isinf", "isnan", "isnormal", "signbit", "acos", "acosf", "acosl",
+    "asin", "asinf", "asinl", "atan", "atanf", "atanl", "atan2", "atan2f",
+    "atan2l", "cos", "cosf", "cosl", "sin", "sinf", "sinl", "tan",
+    "tanf", "tanl", "acosh", "acoshf", "acoshl", "asinh", "asinhf", "asinhl",
+    "atanh", "atanhf", "atanhl", "cosh", "coshf", "coshl", "sinh", "sinhf",
+    "sinhl", "tanh", "tanhf", "tanhl", "exp", "expf", "expl", "exp2",
+    "exp2f", "exp2l", "expm1", "expm1f", "expm1l", "frexp", "frexpf", "frexpl",
+    "ilogb", "ilogbf", "ilogbl", "ldexp", "ldexpf", "ldexpl", "log", "logf",
+    "logl", "log10", "log10f", "log10l", "log1p", "log1pf", "log1pl", "log2",
+    "log2f", "log2l", "logb", "logbf", "logbl", "modf", "modff", "modfl",
+    "scalbn", "scalbnf", "scalbnl", "scalbln", "scalblnf", "scalblnl", "cbrt", "cbrtf",
+    "cbrtl", "fabs", "fabsf", "fabsl", "hypot", "hypotf", "hypotl", "pow",
+    "powf", "powl", "sqrt", "sqrtf", "sqrtl", "erf", "erff", "erfl",
+    "erfc", "erfcf", "erfcl", "lgamma", "lgammaf", "lgammal", "tgamma", "tgammaf",
+    "tgammal", "ceil", "ceilf", "ceill", "floor", "floorf", "floorl", "nearbyint",
+    "nearbyintf", "nearbyintl", "rint", "rintf", "rintl", "lrint", "lrintf", "lrintl",
+    "llrint", "llrintf", "llrintl", "round", "roundf", "roundl", "lround", "lroundf",
+    "lroundl", "llround", "llroundf", "llroundl", "trunc", "truncf", "truncl", "fmod",
+    "fmodf", "fmodl", "remainder", "remainderf", "remainderl", "remquo", "remquof", "remquol",
+    "copysign", "copysignf", "copysignl", "nan", "nanf", "nanl", "nextafter", "nextafterf",
+    "nextafterl", "nexttoward", "nexttowardf", "nexttowardl", "fdim", "fdimf", "fdiml", "fmax",
+    "fmaxf", "fmaxl", "fmin", "fminf", "fminl", "fma", "fmaf", "fmal",
+    "isgreater", "isgreaterequal", "isless", "islessequal", "islessgreater", "isunordered", "setjmp", "longjmp",
+    "signal", "raise", "va_start", "va_arg", "va_copy", "va_end", "atomic_init", "kill_dependency",
+    "atomic_thread_fence", "atomic_signal_fence", "atomic_is_lock_free", "atomic_store", "atomic_store_explicit", "atomic_load", "atomic_load_explicit", "atomic_exchange",
+    "atomic_exchange_explicit", "atomic_compare_exchange_strong", "atomic_compare_exchange_strong_explicit", "atomic_compare_exchange_weak", "atomic_compare_exchange_weak_explicit", "atomic_fetch_add", "atomic_fetch_add_explicit", "atomic_fetch_sub",
+    "atomic_fetch_sub_explicit", "atomic_fetch_or", "atomic_fetch_or_explicit", "atomic_fetch_xor", "atomic_fetch_xor_explicit", "atomic_fetch_and", "atomic_fetch_and_explicit", "atomic_flag_test_and_set",
+    "atomic_flag_test_and_set_explicit", "atomic_flag_clear", "atomic_flag_clear_explicit", "offsetof", "remove", "rename", "tmpfile", "tmpnam",
+    "fclose", "fflush", "fopen", "freopen", "setbuf", "setvbuf", "fprintf", "fscanf",
+    "printf", "scanf", "snprintf", "sprintf", "sscanf", "vfprintf", "vfscanf", "vprintf",
+    "vscanf", "vsnprintf", "vsprintf", "vsscanf", "fgetc", "fgets", "fputc", "fputs",
+    "getc", "getchar", "gets", "putc", "putchar", "puts", "ungetc", "fread",
+    "fwrite", "fgetpos", "fseek", "fsetpos", "ftell", "rewind", "clearerr", "feof",
+    "ferror", "perror", "atof", "atoi", "atol", "atoll", "strtod", "strtof",
+    "strtold", "strtol", "strtoll", "strtoul", "strtoull", "rand", "srand", "aligned_alloc",
+    "calloc", "free", "malloc", "realloc", "abort", "atexit", "at_quick_exit", "exit",
+    "_Exit", "getenv", "quick_exit", "system", "bsearch", "qsort", "abs", "labs",
+    "llabs", "div", "ldiv", "lldiv", "mblen", "mbtowc", "wctomb", "mbstowcs",
+    "wcstombs", "memcpy", "memmove", "strcpy", "strncpy", "strcat", "strncat", "memcmp",
+    "strcmp", "strcoll", "strncmp", "strxfrm", "memchr", "strchr", "strcspn", "strpbrk",
+    "strrchr", "strspn", "strstr", "strtok", "memset", "strerror", "strlen", "call_once",
+    "cnd_broadcast", "cnd_destroy", "cnd_init", "cnd_signal", "cnd_timedwait", "cnd_wait", "mtx_destroy", "mtx_init",
+    "mtx_lock", "mtx_timedlock", "mtx_trylock", "mtx_unlock", "thrd_create", "thrd_current", "thrd_detach", "thrd_equal",
+    "thrd_exit", "thrd_join", "thrd_sleep", "thrd_yield", "tss_create", "tss_delete", "tss_get", "tss_set",
+    "clock", "difftime", "mktime", "time", "timespec_get", "asctime", "ctime", "gmtime",
+    "localtime", "strftime", "mbrtoc16", "c16rtomb", "mbrtoc32", "c32rtomb", "fwprintf", "fwscanf",
+    "swprintf", "swscanf", "vfwprintf", "vfwscanf", "vswprintf", "vswscanf", "vwprintf", "vwscanf",
+    "wprintf", "wscanf", "fgetwc", "fgetws", "fputwc", "fputws", "fwide", "getwc",
+    "getwchar", "putwc", "putwchar", "ungetwc", "wcstod", "wcstof", "wcstold", "wcstol",
+    "wcstoll", "wcstoul", "wcstoull", "wcscpy", "wcsncpy", "wmemcpy", "wmemmove", "wcscat",
+    "wcsncat", "wcscmp", "wcscoll", "wcsncmp", "wcsxfrm", "wmemcmp", "wcschr", "wcscspn",
+    "wcspbrk", "wcsrchr", "wcsspn", "wcsstr", "wcstok", "wmemchr", "wcslen", "wmemset",
+    "wcsftime", "btowc", "wctob", "mbsinit", "mbrlen", "mbrtowc", "wcrtomb", "mbsrtowcs",
+    "wcsrtombs", "iswalnum", "iswalpha", "iswblank", "iswcntrl", "iswdigit", "iswgraph", "iswlower",
+    "iswprint", "iswpunct", "iswspace", "iswupper", "iswxdigit", "iswctype", "wctype", "towlower",
+    "towupper", "towctrans", "wctrans"
+};
+
+static const unsigned char stdLibFunctionLengths[STDLIB_FUNCTION_COUNT] = {
+    6, 4, 5, 5, 5, 6, 6, 6, 7, 7, 4, 5, 5, 5, 6, 6,
+    6, 7, 7, 5, 6, 6, 6, 7, 7, 4, 5, 5, 5, 6, 6, 4,
+    5, 5, 5, 6, 6, 4, 5, 5, 4, 5, 5, 4, 5, 5, 5, 6,
+    6, 5, 6, 6, 4, 5, 5, 5, 6, 6, 5, 6, 6, 4, 5, 5,
+    5, 6, 6, 5, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 8, 7, 7, 13, 15, 13, 15, 12, 10, 10, 8, 12, 8, 11, 7,
+    7, 9, 9, 9, 9, 9, 10, 10, 8, 5, 5, 8, 7, 4, 5, 5,
+    4, 5, 5, 4, 5, 5, 5, 6, 6, 3, 4, 4, 3, 4, 4, 3,
+    4, 4, 5, 6, 6, 5, 6, 6, 5, 6, 6, 4, 5, 5, 4, 5,
+    5, 4, 5, 5, 3, 4, 4, 4, 5, 5, 5, 6, 6, 5, 6, 6,
+    5, 6, 6, 5, 6, 6, 3, 4, 4, 5, 6, 6, 5, 6, 6, 4,
+    5, 5, 4, 5, 5, 4, 5, 5, 6, 7, 7, 7, 8, 8, 4, 5,
+    5, 4, 5, 5, 5, 6, 6, 3, 4, 4, 4, 5, 5, 3, 4, 4,
+    4, 5, 5, 6, 7, 7, 6, 7, 7, 4, 5, 5, 5, 6, 6, 9,
+    10, 10, 4, 5, 5, 5, 6, 6, 6, 7, 7, 5, 6, 6, 6, 7,
+    7, 7, 8, 8, 5, 6, 6, 4, 5, 5, 9, 10, 10, 6, 7, 7,
+    8, 9, 9, 3, 4, 4, 9, 10, 10, 10, 11, 11, 4, 5, 5, 4,
+    5, 5, 4, 5, 5, 3, 4, 4, 9, 14, 6, 11, 13, 11, 6, 7,
+    6, 5, 8, 6, 7, 6, 11, 15, 19, 19, 19, 12, 21, 11, 20, 15,
+    24, 30, 39, 28, 37, 16, 25, 16, 25, 15, 24, 16, 25, 16, 25, 24,
+    33, 17, 26, 8, 6, 6, 7, 6, 6, 6, 5, 7, 6, 7, 7, 6,
+    6, 5, 8, 7, 6, 8, 7, 7, 6, 9, 8, 7, 5, 5, 5, 5,
+    4, 7, 4, 4, 7, 4, 6, 5, 6, 7, 5, 7, 5, 6, 8, 4,
+    6, 6, 4, 4, 4, 5, 6, 6, 7, 6, 7, 7, 8, 4, 5, 13,
+    6, 4, 6, 7, 5, 6, 13, 4, 5, 6, 10, 6, 7, 5, 3, 4,
+    5, 3, 4, 5, 5, 6, 6, 8, 8, 6, 7, 6, 7, 6, 7, 6,
+    6, 7, 7, 7, 6, 6, 7, 7, 7, 6, 6, 6, 6, 8, 6, 9,
+    13, 11, 8, 10, 13, 8, 11, 8, 8, 13, 11, 10, 11, 12, 11, 10,
+    9, 9, 10, 10, 10, 10, 7, 7, 5, 8, 6, 4, 12, 7, 5, 6,
+    9, 8, 8, 8, 8, 8, 8, 7, 8, 7, 9, 8, 9, 8, 8, 7,
+    7, 6, 6, 6, 6, 6, 5, 5, 8, 5, 8, 7, 6, 6, 7, 6,
+    7, 7, 8, 6, 7, 7, 8, 6, 7, 6, 7, 7, 7, 7, 6, 7,
+    7, 7, 6, 6, 6, 7, 6, 7, 8, 5, 5, 7, 6, 7, 7, 9,
+    9, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 9, 8, 6, 8,
+    8, 9, 7
+};
+
+static const unsigned int stdLibFunctionSeeds[256] = {
+    0, 0, 2, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 2,
+    1, 2, 0, 0, 0, 0, 1, 0, 8, 0, 1, 0, 0, 0, 2, 1,
+    0, 2, 0, 2, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 0,
+    1, 0, 0, 2, 2, 0, 0, 0, 2, 0, 0, 0, 0, 1, 1, 6,
+    2, 1, 0, 0, 0, 1, 0, 2, 0, 0, 0, 0, 0, 1, 0, 2,
+    2, 2, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 4, 0,
+    1, 0, 1, 3, 3, 2, 4, 1, 0, 0, 1, 0, 1, 10, 1, 0,
+    3, 1, 2, 1, 0, 2, 0, 3, 0, 0, 4, 0, 0, 0, 1, 2,
+    3, 0, 0, 0, 0, 2, 0, 6, 1, 0, 1, 1, 0, 2, 6, 1,
+    2, 0, 1, 0, 4, 4, 0, 2, 3, 1, 0, 0, 1, 0, 0, 0,
+    0, 5, 0, 4, 2, 4, 0, 5, 0, 4, 0, 0, 0, 0, 2, 2,
+    2, 0, 1, 0, 3, 1, 2, 0, 0, 1, 0, 0, 0, 0, 5, 3,
+    0, 1, 5, 0, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 5, 1, 8, 0, 2, 0,
+    0, 1, 1, 2, 0, 1, 12, 0, 0, 0, 3, 3, 0, 0, 0, 1,
+    0, 2, 6, 2, 0, 2, 0, 3, 0, 0, 0, 0, 2, 6, 0, 0
+};
+
+static const short stdLibFunctionSlots[1024] = {
+    -1, -1, -1, 173, -1, 114, 520, 217, 133, 209, 27, 38, -1, 387, 475, 501,
+    417, 276, -1, -1, -1, 456, -1, -1, 156, 96, 414, 68, 9, 463, 340, -1,
+    125, -1, -1, 123, 62, -1, 438, 72, -1, 348, 326, -1, 500, 490, 59, -1,
+    -1, -1, 469, 489, -1, 170, 413, 529, 290, -1, 184, -1, 196, -1, -1, 246,
+    -1, 98, 166, 100, -1, -1, -1, -1, -1, -1, -1, 403, 6, -1, -1, -1,
+    -1, 194, 392, -1, 153, 477, -1, 215, 389, -1, -1, 284, 320, -1, 505, 358,
+    -1, -1, 425, 532, 43, -1, -1, -1, 446, 318, 371, -1, 412, 108, -1, 159,
+    -1, 178, 278, -1, 190, 86, -1, -1, 461, 76, 357, -1, 207, -1, 25, 191,
+    -1, -1, -1, -1, -1, 192, -1, 41, 440, -1, -1, -1, 525, -1, 136, 349,
+    58, 168, -1, -1, 485, -1, 277, -1, 107, 102, 195, 46, -1, -1, -1, -1,
+    91, -1, -1, -1, 515, -1, -1, -1, -1, 395, -1, 330, 135, 127, 460, -1,
+    141, -1, -1, 478, 23, 377, -1, 94, -1, 248, 275, -1, 346, 302, 410, 90,
+    134, 271, 82, -1, -1, -1, 67, -1, 310, 163, 331, 396, 369, -1, -1, 482,
+    291, 538, 28, 35, -1, 270, 143, 343, -1, -1, -1, -1, -1, -1, 528, 512,
+    -1, 146, 394, 541, 436, -1, 345, -1, -1, 154, -1, -1, -1, -1, -1, -1,
+    488, 116, -1, -1, 405, -1, 300, -1, 129, -1, -1, 546, 137, 221, -1, 78,
+    351, 530, -1, 247, 4, 10, 145, -1, -1, 238, -1, 242, 30, 48, 462, 12,
+    378, -1, -1, -1, -1, 295, -1, 341, -1, -1, 229, 97, -1, -1, 280, 383,
+    -1, 304, -1, -1, 484, 452, 421, -1, -1, 470, 118, 422, 481, 236, 464, -1,
+    492, -1, -1, -1, -1, 179, -1, 260, -1, 437, -1, -1, -1, -1, -1, -1,
+    203, 363, -1, 70, -1, 479, -1, 338, 533, -1, 509, 494, -1, 474, -1, 256,
+    496, -1, 542, -1, -1, 459, 185, 445, -1, 198, 455, -1, 142, -1, -1, -1,
+    382, 155, 513, -1, -1, 22, 354, -1, 373, -1, -1, 380, 266, 15, 296, -1,
+    81, 3, -1, -1, -1, 375, 281, -1, -1, -1, 426, 26, -1, -1, -1, -1,
+    451, 187, 344, -1, -1, 443, -1, 210, -1, 252, 499, -1, -1, 128, 92, -1,
+    176, -1, -1, -1, 468, 113, 131, -1, -1, 216, 235, -1, 138, 447, 519, -1,
+    206, 157, 434, 231, -1, 502, -1, -1, 110, 374, -1, 37, 234, 466, 397, 384,
+    -1, -1, 398, 293, 323, 409, 473, -1, 385, 151, -1, -1, 16, -1, -1, -1,
+    -1, -1, -1, 325, -1, 294, 167, 265, -1, -1, 112, -1, 11, 544, 222, -1,
+    495, 226, -1, 186, -1, -1, 180, -1, -1, 442, 124, 524, 510, 423, 444, -1,
+    433, -1, 329, 441, 152, 69, 404, -1, -1, -1, -1, 327, -1, 243, -1, 193,
+    230, 368, 33, -1, 172, 393, -1, 391, -1, -1, 130, -1, -1, 183, 75, 521,
+    365, -1, -1, 105, -1, -1, -1, -1, 316, 53, 498, 402, -1, 74, 257, 381,
+    21, 298, 79, 13, 364, 150, 253, 225, 268, -1, -1, -1, 522, 89, 66, 164,
+    483, 88, -1, -1, -1, 208, 223, 241, 121, -1, 407, 360, -1, -1, -1, 527,
+    50, 366, -1, 261, 497, -1, -1, 388, -1, -1, -1, -1, -1, 175, 269, 111,
+    73, -1, 85, 201, 115, -1, -1, -1, 439, 428, -1, 244, -1, 545, -1, 317,
+    406, 262, 376, -1, 263, 504, 359, 106, 165, -1, -1, -1, -1, -1, -1, 454,
+    8, 333, 258, 356, -1, -1, 292, 448, -1, -1, -1, 119, -1, -1, -1, 540,
+    450, 224, 65, 400, 288, 283, -1, 286, 282, 486, -1, -1, 449, -1, 31, 334,
+    169, -1, -1, 214, 306, -1, -1, -1, -1, 148, -1, -1, 390, 309, -1, -1,
+    -1, -1, 491, 174, -1, 139, -1, 56, 355, 312, 480, -1, 52, -1, -1, -1,
+    228, -1, 285, 507, -1, -1, -1, -1, 200, 240, 19, -1, 328, 1, -1, -1,
+    149, 61, -1, -1, 233, 189, 287, 104, -1, 267, -1, -1, -1, -1, 536, 416,
+    182, -1, -1, 472, 54, -1, 213, -1, 202, 188, 47, -1, -1, -1, 132, -1,
+    -1, -1, -1, 493, 199, 308, -1, -1, 147, 255, 63, 301, -1, 273, 458, 218,
+    -1, 249, -1, -1, -1, 467, -1, 254, -1, -1, 420, -1, 120, 305, -1, 487,
+    274, -1, 322, 419, -1, -1, 429, 516, 408, -1, -1, -1, 171, -1, -1, 506,
+    219, -1, -1, 95, 39, 55, -1, -1, 347, 34, -1, 517, 401, 476, -1, -1,
+    -1, 539, -1, 335, 523, -1, 430, -1, -1, -1, 471, -1, -1, -1, 42, -1,
+    -1, 399, -1, 372, 518, -1, -1, 307, -1, -1, -1, 211, -1, 453, -1, -1,
+    508, -1, -1, -1, 259, -1, -1, 272, -1, 457, -1, 162, -1, -1, 415, 109,
+    83, 80, 336, 386, -1, 319, -1, 535, -1, 543, -1, -1, -1, -1, 60, -1,
+    77, -1, 204, -1, 177, -1, -1, 362, 352, -1, -1, 205, 303, 424, -1, -1,
+    297, 465, -1, -1, 158, -1, 279, 321, -1, -1, 531, -1, -1, 36, -1, 324,
+    -1, -1, -1, -1, -1, 313, 432, -1, -1, -1, 71, 160, 0, -1, -1, 84,
+    245, 20, 18, -1, 126, 418, -1, 537, 64, 299, -1, 264, 339, 101, 526, 534,
+    367, 117, -1, 350, 212, 227, 427, 332, 353, -1, 342, 140, -1, -1, 431, -1,
+    -1, -1, 144, -1, -1, -1, 379, -1, 2, 87, -1, -1, -1, -1, 103, -1,
+    -1, 370, -1, -1, 122, -1, 232, 197, -1, -1, 51, 17, -1, 5, -1, 99,
+    -1, -1, 251, 514, 57, -1, 435, 93, 29, 32, -1, 315, -1, -1, 14, 220,
+    -1, 161, -1, 361, -1, 239, -1, -1, -1, -1, -1, 237, 250, -1, 44, -1,
+    49, -1, 311, -1, -1, -1, 337, -1, 411, -1, -1, -1, -1, -1, 503, -1,
+    -1, 181, 314, 40, -1, -1, 24, 45, -1, 289, 511, -1, -1, -1, 7, -1
+};
+
+/**
+ * Returns the index in stdLibFunctionNames[] of a C11 standard library function or macro, or -1
+ */
+int lookupStdLibFunction(const char *text, int length) {
+    if (length <= 0 || length > 39) {
+        return -1;
+    }
+
+    unsigned int hash = dictionaryHash(text, length);
+    int index = stdLibFunctionSlots[dictionaryMix(hash ^ stdLibFunctionSeeds[hash & 255]) & 1023];
+    if (index < 0 || stdLibFunctionLengths[index] != length || memcmp(stdLibFunctionNames[index], text, length) != 0) {
+        return -1;
+    }
+    return index;
+}
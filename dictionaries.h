@@ -0,0 +1,15 @@
+/* Generated by gen_dictionaries.c - do not edit */
+#ifndef DICTIONARIES_H
+#define DICTIONARIES_H
+
+#define KEYWORD_COUNT 32
+#define STDLIB_FUNCTION_COUNT 547
+
+extern const char *const keywordNames[KEYWORD_COUNT];
+extern const char *const stdLibFunctionNames[STDLIB_FUNCTION_COUNT];
+
+// Function prototypes
+int lookupKeyword(const char *text, int length);
+int lookupStdLibFunction(const char *text, int length);
+
+#endif // DICTIONARIES_H
@@ -0,0 +1,224 @@
+#include <string.h>
+#include "format.h"
+
+// What a byte can be inside a specification
+enum {
+    CLASS_OTHER,
+    CLASS_FLAG,
+    CLASS_ZERO,
+    CLASS_DIGIT,
+    CLASS_STAR,
+    CLASS_DOT,
+    CLASS_LENGTH,
+    CLASS_CONVERSION,
+    CLASS_COUNT
+};
+
+// Where the parse of a specification stands; STATE_BAD is 0 so that every
+// transition a table leaves out rejects the byte
+enum {
+    STATE_BAD,
+    STATE_START,            // Right after '%', among the flags
+    STATE_SUPPRESSED,       // After scanf's '*'
+    STATE_WIDTH,
+    STATE_STAR_WIDTH,
+    STATE_DOT,
+    STATE_PRECISION,
+    STATE_STAR_PRECISION,
+    STATE_LENGTH,
+    STATE_DONE,
+    STATE_COUNT
+};
+
+#define DIGITS(class) \
+    ['1'] = class, ['2'] = class, ['3'] = class, ['4'] = class, ['5'] = class, \
+    ['6'] = class, ['7'] = class, ['8'] = class, ['9'] = class
+#define CONVERSIONS \
+    ['d'] = CLASS_CONVERSION, ['i'] = CLASS_CONVERSION, ['u'] = CLASS_CONVERSION, ['o'] = CLASS_CONVERSION, \
+    ['x'] = CLASS_CONVERSION, ['X'] = CLASS_CONVERSION, ['f'] = CLASS_CONVERSION, ['F'] = CLASS_CONVERSION, \
+    ['e'] = CLASS_CONVERSION, ['E'] = CLASS_CONVERSION, ['g'] = CLASS_CONVERSION, ['G'] = CLASS_CONVERSION, \
+    ['a'] = CLASS_CONVERSION, ['A'] = CLASS_CONVERSION, ['c'] = CLASS_CONVERSION, ['s'] = CLASS_CONVERSION, \
+    ['p'] = CLASS_CONVERSION, ['n'] = CLASS_CONVERSION
+#define LENGTHS \
+    ['h'] = CLASS_LENGTH, ['l'] = CLASS_LENGTH, ['j'] = CLASS_LENGTH, ['z'] = CLASS_LENGTH, \
+    ['t'] = CLASS_LENGTH, ['L'] = CLASS_LENGTH
+
+// Class of each byte, by flavor: scanf has no flags or precision, but has '[' sets
+static const unsigned char byteClasses[2][256] = {
+    [FORMAT_PRINTF] = {
+        ['-'] = CLASS_FLAG, ['+'] = CLASS_FLAG, [' '] = CLASS_FLAG, ['#'] = CLASS_FLAG,
+        ['0'] = CLASS_ZERO, DIGITS(CLASS_DIGIT), ['*'] = CLASS_STAR, ['.'] = CLASS_DOT,
+        LENGTHS, CONVERSIONS
+    },
+    [FORMAT_SCANF] = {
+        ['0'] = CLASS_ZERO, DIGITS(CLASS_DIGIT), ['*'] = CLASS_STAR,
+        LENGTHS, CONVERSIONS, ['['] = CLASS_CONVERSION
+    }
+};
+
+// The state after each class of byte in each state, by flavor. A length
+// modifier may follow another only to double it (hh, ll), which is checked
+// apart.
+static const unsigned char transitions[2][STATE_COUNT][CLASS_COUNT] = {
+    [FORMAT_PRINTF] = {
+        [STATE_START] = {[CLASS_FLAG] = STATE_START, [CLASS_ZERO] = STATE_START, [CLASS_DIGIT] = STATE_WIDTH,
+                         [CLASS_STAR] = STATE_STAR_WIDTH, [CLASS_DOT] = STATE_DOT,
+                         [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_WIDTH] = {[CLASS_ZERO] = STATE_WIDTH, [CLASS_DIGIT] = STATE_WIDTH, [CLASS_DOT] = STATE_DOT,
+                         [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_STAR_WIDTH] = {[CLASS_DOT] = STATE_DOT, [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_DOT] = {[CLASS_ZERO] = STATE_PRECISION, [CLASS_DIGIT] = STATE_PRECISION, [CLASS_STAR] = STATE_STAR_PRECISION,
+                       [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_PRECISION] = {[CLASS_ZERO] = STATE_PRECISION, [CLASS_DIGIT] = STATE_PRECISION,
+                             [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_STAR_PRECISION] = {[CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_LENGTH] = {[CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE}
+    },
+    [FORMAT_SCANF] = {
+        [STATE_START] = {[CLASS_STAR] = STATE_SUPPRESSED, [CLASS_ZERO] = STATE_WIDTH, [CLASS_DIGIT] = STATE_WIDTH,
+                         [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_SUPPRESSED] = {[CLASS_ZERO] = STATE_WIDTH, [CLASS_DIGIT] = STATE_WIDTH,
+                              [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_WIDTH] = {[CLASS_ZERO] = STATE_WIDTH, [CLASS_DIGIT] = STATE_WIDTH,
+                         [CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE},
+        [STATE_LENGTH] = {[CLASS_LENGTH] = STATE_LENGTH, [CLASS_CONVERSION] = STATE_DONE}
+    }
+};
+
+// Flag bit of each printf flag byte
+static const unsigned char flagBits[256] = {
+    ['-'] = FORMAT_FLAG_MINUS, ['+'] = FORMAT_FLAG_PLUS, [' '] = FORMAT_FLAG_SPACE,
+    ['#'] = FORMAT_FLAG_HASH, ['0'] = FORMAT_FLAG_ZERO
+};
+
+// Modifier of each length byte, and of the byte doubled
+static const unsigned char lengthModifiers[256] = {
+    ['h'] = FORMAT_LENGTH_H, ['l'] = FORMAT_LENGTH_L, ['j'] = FORMAT_LENGTH_J,
+    ['z'] = FORMAT_LENGTH_Z, ['t'] = FORMAT_LENGTH_T, ['L'] = FORMAT_LENGTH_LONG_DOUBLE
+};
+static const unsigned char doubledModifiers[256] = {
+    ['h'] = FORMAT_LENGTH_HH, ['l'] = FORMAT_LENGTH_LL
+};
+
+// Parse the specification whose '%' is at text[start], filling in spec;
+// returns where the text after it begins
+static int parseSpec(FormatFlavor flavor, const char *text, int length, int start, FormatSpec *spec) {
+    int state = STATE_START;
+    int i = start + 1;
+
+    memset(spec, 0, sizeof(*spec));
+    spec->offset = (unsigned int)start;
+    for (; i < length; i++) {
+        unsigned char byte = (unsigned char)text[i];
+        int byteClass = byteClasses[flavor][byte];
+        int next = transitions[flavor][state][byteClass];
+
+        if (state == STATE_LENGTH && next == STATE_LENGTH &&
+            (spec->length != lengthModifiers[byte] || doubledModifiers[byte] == 0)) {
+            next = STATE_BAD;
+        }
+        if (next == STATE_BAD) {
+            spec->bad = byte;
+            return i + 1;
+        }
+
+        switch (byteClass) {
+            case CLASS_FLAG:
+            case CLASS_ZERO:
+                if (state == STATE_START) {
+                    spec->flags |= flagBits[byte];
+                }
+                break;
+            case CLASS_STAR:
+                spec->flags |= state == STATE_DOT ? FORMAT_STAR_PRECISION
+                             : flavor == FORMAT_SCANF ? FORMAT_SUPPRESSED : FORMAT_STAR_WIDTH;
+                break;
+            case CLASS_LENGTH:
+                spec->length = state == STATE_LENGTH ? doubledModifiers[byte] : lengthModifiers[byte];
+                break;
+        }
+        state = next;
+
+        if (state == STATE_DONE) {
+            if (byte != '[') {
+                spec->conversion = byte;
+                return i + 1;
+            }
+            // A scanset runs to the next ']', which it may itself start with
+            int j = i + 1;
+            if (j < length && text[j] == '^') {
+                j++;
+            }
+            if (j < length && text[j] == ']') {
+                j++;
+            }
+            while (j < length && text[j] != ']') {
+                j++;
+            }
+            if (j == length) {
+                return length;
+            }
+            spec->conversion = byte;
+            return j + 1;
+        }
+    }
+    return length;
+}
+
+// Parse a format string, without its quotes, into its specifications,
+// which are allocated from the arena
+void formatParse(FormatFlavor flavor, const char *text, int length, Arena *arena, FormatString *format) {
+    FormatSpec *specs;
+    int count = 0, percents = 0;
+
+    // Each specification starts with a '%', which bounds their number
+    for (const char *p = text; (p = memchr(p, '%', length - (p - text))) != NULL; p++) {
+        percents++;
+    }
+    specs = percents ? arenaAlloc(arena, (size_t)percents * sizeof(FormatSpec)) : NULL;
+
+    format->argumentCount = 0;
+    for (int i = 0; i < length; ) {
+        const char *percent = memchr(text + i, '%', length - i);
+        if (percent == NULL) {
+            break;
+        }
+
+        i = (int)(percent - text);
+        if (i + 1 < length && text[i + 1] == '%') {
+            i += 2;
+            continue;
+        }
+
+        i = parseSpec(flavor, text, length, i, &specs[count]);
+
+        unsigned char flags = specs[count].flags;
+        format->argumentCount += !(flags & FORMAT_SUPPRESSED) + !!(flags & FORMAT_STAR_WIDTH) +
+                                 !!(flags & FORMAT_STAR_PRECISION);
+        count++;
+    }
+    format->specs = specs;
+    format->count = count;
+}
+
+// Start a cache holding no literals
+void formatCacheInit(FormatCache *cache, Arena *arena, FormatFlavor flavor) {
+    cache->arena = arena;
+    cache->flavor = flavor;
+    cache->formats = NULL;
+    cache->capacity = 0;
+    internInit(&cache->literals, arena, 0);
+}
+
+// The parse of a format string, without its quotes: parsed the first time
+// the literal is seen, looked up after that
+const FormatString *formatCompile(FormatCache *cache, const char *text, int length) {
+    int id = internFind(&cache->literals, text, length);
+
+    if (id < 0) {
+        id = internName(&cache->literals, arenaStrndup(cache->arena, text, (size_t)length), length);
+        cache->formats = arenaGrowArray(cache->arena, cache->formats, id, &cache->capacity, sizeof(FormatString));
+        formatParse(cache->flavor, text, length, cache->arena, &cache->formats[id]);
+    }
+    return &cache->formats[id];
+}
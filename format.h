@@ -0,0 +1,69 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include "arena.h"
+#include "intern.h"
+
+// Which function's grammar a format string follows
+typedef enum {
+    FORMAT_PRINTF,
+    FORMAT_SCANF
+} FormatFlavor;
+
+// Length modifiers
+enum {
+    FORMAT_LENGTH_NONE,
+    FORMAT_LENGTH_HH,
+    FORMAT_LENGTH_H,
+    FORMAT_LENGTH_L,
+    FORMAT_LENGTH_LL,
+    FORMAT_LENGTH_J,
+    FORMAT_LENGTH_Z,
+    FORMAT_LENGTH_T,
+    FORMAT_LENGTH_LONG_DOUBLE   // L
+};
+
+// Bits of FormatSpec.flags
+#define FORMAT_FLAG_MINUS       0x01
+#define FORMAT_FLAG_PLUS        0x02
+#define FORMAT_FLAG_SPACE       0x04
+#define FORMAT_FLAG_HASH        0x08
+#define FORMAT_FLAG_ZERO        0x10
+#define FORMAT_STAR_WIDTH       0x20    // Width '*': takes an int argument (printf)
+#define FORMAT_STAR_PRECISION   0x40    // Precision '.*': takes an int argument (printf)
+#define FORMAT_SUPPRESSED       0x80    // '%*': converted but not assigned (scanf)
+
+// One conversion specification, from its '%' to its conversion byte. %% is
+// text, not a specification.
+typedef struct {
+    unsigned int offset;        // Where the '%' is in the literal
+    unsigned char conversion;   // 'd', 's', '[' and so on; 0 when invalid
+    unsigned char bad;          // When invalid, the byte that does not fit, 0 if the literal ends first
+    unsigned char length;       // FORMAT_LENGTH_*
+    unsigned char flags;        // FORMAT_FLAG_*, FORMAT_STAR_* and FORMAT_SUPPRESSED bits
+} FormatSpec;
+
+// A parsed format string. Every specification, valid or not, stands for one
+// argument unless suppressed, and each '*' for one more before it.
+typedef struct {
+    const FormatSpec *specs;
+    int count;                  // Specifications in specs
+    int argumentCount;          // Arguments the string asks for
+} FormatString;
+
+// Parsed format strings by their text, so each distinct literal is parsed
+// once. The cache keeps its own copy of every literal.
+typedef struct {
+    Arena *arena;               // Where the cache lives
+    FormatFlavor flavor;
+    InternTable literals;       // Literal text to literal ID
+    FormatString *formats;      // formats[id]: the literal's parse
+    int capacity;               // Room in formats
+} FormatCache;
+
+// Function prototypes
+void formatCacheInit(FormatCache *cache, Arena *arena, FormatFlavor flavor);
+const FormatString *formatCompile(FormatCache *cache, const char *text, int length);
+void formatParse(FormatFlavor flavor, const char *text, int length, Arena *arena, FormatString *format);
+
+#endif // FORMAT_H
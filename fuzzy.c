@@ -0,0 +1,145 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#include "fuzzy.h"
+
+#define FUZZY_MAX_LENGTH 64     // Longest name edit distances are computed for, one bit per byte
+
+// Lower-case form of a byte
+static unsigned char fold(char c) {
+    return (unsigned char)tolower((unsigned char)c);
+}
+
+// FNV-1a over the folded bytes
+static unsigned int foldedHash(const char *text, int length) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ fold(text[i])) * 16777619u;
+    }
+    return hash;
+}
+
+// Check whether two texts of the same length are equal ignoring case
+static bool foldedEqual(const char *a, const char *b, int length) {
+    for (int i = 0; i < length; i++) {
+        if (fold(a[i]) != fold(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Build the folded index over the words
+void fuzzyInit(FuzzyDictionary *dictionary, Arena *arena, const char *const *words, int count) {
+    int slotCount = 16;
+    while (slotCount < count * 2) {
+        slotCount *= 2;
+    }
+
+    dictionary->words = words;
+    dictionary->count = count;
+    dictionary->lengths = arenaAlloc(arena, ((size_t)count + 1) * sizeof(int));
+    dictionary->slots = arenaAlloc(arena, (size_t)slotCount * sizeof(int));
+    memset(dictionary->slots, 0, (size_t)slotCount * sizeof(int));
+    dictionary->slotCount = slotCount;
+
+    unsigned int mask = (unsigned int)slotCount - 1;
+    for (int w = 0; w < count; w++) {
+        dictionary->lengths[w] = (int)strlen(words[w]);
+
+        unsigned int slot = foldedHash(words[w], dictionary->lengths[w]) & mask;
+        while (dictionary->slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        dictionary->slots[slot] = w + 1;
+    }
+}
+
+// Look the name up ignoring case, preferring a word that matches it exactly
+static FuzzyMatch foldedLookup(const FuzzyDictionary *dictionary, const char *text, int length) {
+    FuzzyMatch match = {-1, 0, false};
+    unsigned int mask = (unsigned int)dictionary->slotCount - 1;
+    unsigned int slot = foldedHash(text, length) & mask;
+
+    for (; dictionary->slots[slot] != 0; slot = (slot + 1) & mask) {
+        int w = dictionary->slots[slot] - 1;
+        if (dictionary->lengths[w] != length || !foldedEqual(dictionary->words[w], text, length)) {
+            continue;
+        }
+        if (memcmp(dictionary->words[w], text, length) == 0) {
+            match.word = w;
+            match.exact = true;
+            return match;
+        }
+        if (match.word < 0 || w < match.word) {
+            match.word = w;
+        }
+    }
+    return match;
+}
+
+// Edit distance between the name whose match masks are in equal[] and a
+// word, by Myers' algorithm: column j of the dynamic programming table is
+// kept as bit vectors of its +1 and -1 vertical steps. Stops early once
+// the distance must exceed maxDistance, returning maxDistance + 1.
+static int editDistance(const uint64_t *equal, int length, const char *word, int wordLength, int maxDistance) {
+    uint64_t positive = length == FUZZY_MAX_LENGTH ? ~(uint64_t)0 : ((uint64_t)1 << length) - 1;
+    uint64_t negative = 0;
+    uint64_t last = (uint64_t)1 << (length - 1);
+    int score = length;
+
+    for (int j = 0; j < wordLength; j++) {
+        uint64_t eq = equal[fold(word[j])];
+        uint64_t xv = eq | negative;
+        uint64_t xh = (((eq & positive) + positive) ^ positive) | eq;
+        uint64_t horizontalPositive = negative | ~(xh | positive);
+        uint64_t horizontalNegative = positive & xh;
+
+        if (horizontalPositive & last) {
+            score++;
+        } else if (horizontalNegative & last) {
+            score--;
+        }
+        // Each remaining byte of the word can lower the score by at most one
+        if (score - (wordLength - j - 1) > maxDistance) {
+            return maxDistance + 1;
+        }
+
+        // Row 0 grows by one per column, so a +1 step enters at the bottom
+        horizontalPositive = (horizontalPositive << 1) | 1;
+        horizontalNegative <<= 1;
+        positive = horizontalNegative | ~(xv | horizontalPositive);
+        negative = horizontalPositive & xv;
+    }
+    return score;
+}
+
+// Find the word closest to a name, ignoring case, within maxDistance edits
+// (insertions, deletions, substitutions); ties go to the earlier word
+FuzzyMatch fuzzyMatch(const FuzzyDictionary *dictionary, const char *text, int length, int maxDistance) {
+    FuzzyMatch match = foldedLookup(dictionary, text, length);
+    if (match.word >= 0 || maxDistance <= 0 || length == 0 || length > FUZZY_MAX_LENGTH) {
+        return match;
+    }
+
+    uint64_t equal[256] = {0};
+    for (int i = 0; i < length; i++) {
+        equal[fold(text[i])] |= (uint64_t)1 << i;
+    }
+
+    int best = maxDistance + 1;
+    for (int w = 0; w < dictionary->count; w++) {
+        int wordLength = dictionary->lengths[w];
+        if (wordLength - length >= best || length - wordLength >= best) {
+            continue;
+        }
+
+        int distance = editDistance(equal, length, dictionary->words[w], wordLength, best - 1);
+        if (distance < best) {
+            best = distance;
+            match.word = w;
+            match.distance = distance;
+        }
+    }
+    return match;
+}
@@ -0,0 +1,29 @@
+#ifndef FUZZY_H
+#define FUZZY_H
+
+#include <stdbool.h>
+#include "arena.h"
+
+// A fixed list of words (keywords, library names, headers) to match names
+// against, ignoring case: an exact lookup through a hash of the folded
+// words, then Myers' bit-parallel edit distance, one 64-bit word per name.
+typedef struct {
+    const char *const *words;   // The words, as given; they must outlive the dictionary
+    int count;
+    int *lengths;               // lengths[w]: length of words[w]
+    int *slots;                 // Open-addressing index of the folded words: w + 1, or 0 when empty
+    int slotCount;              // Always a power of two
+} FuzzyDictionary;
+
+// The word closest to a name
+typedef struct {
+    int word;       // Index of the closest word, -1 if none is within the distance asked for
+    int distance;   // Edit distance between the name and the word, ignoring case
+    bool exact;     // The name is the word itself, case included
+} FuzzyMatch;
+
+// Function prototypes
+void fuzzyInit(FuzzyDictionary *dictionary, Arena *arena, const char *const *words, int count);
+FuzzyMatch fuzzyMatch(const FuzzyDictionary *dictionary, const char *text, int length, int maxDistance);
+
+#endif // FUZZY_H
@@ -0,0 +1,393 @@
+/* Generates dictionaries.c and dictionaries.h: collision-free (perfect)
+ * hash tables for the C keywords and the C11 standard library names.
+ *
+ *     gcc -O2 -o gen_dictionaries gen_dictionaries.c
+ *     ./gen_dictionaries            (writes both files to the current directory)
+ *
+ * Rerun it after editing a word list below. The tables use hash and
+ * displace: a key's 32-bit FNV-1a hash picks a bucket, the bucket's seed is
+ * mixed into the hash, and the result picks a slot. Seeds are searched here
+ * so that no two keys share a slot; a lookup is then one hash, two table
+ * reads and one string comparison.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SEED 1000000    // Give up on a bucket after this many seeds
+
+/* C keywords, in the order the checkers number them */
+static const char *keywordList[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do",
+    "double", "else", "enum", "extern", "float", "for", "goto", "if",
+    "int", "long", "register", "return", "short", "signed", "sizeof", "static",
+    "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while"
+};
+
+/* C11 standard library functions and function-like macros, by header */
+static const char *stdLibList[] = {
+    /* assert.h */
+    "assert",
+    /* complex.h */
+    "cabs", "cabsf", "cabsl", "cacos", "cacosf", "cacosl", "cacosh", "cacoshf", "cacoshl",
+    "carg", "cargf", "cargl", "casin", "casinf", "casinl", "casinh", "casinhf", "casinhl",
+    "catan", "catanf", "catanl", "catanh", "catanhf", "catanhl", "ccos", "ccosf", "ccosl",
+    "ccosh", "ccoshf", "ccoshl", "cexp", "cexpf", "cexpl", "cimag", "cimagf", "cimagl",
+    "clog", "clogf", "clogl", "conj", "conjf", "conjl", "cpow", "cpowf", "cpowl",
+    "cproj", "cprojf", "cprojl", "creal", "crealf", "creall", "csin", "csinf", "csinl",
+    "csinh", "csinhf", "csinhl", "csqrt", "csqrtf", "csqrtl", "ctan", "ctanf", "ctanl",
+    "ctanh", "ctanhf", "ctanhl", "CMPLX", "CMPLXF", "CMPLXL",
+    /* ctype.h */
+    "isalnum", "isalpha", "isblank", "iscntrl", "isdigit", "isgraph", "islower", "isprint",
+    "ispunct", "isspace", "isupper", "isxdigit", "tolower", "toupper",
+    /* fenv.h */
+    "feclearexcept", "fegetexceptflag", "feraiseexcept", "fesetexceptflag", "fetestexcept",
+    "fegetround", "fesetround", "fegetenv", "feholdexcept", "fesetenv", "feupdateenv",
+    /* inttypes.h */
+    "imaxabs", "imaxdiv", "strtoimax", "strtoumax", "wcstoimax", "wcstoumax",
+    /* locale.h */
+    "setlocale", "localeconv",
+    /* math.h */
+    "fpclassify", "isfinite", "isinf", "isnan", "isnormal", "signbit",
+    "acos", "acosf", "acosl", "asin", "asinf", "asinl", "atan", "atanf", "atanl",
+    "atan2", "atan2f", "atan2l", "cos", "cosf", "cosl", "sin", "sinf", "sinl",
+    "tan", "tanf", "tanl", "acosh", "acoshf", "acoshl", "asinh", "asinhf", "asinhl",
+    "atanh", "atanhf", "atanhl", "cosh", "coshf", "coshl", "sinh", "sinhf", "sinhl",
+    "tanh", "tanhf", "tanhl", "exp", "expf", "expl", "exp2", "exp2f", "exp2l",
+    "expm1", "expm1f", "expm1l", "frexp", "frexpf", "frexpl", "ilogb", "ilogbf", "ilogbl",
+    "ldexp", "ldexpf", "ldexpl", "log", "logf", "logl", "log10", "log10f", "log10l",
+    "log1p", "log1pf", "log1pl", "log2", "log2f", "log2l", "logb", "logbf", "logbl",
+    "modf", "modff", "modfl", "scalbn", "scalbnf", "scalbnl", "scalbln", "scalblnf", "scalblnl",
+    "cbrt", "cbrtf", "cbrtl", "fabs", "fabsf", "fabsl", "hypot", "hypotf", "hypotl",
+    "pow", "powf", "powl", "sqrt", "sqrtf", "sqrtl", "erf", "erff", "erfl",
+    "erfc", "erfcf", "erfcl", "lgamma", "lgammaf", "lgammal", "tgamma", "tgammaf", "tgammal",
+    "ceil", "ceilf", "ceill", "floor", "floorf", "floorl", "nearbyint", "nearbyintf", "nearbyintl",
+    "rint", "rintf", "rintl", "lrint", "lrintf", "lrintl", "llrint", "llrintf", "llrintl",
+    "round", "roundf", "roundl", "lround", "lroundf", "lroundl", "llround", "llroundf", "llroundl",
+    "trunc", "truncf", "truncl", "fmod", "fmodf", "fmodl", "remainder", "remainderf", "remainderl",
+    "remquo", "remquof", "remquol", "copysign", "copysignf", "copysignl", "nan", "nanf", "nanl",
+    "nextafter", "nextafterf", "nextafterl", "nexttoward", "nexttowardf", "nexttowardl",
+    "fdim", "fdimf", "fdiml", "fmax", "fmaxf", "fmaxl", "fmin", "fminf", "fminl",
+    "fma", "fmaf", "fmal", "isgreater", "isgreaterequal", "isless", "islessequal",
+    "islessgreater", "isunordered",
+    /* setjmp.h */
+    "setjmp", "longjmp",
+    /* signal.h */
+    "signal", "raise",
+    /* stdarg.h */
+    "va_start", "va_arg", "va_copy", "va_end",
+    /* stdatomic.h */
+    "atomic_init", "kill_dependency", "atomic_thread_fence", "atomic_signal_fence",
+    "atomic_is_lock_free", "atomic_store", "atomic_store_explicit", "atomic_load",
+    "atomic_load_explicit", "atomic_exchange", "atomic_exchange_explicit",
+    "atomic_compare_exchange_strong", "atomic_compare_exchange_strong_explicit",
+    "atomic_compare_exchange_weak", "atomic_compare_exchange_weak_explicit",
+    "atomic_fetch_add", "atomic_fetch_add_explicit", "atomic_fetch_sub", "atomic_fetch_sub_explicit",
+    "atomic_fetch_or", "atomic_fetch_or_explicit", "atomic_fetch_xor", "atomic_fetch_xor_explicit",
+    "atomic_fetch_and", "atomic_fetch_and_explicit", "atomic_flag_test_and_set",
+    "atomic_flag_test_and_set_explicit", "atomic_flag_clear", "atomic_flag_clear_explicit",
+    /* stddef.h */
+    "offsetof",
+    /* stdio.h (gets was removed in C11 but is kept so its use is still recognised) */
+    "remove", "rename", "tmpfile", "tmpnam", "fclose", "fflush", "fopen", "freopen",
+    "setbuf", "setvbuf", "fprintf", "fscanf", "printf", "scanf", "snprintf", "sprintf",
+    "sscanf", "vfprintf", "vfscanf", "vprintf", "vscanf", "vsnprintf", "vsprintf", "vsscanf",
+    "fgetc", "fgets", "fputc", "fputs", "getc", "getchar", "gets", "putc", "putchar", "puts",
+    "ungetc", "fread", "fwrite", "fgetpos", "fseek", "fsetpos", "ftell", "rewind",
+    "clearerr", "feof", "ferror", "perror",
+    /* stdlib.h */
+    "atof", "atoi", "atol", "atoll", "strtod", "strtof", "strtold", "strtol", "strtoll",
+    "strtoul", "strtoull", "rand", "srand", "aligned_alloc", "calloc", "free", "malloc",
+    "realloc", "abort", "atexit", "at_quick_exit", "exit", "_Exit", "getenv", "quick_exit",
+    "system", "bsearch", "qsort", "abs", "labs", "llabs", "div", "ldiv", "lldiv",
+    "mblen", "mbtowc", "wctomb", "mbstowcs", "wcstombs",
+    /* string.h */
+    "memcpy", "memmove", "strcpy", "strncpy", "strcat", "strncat", "memcmp", "strcmp",
+    "strcoll", "strncmp", "strxfrm", "memchr", "strchr", "strcspn", "strpbrk", "strrchr",
+    "strspn", "strstr", "strtok", "memset", "strerror", "strlen",
+    /* threads.h */
+    "call_once", "cnd_broadcast", "cnd_destroy", "cnd_init", "cnd_signal", "cnd_timedwait",
+    "cnd_wait", "mtx_destroy", "mtx_init", "mtx_lock", "mtx_timedlock", "mtx_trylock",
+    "mtx_unlock", "thrd_create", "thrd_current", "thrd_detach", "thrd_equal", "thrd_exit",
+    "thrd_join", "thrd_sleep", "thrd_yield", "tss_create", "tss_delete", "tss_get", "tss_set",
+    /* time.h */
+    "clock", "difftime", "mktime", "time", "timespec_get", "asctime", "ctime", "gmtime",
+    "localtime", "strftime",
+    /* uchar.h */
+    "mbrtoc16", "c16rtomb", "mbrtoc32", "c32rtomb",
+    /* wchar.h */
+    "fwprintf", "fwscanf", "swprintf", "swscanf", "vfwprintf", "vfwscanf", "vswprintf",
+    "vswscanf", "vwprintf", "vwscanf", "wprintf", "wscanf", "fgetwc", "fgetws", "fputwc",
+    "fputws", "fwide", "getwc", "getwchar", "putwc", "putwchar", "ungetwc", "wcstod",
+    "wcstof", "wcstold", "wcstol", "wcstoll", "wcstoul", "wcstoull", "wcscpy", "wcsncpy",
+    "wmemcpy", "wmemmove", "wcscat", "wcsncat", "wcscmp", "wcscoll", "wcsncmp", "wcsxfrm",
+    "wmemcmp", "wcschr", "wcscspn", "wcspbrk", "wcsrchr", "wcsspn", "wcsstr", "wcstok",
+    "wmemchr", "wcslen", "wmemset", "wcsftime", "btowc", "wctob", "mbsinit", "mbrlen",
+    "mbrtowc", "wcrtomb", "mbsrtowcs", "wcsrtombs",
+    /* wctype.h */
+    "iswalnum", "iswalpha", "iswblank", "iswcntrl", "iswdigit", "iswgraph", "iswlower",
+    "iswprint", "iswpunct", "iswspace", "iswupper", "iswxdigit", "iswctype", "wctype",
+    "towlower", "towupper", "towctrans", "wctrans"
+};
+
+/* A dictionary to generate */
+typedef struct {
+    const char *name;           // Prefix of every generated identifier (e.g. "keyword")
+    const char *macroName;      // Prefix of the generated macros (e.g. "KEYWORD")
+    const char *function;       // Name of the lookup function
+    const char *description;    // What the lookup classifies, for its comment
+    const char **words;
+    int wordCount;
+    int bucketCount;            // Powers of two
+    int slotCount;
+    unsigned int *seeds;        // Per bucket
+    int *slots;                 // Word index per slot, -1 if empty
+    int maxLength;
+} Dictionary;
+
+/* The hash functions below are emitted verbatim into dictionaries.c */
+static const char *hashSource =
+    "static unsigned int dictionaryHash(const char *text, int length) {\n"
+    "    unsigned int hash = 2166136261u;\n"
+    "    for (int i = 0; i < length; i++) {\n"
+    "        hash = (hash ^ (unsigned char)text[i]) * 16777619u;\n"
+    "    }\n"
+    "    return hash;\n"
+    "}\n"
+    "\n"
+    "static unsigned int dictionaryMix(unsigned int hash) {\n"
+    "    hash ^= hash >> 16;\n"
+    "    hash *= 0x85ebca6bu;\n"
+    "    hash ^= hash >> 13;\n"
+    "    hash *= 0xc2b2ae35u;\n"
+    "    return hash ^ (hash >> 16);\n"
+    "}\n";
+
+static unsigned int dictionaryHash(const char *text, int length) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static unsigned int dictionaryMix(unsigned int hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    return hash ^ (hash >> 16);
+}
+
+static int nextPowerOfTwo(int n) {
+    int power = 1;
+    while (power < n) {
+        power *= 2;
+    }
+    return power;
+}
+
+static void *checkedCalloc(size_t count, size_t size) {
+    void *memory = calloc(count, size);
+    if (!memory) {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+    return memory;
+}
+
+/**
+ * Searches a seed for every bucket, largest bucket first, so that all keys
+ * land in distinct slots
+ */
+static void buildDictionary(Dictionary *dictionary) {
+    int n = dictionary->wordCount;
+    unsigned int *hashes = checkedCalloc(n, sizeof(unsigned int));
+    int *bucketOf = checkedCalloc(n, sizeof(int));
+
+    dictionary->bucketCount = nextPowerOfTwo(n / 4 + 1);
+    dictionary->slotCount = nextPowerOfTwo(n + n / 4);
+    dictionary->seeds = checkedCalloc(dictionary->bucketCount, sizeof(unsigned int));
+    dictionary->slots = checkedCalloc(dictionary->slotCount, sizeof(int));
+    dictionary->maxLength = 0;
+
+    for (int i = 0; i < dictionary->slotCount; i++) {
+        dictionary->slots[i] = -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int length = (int)strlen(dictionary->words[i]);
+        hashes[i] = dictionaryHash(dictionary->words[i], length);
+        bucketOf[i] = hashes[i] & (dictionary->bucketCount - 1);
+        if (length > dictionary->maxLength) {
+            dictionary->maxLength = length;
+        }
+        for (int j = 0; j < i; j++) {
+            if (strcmp(dictionary->words[i], dictionary->words[j]) == 0) {
+                printf("Error: '%s' is listed twice in the %s dictionary\n", dictionary->words[i], dictionary->name);
+                exit(1);
+            }
+            if (hashes[i] == hashes[j]) {
+                printf("Error: '%s' and '%s' have the same hash\n", dictionary->words[i], dictionary->words[j]);
+                exit(1);
+            }
+        }
+    }
+
+    // Order buckets by decreasing size
+    int *bucketSizes = checkedCalloc(dictionary->bucketCount, sizeof(int));
+    int *order = checkedCalloc(dictionary->bucketCount, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        bucketSizes[bucketOf[i]]++;
+    }
+    for (int i = 0; i < dictionary->bucketCount; i++) {
+        order[i] = i;
+    }
+    for (int i = 1; i < dictionary->bucketCount; i++) {
+        for (int j = i; j > 0 && bucketSizes[order[j]] > bucketSizes[order[j - 1]]; j--) {
+            int swap = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+    }
+
+    int *placed = checkedCalloc(n, sizeof(int));
+    for (int b = 0; b < dictionary->bucketCount && bucketSizes[order[b]] > 0; b++) {
+        int bucket = order[b];
+        unsigned int seed;
+
+        for (seed = 0; seed < MAX_SEED; seed++) {
+            int placedCount = 0;
+            int fits = 1;
+
+            for (int i = 0; i < n && fits; i++) {
+                if (bucketOf[i] != bucket) {
+                    continue;
+                }
+                int slot = dictionaryMix(hashes[i] ^ seed) & (dictionary->slotCount - 1);
+                if (dictionary->slots[slot] >= 0) {
+                    fits = 0;
+                    break;
+                }
+                dictionary->slots[slot] = i;
+                placed[placedCount++] = slot;
+            }
+
+            if (fits) {
+                break;
+            }
+            // Undo the partial placement and try the next seed
+            for (int i = 0; i < placedCount; i++) {
+                dictionary->slots[placed[i]] = -1;
+            }
+        }
+
+        if (seed == MAX_SEED) {
+            printf("Error: No seed found for a bucket of the %s dictionary\n", dictionary->name);
+            exit(1);
+        }
+        dictionary->seeds[bucket] = seed;
+    }
+
+    free(placed);
+    free(order);
+    free(bucketSizes);
+    free(bucketOf);
+    free(hashes);
+}
+
+static void writeHeader(FILE *out, Dictionary *dictionaries, int count) {
+    fprintf(out, "/* Generated by gen_dictionaries.c - do not edit */\n");
+    fprintf(out, "#ifndef DICTIONARIES_H\n#define DICTIONARIES_H\n\n");
+    for (int d = 0; d < count; d++) {
+        fprintf(out, "#define %s_COUNT %d\n", dictionaries[d].macroName, dictionaries[d].wordCount);
+    }
+    fprintf(out, "\n");
+    for (int d = 0; d < count; d++) {
+        fprintf(out, "extern const char *const %sNames[%s_COUNT];\n", dictionaries[d].name, dictionaries[d].macroName);
+    }
+    fprintf(out, "\n// Function prototypes\n");
+    for (int d = 0; d < count; d++) {
+        fprintf(out, "int %s(const char *text, int length);\n", dictionaries[d].function);
+    }
+    fprintf(out, "\n#endif // DICTIONARIES_H\n");
+}
+
+static void writeSource(FILE *out, Dictionary *dictionaries, int count) {
+    fprintf(out, "/* Generated by gen_dictionaries.c - do not edit */\n");
+    fprintf(out, "#include <string.h>\n#include \"dictionaries.h\"\n\n");
+    fprintf(out, "%s", hashSource);
+
+    for (int d = 0; d < count; d++) {
+        Dictionary *dictionary = &dictionaries[d];
+
+        fprintf(out, "\nconst char *const %sNames[%s_COUNT] = {", dictionary->name, dictionary->macroName);
+        for (int i = 0; i < dictionary->wordCount; i++) {
+            fprintf(out, "%s\"%s\"%s", i % 8 == 0 ? "\n    " : " ", dictionary->words[i],
+                    i + 1 < dictionary->wordCount ? "," : "");
+        }
+        fprintf(out, "\n};\n");
+
+        fprintf(out, "\nstatic const unsigned char %sLengths[%s_COUNT] = {", dictionary->name, dictionary->macroName);
+        for (int i = 0; i < dictionary->wordCount; i++) {
+            fprintf(out, "%s%d%s", i % 16 == 0 ? "\n    " : " ", (int)strlen(dictionary->words[i]),
+                    i + 1 < dictionary->wordCount ? "," : "");
+        }
+        fprintf(out, "\n};\n");
+
+        fprintf(out, "\nstatic const unsigned int %sSeeds[%d] = {", dictionary->name, dictionary->bucketCount);
+        for (int i = 0; i < dictionary->bucketCount; i++) {
+            fprintf(out, "%s%u%s", i % 16 == 0 ? "\n    " : " ", dictionary->seeds[i],
+                    i + 1 < dictionary->bucketCount ? "," : "");
+        }
+        fprintf(out, "\n};\n");
+
+        fprintf(out, "\nstatic const short %sSlots[%d] = {", dictionary->name, dictionary->slotCount);
+        for (int i = 0; i < dictionary->slotCount; i++) {
+            fprintf(out, "%s%d%s", i % 16 == 0 ? "\n    " : " ", dictionary->slots[i],
+                    i + 1 < dictionary->slotCount ? "," : "");
+        }
+        fprintf(out, "\n};\n");
+
+        fprintf(out, "\n/**\n * Returns the index in %sNames[] of %s, or -1\n */\n",
+                dictionary->name, dictionary->description);
+        fprintf(out, "int %s(const char *text, int length) {\n", dictionary->function);
+        fprintf(out, "    if (length <= 0 || length > %d) {\n        return -1;\n    }\n\n", dictionary->maxLength);
+        fprintf(out, "    unsigned int hash = dictionaryHash(text, length);\n");
+        fprintf(out, "    int index = %sSlots[dictionaryMix(hash ^ %sSeeds[hash & %d]) & %d];\n",
+                dictionary->name, dictionary->name, dictionary->bucketCount - 1, dictionary->slotCount - 1);
+        fprintf(out, "    if (index < 0 || %sLengths[index] != length || memcmp(%sNames[index], text, length) != 0) {\n",
+                dictionary->name, dictionary->name);
+        fprintf(out, "        return -1;\n    }\n    return index;\n}\n");
+    }
+}
+
+int main() {
+    Dictionary dictionaries[] = {
+        {"keyword", "KEYWORD", "lookupKeyword", "a C keyword",
+         keywordList, sizeof(keywordList) / sizeof(keywordList[0])},
+        {"stdLibFunction", "STDLIB_FUNCTION", "lookupStdLibFunction", "a C11 standard library function or macro",
+         stdLibList, sizeof(stdLibList) / sizeof(stdLibList[0])}
+    };
+    int count = sizeof(dictionaries) / sizeof(dictionaries[0]);
+
+    for (int d = 0; d < count; d++) {
+        buildDictionary(&dictionaries[d]);
+    }
+
+    FILE *header = fopen("dictionaries.h", "w");
+    FILE *source = fopen("dictionaries.c", "w");
+    if (!header || !source) {
+        printf("Error: Cannot write dictionaries.h and dictionaries.c\n");
+        return 1;
+    }
+    writeHeader(header, dictionaries, count);
+    writeSource(source, dictionaries, count);
+    fclose(header);
+    fclose(source);
+
+    for (int d = 0; d < count; d++) {
+        printf("%s: %d words in %d slots\n", dictionaries[d].name, dictionaries[d].wordCount, dictionaries[d].slotCount);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <string.h>
+#include "intern.h"
+
+#define INTERN_MIN_SLOTS 256    // Smallest index internInit() creates
+
+// FNV-1a over the name's bytes
+unsigned int internHash(const char *text, int length) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Find the slot holding the name, or the empty slot where it belongs
+static int findSlot(const InternTable *table, const char *text, int length, unsigned int hash) {
+    unsigned int mask = (unsigned int)table->slotCount - 1;
+    unsigned int slot = hash & mask;
+
+    for (;;) {
+        int entry = table->slots[slot];
+        if (entry == 0) {
+            return (int)slot;
+        }
+
+        int id = entry - 1;
+        if (table->hashes[id] == hash && table->lengths[id] == length &&
+            memcmp(table->texts[id], text, length) == 0) {
+            return (int)slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+// Replace the index with one of slotCount slots and reinsert every ID
+static void resizeSlots(InternTable *table, int slotCount) {
+    table->slots = arenaAlloc(table->arena, (size_t)slotCount * sizeof(int));
+    memset(table->slots, 0, (size_t)slotCount * sizeof(int));
+    table->slotCount = slotCount;
+
+    unsigned int mask = (unsigned int)slotCount - 1;
+    for (int id = 0; id < table->count; id++) {
+        unsigned int slot = table->hashes[id] & mask;
+        while (table->slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        table->slots[slot] = id + 1;
+    }
+}
+
+// Start an empty table sized for about expected distinct names
+void internInit(InternTable *table, Arena *arena, int expected) {
+    int slotCount = INTERN_MIN_SLOTS;
+    while (slotCount < expected * 2) {
+        slotCount *= 2;
+    }
+
+    table->arena = arena;
+    table->texts = NULL;
+    table->lengths = NULL;
+    table->hashes = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    resizeSlots(table, slotCount);
+}
+
+// Return the name's ID, giving it the next free one if it is new
+int internName(InternTable *table, const char *text, int length) {
+    return internHashedName(table, text, length, internHash(text, length));
+}
+
+// internName() for a name whose internHash() is already known, so callers
+// can hash names on other threads and intern them in order on one
+int internHashedName(InternTable *table, const char *text, int length, unsigned int hash) {
+    int slot = findSlot(table, text, length, hash);
+
+    if (table->slots[slot] != 0) {
+        return table->slots[slot] - 1;
+    }
+
+    int id = table->count;
+    if (id == table->capacity) {
+        int capacity = table->capacity;
+        table->texts = arenaGrowArray(table->arena, table->texts, id, &capacity, sizeof(table->texts[0]));
+        capacity = table->capacity;
+        table->lengths = arenaGrowArray(table->arena, table->lengths, id, &capacity, sizeof(table->lengths[0]));
+        capacity = table->capacity;
+        table->hashes = arenaGrowArray(table->arena, table->hashes, id, &capacity, sizeof(table->hashes[0]));
+        table->capacity = capacity;
+    }
+
+    table->texts[id] = text;
+    table->lengths[id] = length;
+    table->hashes[id] = hash;
+    table->slots[slot] = id + 1;
+    table->count++;
+
+    // Keep the load factor at or below one half
+    if (table->count * 2 > table->slotCount) {
+        resizeSlots(table, table->slotCount * 2);
+    }
+    return id;
+}
+
+// Return the name's ID, or -1 if it was never interned
+int internFind(const InternTable *table, const char *text, int length) {
+    if (table->slotCount == 0) {
+        return -1;
+    }
+
+    int slot = findSlot(table, text, length, internHash(text, length));
+    return table->slots[slot] - 1;
+}
@@ -0,0 +1,27 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include "arena.h"
+
+// Maps each distinct identifier to a dense integer ID (0, 1, 2, ...), so that
+// later passes compare names as integers. Names are stored as views: the text
+// handed to internName() must outlive the table.
+typedef struct {
+    Arena *arena;           // Where the table's arrays live
+    const char **texts;     // texts[id]: first occurrence of the name
+    int *lengths;           // lengths[id]: its length in bytes
+    unsigned int *hashes;   // hashes[id]: its hash, kept for rehashing
+    int count;              // Number of IDs handed out
+    int capacity;           // Room in texts, lengths and hashes
+    int *slots;             // Open-addressing index: ID + 1, or 0 when empty
+    int slotCount;          // Always a power of two
+} InternTable;
+
+// Function prototypes
+unsigned int internHash(const char *text, int length);
+void internInit(InternTable *table, Arena *arena, int expected);
+int internName(InternTable *table, const char *text, int length);
+int internHashedName(InternTable *table, const char *text, int length, unsigned int hash);
+int internFind(const InternTable *table, const char *text, int length);
+
+#endif // INTERN_H
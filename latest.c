@@ -4,677 +4,2525 @@
  #include <string.h>
  #include <ctype.h>
  #include <stdbool.h>
+ #include <stdarg.h>
+ #include <pthread.h>
+ #include "arena.h"
+ #include "simd_scan.h"
+ #include "dictionaries.h"
+ #include "intern.h"
+ #include "thread_pool.h"
+ #include "scope.h"
+ #include "fuzzy.h"
+ #include "suggest.h"
+ #include "format.h"
+ #include "tokens.h"
+ #include "parser.h"
+ #include "sink.h"
+ #include "profile.h"
+ #ifndef _WIN32
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #endif
  
  /* Maximum lengths for various elements */
  #define MAX_LINE_LENGTH 1024
  #define MAX_FILENAME_LENGTH 256
  #define MAX_IDENTIFIER_LENGTH 256
  #define MAX_ERROR_MSG_LENGTH 512
- #define MAX_TOKENS 10000
- #define MAX_STACK_SIZE 1000
- #define MAX_VARIABLES 1000
- #define MAX_FUNCTIONS 1000
- #define MAX_KEYWORDS 32
+ #define MAX_ERROR_LINE_LENGTH (MAX_ERROR_MSG_LENGTH + 64)  // An error's message with its position
+ #define MAX_PASSES 32                    // Entries the analysis pass table may have
+ #define PARALLEL_MIN_TOKENS 65536        // Smaller inputs are analysed on one thread
+ #define CHUNK_MIN_TOKENS 4096            // Fewest tokens a --by-function task is given
+ #define PARALLEL_LEX_MIN_BYTES (4 << 20) // Smaller inputs are lexed on one thread
+ #define LEX_CHUNKS_PER_THREAD 4          // Chunks the parallel lexer cuts per thread
+ #define LEX_MIN_CHUNK_BYTES (256 << 10)  // Smallest chunk it cuts
+ #define MAX_SUGGESTIONS 3                // Names an undefined-variable error suggests at most
+ #define MAX_SUGGESTION_DISTANCE 2        // Edits a suggested name may be away, however long the name
+ #define SUGGESTION_CACHE_SIZE 1024       // Lookups checkUndefinedVariables() remembers (a power of two)
+ #define MAX_ERROR_ARGS 4                 // Arguments an error record holds
  
- /* Token types */
- typedef enum {
-     TOKEN_IDENTIFIER,
-     TOKEN_KEYWORD,
-     TOKEN_NUMBER,
-     TOKEN_STRING,
-     TOKEN_CHAR,
-     TOKEN_OPERATOR,
-     TOKEN_SEPARATOR,
-     TOKEN_PREPROCESSOR,
-     TOKEN_COMMENT,
-     TOKEN_EOF
- } TokenType;
- 
- /* Token structure */
- typedef struct {
-     TokenType type;
-     char lexeme[MAX_IDENTIFIER_LENGTH];
-     int line;
-     int column;
- } Token;
+ /* What an identifier is where it appears, as the syntax tree places it */
+ enum {
+     NAME_USE,            // Anything not below: a variable or function used
+     NAME_DECLARED,       // The name a declarator or an enumerator declares
+     NAME_TYPE,           // A typedef name used as a type
+     NAME_TAG,            // A struct, union or enum tag
+     NAME_LABEL,          // A label, or the target of goto
+     NAME_MEMBER          // A member after '.' or '->', or in a designator
+ };
+ 
+ /* Roles a symbol ID can have, as bit flags */
+ #define SYMBOL_FUNCTION 0x01
+ #define SYMBOL_VARIABLE 0x02
+ 
+ /* Bit sets of token types, as passes ask for them */
+ #define TOKEN_MASK(type) (1u << (type))
+ #define ALL_TOKEN_TYPES ((1u << TOKEN_TYPE_COUNT) - 1)
+ 
+ /* The token stream is stored column by column so that each pass only pulls
+  * the arrays it actually reads through the cache. Token i is
+  * (tokenTypes[i], tokenKinds[i], tokenOffsets[i], tokenLengths[i], tokenSymbols[i]);
+  * its lexeme is the slice sourceCode[offset, offset + length), and its line and
+  * column are looked up from the offset in lineStarts[] by tokenLine() and
+  * tokenColumn(), which only reporting needs. Identifiers are
+  * interned as they are lexed, so passes compare names by their symbol ID. */
  
  /* Variable information structure */
  typedef struct {
      char name[MAX_IDENTIFIER_LENGTH];
+     int nameId;     // Symbol ID of the name in identifierTable
      char type[MAX_IDENTIFIER_LENGTH];
      int size;
      int line;
      bool isArray;
+     bool isPointer;
+     bool isBasicType;  // Declared with a basic type keyword, the only types the format checks know
+     bool isEnumerator; // An enum's constant, declared in the scope around the enum
      int arraySize;
+     int token;      // Index of the name's token
  } Variable;
  
  /* Function information structure */
  typedef struct {
      char name[MAX_IDENTIFIER_LENGTH];
+     int nameId;     // Symbol ID of the name in identifierTable
      bool isUserDefined;
      bool isPrototype;
      int line;
+     int token;      // Index of the name's token
      char returnType[MAX_IDENTIFIER_LENGTH];
      
  } Function;
  
- /* Error information structure */
+ /* What an error is about, for counting them by kind */
+ typedef enum {
+     CATEGORY_HEADER,
+     CATEGORY_BRACKET,
+     CATEGORY_SEMICOLON,
+     CATEGORY_QUOTE,
+     CATEGORY_VARIABLE,
+     CATEGORY_OTHER,
+     ERROR_CATEGORY_COUNT
+ } ErrorCategory;
+ 
+ /* Every error a check can report; errorKinds[] has the message of each */
+ typedef enum {
+     ERROR_MAIN_CASE,
+     ERROR_NO_MAIN,
+     ERROR_UNMATCHED_CLOSING,
+     ERROR_MISMATCHED_DELIMITER,
+     ERROR_UNCLOSED_DELIMITER,
+     ERROR_DECLARATION_SEMICOLON,
+     ERROR_STATEMENT_SEMICOLON,
+     ERROR_COMMA_FOR_SEMICOLON,
+     ERROR_UNTERMINATED_STRING,
+     ERROR_UNTERMINATED_CHAR,
+     ERROR_EMPTY_CHAR,
+     ERROR_MULTI_CHAR,
+     ERROR_HEADER_EXTENSION,
+     ERROR_HEADER_CASE,
+     ERROR_HEADER_SPELLING,
+     ERROR_HEADER_QUOTES,
+     ERROR_MALFORMED_INCLUDE,
+     ERROR_INCLUDE_SPACE,
+     ERROR_KEYWORD_CASE,
+     ERROR_FUNCTION_SPELLING,
+     ERROR_FUNCTION_CASE,
+     ERROR_INCLUDE_PLACEMENT,
+     ERROR_INCLUDE_INCOMPLETE,
+     ERROR_INCLUDE_CLOSING_ANGLE,
+     ERROR_INCLUDE_OPENING_ANGLE,
+     ERROR_INCLUDE_CLOSING_QUOTE,
+     ERROR_INCLUDE_NO_NAME,
+     ERROR_INCLUDE_MIXED,
+     ERROR_INCLUDE_TRAILING,
+     ERROR_INCLUDE_TYPO,
+     ERROR_INCLUDE_CASE,
+     ERROR_INCLUDE_MISSPELLED,
+     ERROR_INCLUDE_NO_HASH,
+     ERROR_UNDEFINED_VARIABLE,
+     ERROR_PRINTF_CASE,
+     ERROR_PRINTF_NO_FORMAT,
+     ERROR_PRINTF_BAD_SPECIFIER,
+     ERROR_PRINTF_TOO_FEW,
+     ERROR_PRINTF_TOO_MANY,
+     ERROR_PRINTF_VARIABLE_TYPE,
+     ERROR_PRINTF_UNDEFINED,
+     ERROR_PRINTF_NUMBER,
+     ERROR_PRINTF_STRING,
+     ERROR_PRINTF_CHAR,
+     ERROR_SCANF_NO_ARGUMENTS,
+     ERROR_SCANF_NO_FORMAT,
+     ERROR_SCANF_NO_COMMA,
+     ERROR_SCANF_VARIABLE_TYPE,
+     ERROR_SCANF_NEEDS_ARRAY,
+     ERROR_SCANF_UNDECLARED,
+     ERROR_SCANF_NO_NAME,
+     ERROR_SCANF_MISSING_ADDRESS,
+     ERROR_SCANF_COUNT,
+     ERROR_SCANF_CASE,
+     ERROR_CODE_COUNT
+ } ErrorCode;
+ 
+ /* How the report is written (--format) */
+ typedef enum {
+     REPORT_TEXT,    // For people: banners, each error as found, then the results
+     REPORT_JSON,    // One JSON document, errors streamed into its array as found
+     REPORT_SARIF    // A SARIF 2.1.0 log, for code scanning tools
+ } ReportFormat;
+ 
+ /* One error, as reported: its message is only formatted, by formatError(),
+  * and its line and column only looked up, by errorLine() and errorColumn(),
+  * when it is printed. What each argument is depends on the code. */
  typedef struct {
-     char message[MAX_ERROR_MSG_LENGTH];
-     int line;
-     int column;
+     unsigned short code;    // ErrorCode
+     int token;              // Token the error is about, -1 if none
+     int offset;             // Where in the source it points, -1 for the whole file
+     int args[MAX_ERROR_ARGS];
  } Error;
  
- /* Global variables */
- Token tokens[MAX_TOKENS];
+ /* State the pass engine keeps current while it walks the tokens */
+ typedef struct {
+     int braceDepth;     // '{' opened and not yet closed, up to the current token
+     int parenDepth;     // '(' opened and not yet closed, up to the current token
+     bool afterMain;     // An identifier 'main' appears at or before the current token
+ } PassContext;
+ 
+ /* A call-shaped site: an identifier directly followed by '(' */
+ typedef struct {
+     int token;          // Index of the identifier
+     int nextCall;       // Next site of the same name in token order, -1 after the last
+     int firstArgument;  // Index in callArguments[] of its first argument
+     int argumentCount;  // 0 for "()"
+ } CallSite;
+ 
+ /* One argument of a call: the tokens [from, to), up to the ',' or ')' after it */
+ typedef struct {
+     int from;
+     int to;
+ } ArgumentRange;
+ 
+ /* Shared data a pass can read or produce, besides the token stream which
+  * every pass reads; a pass runs only after those producing what it reads */
+ #define PASS_DATA_FUNCTIONS 0x01   // functions[]
+ #define PASS_DATA_VARIABLES 0x02   // variables[] and declarations[]
+ #define PASS_DATA_BINDINGS 0x04    // tokenBindings[], tokenScopes[] and declarationEnds[]
+ 
+ /* One analysis pass: visit() is called for each token whose type is in
+  * tokenMask. Passes may share a walk over the tokens or run on separate
+  * threads; what a pass reports is printed in table order, buffered until
+  * the passes before it have been printed.
+  * A perFunction pass looks no further than the top-level definition around
+  * each token, so with --by-function it runs as a copy per run of
+  * definitions; a copy starts with no state and merge() folds it back.
+  * A callsOnly pass is not walked: visit() gets the call sites of callee in
+  * token order, with a NULL context, and any token whose name alsoVisits()
+  * accepts, so it never looks at the tokens around calls it has no use for. */
+ typedef struct Pass {
+     const char *name;       // What --profile calls it
+     const char *banner;     // Printed before the pass's errors, NULL for none
+     unsigned int reads;     // PASS_DATA_* the pass needs finished
+     unsigned int writes;    // PASS_DATA_* the pass produces
+     unsigned int tokenMask; // TOKEN_MASK() of each token type visit() wants
+     bool perFunction;       // visit() can run on each top-level definition apart
+     bool callsOnly;         // visit() gets call sites instead of the tokens in tokenMask
+     const char *callee;     // With callsOnly, the name whose calls visit() gets, NULL for every call
+     bool (*alsoVisits)(const char *name, int length); // With callsOnly, other names visit() gets wherever they appear, may be NULL
+     void (*start)(struct Pass *pass);   // Called before the walk, may be NULL
+     void (*visit)(struct Pass *pass, int index, const PassContext *context);
+     void (*finish)(struct Pass *pass);  // Called after the walk, may be NULL
+     void (*merge)(struct Pass *pass, struct Pass *part); // Folds in a copy's state, may be NULL
+     void (*summary)(void);  // Prints results after the pass's errors, may be NULL
+     int resumeAt;           // visit() is not called for tokens before this index
+     int waiting;            // Passes it depends on that have not finished yet
+     Arena *arena;           // Where the pass allocates while it runs
+     void *state;            // Private data of the pass, NULL until it sets some
+     Error *errors;          // Errors held back until its turn to be printed
+     int errorCount;
+     int errorCapacity;
+     int reported;           // Errors it reported, printed or held back, with its summary's
+     bool streaming;         // Its turn has come: its errors are printed as it reports them
+     bool done;              // Finished, so once printed its summary can follow
+     long long visited;      // Tokens handed to visit()
+     unsigned long long visitedBytes; // Source bytes in those tokens
+     double seconds;         // Time spent running it, kept with --profile
+ } Pass;
+ 
+ /* Global variables. Every growable array below lives in analysisArena and
+  * is sized from the input, so there is no fixed limit on any of them. */
+ Arena analysisArena = {0};
+ unsigned char *tokenTypes = NULL;        // TokenType
+ unsigned char *tokenKinds = NULL;        // TokenKind
+ unsigned int *tokenOffsets = NULL;       // Start of the lexeme in sourceCode
+ unsigned int *tokenLengths = NULL;       // Length of the lexeme
+ int *tokenSymbols = NULL;                // Symbol ID of an identifier, -1 for other tokens
  int tokenCount = 0;
- char sourceCode[MAX_LINE_LENGTH * 1000]; // Buffer for the entire source code
- Variable variables[MAX_VARIABLES];
+ int tokenCapacity = 0;
+ InternTable identifierTable = {0};       // Every distinct identifier name, by symbol ID
+ unsigned int *lineStarts = NULL;         // lineStarts[n] is the offset of line n + 1
+ int lineCount = 0;
+ int lineCapacity = 0;
+ char *sourceCode = NULL;     // Entire source file, always NUL-terminated
+ size_t sourceLength = 0;     // Length of sourceCode excluding the terminator
+ size_t sourceMappedSize = 0; // Size of the mapping when sourceCode is mmap'd, 0 if heap-allocated
+ Variable *variables = NULL;              // One per distinct name, its first declaration
  int variableCount = 0;
- Function functions[MAX_FUNCTIONS];
+ int variableCapacity = 0;
+ Variable *declarations = NULL;           // Every declaration found, in token order
+ int declarationCount = 0;
+ int *tokenBindings = NULL;               // Index in declarations[] an identifier refers to, -1 if none in scope
+ int *tokenScopes = NULL;                 // For each identifier, a number that is the same wherever the same names are in scope
+ int *declarationEnds = NULL;             // Token closing the scope of each declaration, tokenCount at file scope
+ Function *functions = NULL;
  int functionCount = 0;
- Error errors[MAX_TOKENS];
- int errorCount = 0;
- 
- /* C Keywords */
- const char *keywords[] = {
-     "auto", "break", "case", "char", "const", "continue", "default", "do",
-     "double", "else", "enum", "extern", "float", "for", "goto", "if",
-     "int", "long", "register", "return", "short", "signed", "sizeof", "static",
-     "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while"
+ int functionCapacity = 0;
+ #ifdef KEEP_ERROR_RECORDS
+ Error *errors = NULL;         // Every error printed, kept only for the diagnostics benchmark to print again
+ int errorCapacity = 0;
+ #endif
+ int errorCount = 0;           // Errors printed so far
+ int errorCategoryCounts[ERROR_CATEGORY_COUNT] = {0};  // Errors printed of each ErrorCategory
+ _Thread_local Pass *currentPass = NULL; // Pass whose errors reportError() buffers on this thread
+ int analysisJobs = 0;        // Threads for the analysis passes, 0 to pick from the CPUs and input size
+ bool splitByFunction = false; // --by-function: run per-function passes on each definition, errors by position
+ bool quietMode = false;       // --quiet: print the errors and nothing else
+ bool showSnippets = false;    // --snippets: show the source line under each error, with a caret
+ ReportFormat reportFormat = REPORT_TEXT;
+ const char *reportSource = NULL;  // The input's name, for JSON and SARIF locations
+ int reportedErrors = 0;           // Errors emitted so far, for the commas between them
+ Sink output;                  // Where the report goes: stdout, or the --output file
+ bool profiling = false;       // --profile: time each phase and pass of the run
+ Sink profileOutput;           // Where the profile goes: the terminal as a table, or a --profile file as JSON
+ Profile profile;
+ int *delimiterMatches = NULL; // For each '(' and '{', the token closing it (tokenCount if none)
+ CallSite *callSites = NULL;   // Every call site, in token order
+ int callSiteCount = 0;
+ int callSiteCapacity = 0;
+ ArgumentRange *callArguments = NULL; // The arguments of each call site, site by site
+ int callArgumentCount = 0;
+ int callArgumentCapacity = 0;
+ int *firstCallSite = NULL;    // For each symbol ID, its first call site, -1 if it is never called
+ Ast syntaxTree = {0};         // The parse of the whole token stream
+ unsigned char *nameRoles = NULL; // NAME_* role of each identifier token
+ int *declarationNodes = NULL; // For each token, the declaration in syntaxTree it is the type of, -1 if none
+ 
+ /* Preprocessor directive names that misspelled directives are compared against */
+ const char *directiveNames[] = {
+     "include", "define", "undef", "if", "ifdef", "ifndef", "elif", "else",
+     "endif", "line", "error", "pragma", "warning"
+ };
+ #define DIRECTIVE_INCLUDE 0   // Index of "include" in directiveNames[]
+ 
+ /* Standard headers that #include names are compared against */
+ const char *stdHeaders[] = {
+     "stdio.h", "stdlib.h", "string.h", "ctype.h", "math.h",
+     "time.h", "stdbool.h", "stddef.h", "stdint.h", "float.h",
+     "limits.h", "assert.h", "locale.h", "setjmp.h", "signal.h"
+ };
+ 
+ /* The ID, message and category of each error code. Besides %c, %d and %%, a
+  * message may hold, each taking the next argument unless noted:
+  *   %t  the text of the error's token (no argument)
+  *   %s  a slice of that text: offset, then length (two arguments)
+  *   %h  stdHeaders[argument]
+  *   %k  keywordNames[argument]
+  *   %f  stdLibFunctionNames[argument]
+  *   %y  the type of declarations[argument]
+  *   %l  "line L, column C" of the token in the argument
+  *   %m  ", did you mean 'a', 'b' or 'c'?" for the symbol IDs in the
+  *       remaining arguments, up to a -1; nothing if there are none */
+ typedef struct {
+     const char *name;           // Stable ID for machine-readable output
+     const char *message;
+     unsigned char category;     // ErrorCategory
+     unsigned char argCount;
+     unsigned char wholeLine;    // Points at its line (column 0) rather than a column
+ } ErrorKind;
+ 
+ static const ErrorKind errorKinds[ERROR_CODE_COUNT] = {
+     [ERROR_MAIN_CASE] = {"main-case", "Case sensitivity error: 'main' function must be lowercase", CATEGORY_OTHER, 0, 1},
+     [ERROR_NO_MAIN] = {"no-main", "No 'main' function found in the program", CATEGORY_OTHER, 0},
+     [ERROR_UNMATCHED_CLOSING] = {"unmatched-closing", "Unmatched closing delimiter '%t'", CATEGORY_BRACKET, 0},
+     [ERROR_MISMATCHED_DELIMITER] = {"mismatched-delimiter", "Mismatched delimiter: expected '%c' but found '%c'. Opening delimiter at %l", CATEGORY_BRACKET, 3},
+     [ERROR_UNCLOSED_DELIMITER] = {"unclosed-delimiter", "Unclosed delimiter '%t'", CATEGORY_BRACKET, 0},
+     [ERROR_DECLARATION_SEMICOLON] = {"declaration-semicolon", "Missing semicolon after variable declaration", CATEGORY_SEMICOLON, 0},
+     [ERROR_STATEMENT_SEMICOLON] = {"statement-semicolon", "Missing semicolon at end of statement", CATEGORY_SEMICOLON, 0},
+     [ERROR_COMMA_FOR_SEMICOLON] = {"comma-for-semicolon", "Comma used instead of semicolon", CATEGORY_SEMICOLON, 0},
+     [ERROR_UNTERMINATED_STRING] = {"unterminated-string", "Unterminated string literal", CATEGORY_QUOTE, 0},
+     [ERROR_UNTERMINATED_CHAR] = {"unterminated-char", "Unterminated character literal", CATEGORY_QUOTE, 0},
+     [ERROR_EMPTY_CHAR] = {"empty-char", "Empty character literal", CATEGORY_QUOTE, 0},
+     [ERROR_MULTI_CHAR] = {"multi-char", "Multi-character literal (too many characters)", CATEGORY_QUOTE, 0},
+     [ERROR_HEADER_EXTENSION] = {"header-extension", "Missing '.h' extension in header file name", CATEGORY_HEADER, 0},
+     [ERROR_HEADER_CASE] = {"header-case", "Case sensitivity error in header file name (should be '%h')", CATEGORY_HEADER, 1},
+     [ERROR_HEADER_SPELLING] = {"header-spelling", "Possible misspelling in header name: '%s', did you mean '%h'?", CATEGORY_HEADER, 3},
+     [ERROR_HEADER_QUOTES] = {"header-quotes", "Standard library header should use angle brackets '<>' instead of quotes", CATEGORY_HEADER, 0},
+     [ERROR_MALFORMED_INCLUDE] = {"malformed-include", "Malformed #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_SPACE] = {"include-space", "Missing space after '#include'", CATEGORY_HEADER, 0},
+     [ERROR_KEYWORD_CASE] = {"keyword-case", "Case sensitivity error: '%t' should be '%k'", CATEGORY_OTHER, 1},
+     [ERROR_FUNCTION_SPELLING] = {"function-spelling", "Possible misspelling of standard function: '%t', did you mean '%f'?", CATEGORY_OTHER, 1},
+     [ERROR_FUNCTION_CASE] = {"function-case", "Case sensitivity error in function call: '%t' should be '%f'", CATEGORY_OTHER, 1},
+     [ERROR_INCLUDE_PLACEMENT] = {"include-placement", "Invalid placement of #include directive. It must be outside of functions.", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_INCOMPLETE] = {"include-incomplete", "Incomplete #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_CLOSING_ANGLE] = {"include-closing-angle", "Missing closing '>' in #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_OPENING_ANGLE] = {"include-opening-angle", "Missing opening '<' in #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_CLOSING_QUOTE] = {"include-closing-quote", "Missing closing '\"' in #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_NO_NAME] = {"include-no-name", "Missing file name in #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_MIXED] = {"include-mixed", "Cannot use both angle brackets and quotes in #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_TRAILING] = {"include-trailing", "Extra characters after header name in #include directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_TYPO] = {"include-typo", "Possible typo in '#include' directive", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_CASE] = {"include-case", "'#include' directive must be lowercase", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_MISSPELLED] = {"include-misspelled", "Possible typo: Did you mean '#include'?", CATEGORY_HEADER, 0},
+     [ERROR_INCLUDE_NO_HASH] = {"include-no-hash", "Missing '#' before 'include' directive", CATEGORY_HEADER, 0},
+     [ERROR_UNDEFINED_VARIABLE] = {"undefined-variable", "Undefined variable '%t'%m", CATEGORY_VARIABLE, MAX_SUGGESTIONS},
+     [ERROR_PRINTF_CASE] = {"printf-case", "Case sensitivity error. Did you mean 'printf'?", CATEGORY_OTHER, 0},
+     [ERROR_PRINTF_NO_FORMAT] = {"printf-no-format", "printf call missing format string", CATEGORY_OTHER, 0},
+     [ERROR_PRINTF_BAD_SPECIFIER] = {"printf-bad-specifier", "Invalid format specifier '%%%c' in printf", CATEGORY_OTHER, 1},
+     [ERROR_PRINTF_TOO_FEW] = {"printf-too-few", "Too few arguments for printf format string", CATEGORY_OTHER, 0},
+     [ERROR_PRINTF_TOO_MANY] = {"printf-too-many", "Too many arguments for printf format string", CATEGORY_OTHER, 0},
+     [ERROR_PRINTF_VARIABLE_TYPE] = {"printf-variable-type", "Format specifier '%%%c' incompatible with variable type '%y'", CATEGORY_OTHER, 2},
+     [ERROR_PRINTF_UNDEFINED] = {"printf-undefined", "Undefined variable '%t' used in printf", CATEGORY_VARIABLE, 0},
+     [ERROR_PRINTF_NUMBER] = {"printf-number", "Format specifier '%%%c' incompatible with numeric literal", CATEGORY_OTHER, 1},
+     [ERROR_PRINTF_STRING] = {"printf-string", "Format specifier '%%%c' incompatible with string literal", CATEGORY_OTHER, 1},
+     [ERROR_PRINTF_CHAR] = {"printf-char", "Format specifier '%%%c' incompatible with character literal", CATEGORY_OTHER, 1},
+     [ERROR_SCANF_NO_ARGUMENTS] = {"scanf-no-arguments", "scanf called with no arguments", CATEGORY_OTHER, 0},
+     [ERROR_SCANF_NO_FORMAT] = {"scanf-no-format", "scanf first argument should be a format string", CATEGORY_OTHER, 0},
+     [ERROR_SCANF_NO_COMMA] = {"scanf-no-comma", "Expected comma after format string in scanf", CATEGORY_OTHER, 0},
+     [ERROR_SCANF_VARIABLE_TYPE] = {"scanf-variable-type", "Format specifier %%%c doesn't match variable type %y", CATEGORY_OTHER, 2},
+     [ERROR_SCANF_NEEDS_ARRAY] = {"scanf-needs-array", "Format specifier %%s requires char array", CATEGORY_OTHER, 0},
+     [ERROR_SCANF_UNDECLARED] = {"scanf-undeclared", "Undeclared variable '%t' used in scanf", CATEGORY_VARIABLE, 0},
+     [ERROR_SCANF_NO_NAME] = {"scanf-no-name", "Expected variable name after & in scanf", CATEGORY_OTHER, 0},
+     [ERROR_SCANF_MISSING_ADDRESS] = {"scanf-missing-address", "Missing & operator for non-array variable in scanf", CATEGORY_OTHER, 0},
+     [ERROR_SCANF_COUNT] = {"scanf-count", "scanf format specifier count (%d) doesn't match argument count (%d)", CATEGORY_OTHER, 2},
+     [ERROR_SCANF_CASE] = {"scanf-case", "Case sensitivity error: 'scanf' is lowercase in C", CATEGORY_OTHER, 0}
  };
  
- /* Standard library functions */
- const char *stdLibFunctions[] = {
-     "printf", "scanf", "gets", "puts", "fprintf", "fscanf", "fgets", "fputs",
-     "malloc", "calloc", "realloc", "free", "memcpy", "memmove", "memset",
-     "strcpy", "strncpy", "strcat", "strncat", "strcmp", "strncmp", "strlen"
+ /* Name of each ErrorCategory in JSON and SARIF output */
+ static const char *const categoryNames[ERROR_CATEGORY_COUNT] = {
+     "header", "bracket", "semicolon", "quote", "variable", "other"
  };
  
+ /* The keyword, standard library and header names, for lookups that ignore
+  * case or allow a few typos */
+ FuzzyDictionary keywordDictionary = {0};
+ FuzzyDictionary stdLibDictionary = {0};
+ FuzzyDictionary headerDictionary = {0};
+ FuzzyDictionary directiveDictionary = {0};
+ 
  /* Function prototypes */
  void readSourceFile(const char* filename);
+ void indexLines();
+ void releaseSourceFile();
  void tokenize();
  void analyzeCode();
- void checkBalancedDelimiters();
- void checkMissingSemicolons();
- void checkUnmatchedQuotes();
- void identifyFunctions();
- void trackVariables();
+ void resetDelimiterStack(Pass *pass);
+ void checkBalancedDelimiters(Pass *pass, int i, const PassContext *context);
+ void reportUnclosedDelimiters(Pass *pass);
+ void checkMissingSemicolons(Pass *pass, int i, const PassContext *context);
+ void checkUnmatchedQuotes(Pass *pass, int i, const PassContext *context);
+ void resetStdLibCalls(Pass *pass);
+ void identifyFunctions(Pass *pass, int i, const PassContext *context);
+ void addFunctions(Pass *pass);
+ void trackVariables(Pass *pass, int i, const PassContext *context);
+ void mergeTrackedVariables(Pass *pass, Pass *part);
+ void addTrackedVariables(Pass *pass);
+ void startNameResolution(Pass *pass);
+ void resolveNames(Pass *pass, int i, const PassContext *context);
+ void markSymbolRoles(Pass *pass);
+ void checkUndefinedVariables(Pass *pass, int i, const PassContext *context);
  void calculateMemoryUsage();
- void identifyKeywords();
- void checkPrintfErrors();
- void checkScanfErrors();
- bool isKeyword(const char *identifier);
- bool isStdLibFunction(const char *identifier);
+ void resetKeywordCounts(Pass *pass);
+ void identifyKeywords(Pass *pass, int i, const PassContext *context);
+ void printKeywordUsage();
+ void startPrintfFormats(Pass *pass);
+ void startFunctionSpelling(Pass *pass);
+ void checkPrintfErrors(Pass *pass, int i, const PassContext *context);
+ void startScanfFormats(Pass *pass);
+ void checkScanfErrors(Pass *pass, int i, const PassContext *context);
+ const char *tokenText(int index);
+ int offsetLine(unsigned int offset);
+ int tokenLine(int index);
+ int tokenColumn(int index);
+ int tokenEndOffset(int index);
+ bool lineBreakAfter(int index);
+ int errorLine(const Error *error);
+ int errorColumn(const Error *error);
+ bool tokenIs(int index, const char *text);
+ void copyTokenText(int index, char *buffer, size_t size);
+ int directiveText(int index, char *buffer);
+ const char *directiveName(int index, int *length);
+ bool isHeaderWithoutExtension(const char *name, int length);
+ bool isKeyword(const char *identifier, int length);
+ bool isStdLibFunction(const char *identifier, int length);
+ bool isPrintfCaseVariant(const char *name, int length);
+ bool isScanfCaseVariant(const char *name, int length);
  int getTypeSize(const char *type);
- void reportError(const char *message, int line, int column);
+ void reportError(ErrorCode code, int token, ...);
+ void reportErrorAt(ErrorCode code, int token, int offset, ...);
+ void recordError(const Error *error);
+ void printError(const Error *error);
+ void emitError(const Error *error);
+ void emitSnippet(const Error *error);
+ void emitErrorObject(const Error *error);
+ void emitSuggestions(const Error *error);
+ void emitText(const char *text);
+ void beginReport();
+ void endReport();
+ void printReport(const char *format, ...);
+ int formatError(const Error *error, char *buffer, size_t size);
  void printResults();
- void checkHeaderFileErrors();
- void checkKeywordCaseSensitivity();
- void checkStandardFunctionSpelling();
- void checkIncludeDirectiveFormat();
- void checkIncludePlacement(); 
+ void profilePhase(const char *name, double seconds, long long tokens, long long diagnostics, unsigned long long bytes);
+ void writeProfile();
+ void checkHeaderFileErrors(Pass *pass, int i, const PassContext *context);
+ void checkKeywordCaseSensitivity(Pass *pass, int i, const PassContext *context);
+ void checkStandardFunctionSpelling(Pass *pass, int i, const PassContext *context);
+ void checkIncludeDirectiveFormat(Pass *pass, int i, const PassContext *context);
+ void checkIncludePlacement(Pass *pass, int i, const PassContext *context);
  void validateMainFunction();
  /**
   * Main function - Entry point of the program
   */
  int main(int argc, char *argv[]) {
-     if (argc < 2) {
-         printf("Usage: %s <source_file>\n", argv[0]);
+     const char *sourcePath = NULL;
+     const char *outputPath = NULL;
+     const char *profilePath = NULL;
+     
+     for (int i = 1; i < argc; i++) {
+         if (strncmp(argv[i], "--jobs=", 7) == 0) {
+             analysisJobs = atoi(argv[i] + 7);
+             if (analysisJobs < 1) {
+                 printf("Error: --jobs needs a positive number of threads\n");
+                 return 1;
+             }
+         } else if (strcmp(argv[i], "--by-function") == 0) {
+             splitByFunction = true;
+         } else if (strcmp(argv[i], "--quiet") == 0) {
+             quietMode = true;
+         } else if (strcmp(argv[i], "--snippets") == 0) {
+             showSnippets = true;
+         } else if (strcmp(argv[i], "--profile") == 0) {
+             profiling = true;
+         } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+             profiling = true;
+             profilePath = argv[i] + 10;
+         } else if (strncmp(argv[i], "--output=", 9) == 0) {
+             outputPath = argv[i] + 9;
+         } else if (strncmp(argv[i], "--format=", 9) == 0) {
+             if (strcmp(argv[i] + 9, "text") == 0) {
+                 reportFormat = REPORT_TEXT;
+             } else if (strcmp(argv[i] + 9, "json") == 0) {
+                 reportFormat = REPORT_JSON;
+             } else if (strcmp(argv[i] + 9, "sarif") == 0) {
+                 reportFormat = REPORT_SARIF;
+             } else {
+                 printf("Error: --format must be text, json or sarif\n");
+                 return 1;
+             }
+         } else if (sourcePath == NULL) {
+             sourcePath = argv[i];
+         } else {
+             sourcePath = NULL;
+             break;
+         }
+     }
+     
+     if (sourcePath == NULL) {
+         printf("Usage: %s [--jobs=N] [--by-function] [--quiet] [--snippets] [--profile[=FILE]] [--output=FILE] [--format=text|json|sarif] <source_file | ->\n", argv[0]);
+         return 1;
+     }
+     
+     if (outputPath == NULL) {
+         sinkOpenTerminal(&output);
+     } else if (!sinkOpenFile(&output, outputPath)) {
+         printf("Error: Cannot create file %s\n", outputPath);
+         return 1;
+     }
+     if (profilePath == NULL && reportFormat != REPORT_TEXT) {
+         // Keep the table out of the JSON or SARIF document on stdout
+         sinkOpenErrors(&profileOutput);
+     } else if (profilePath == NULL) {
+         sinkOpenTerminal(&profileOutput);
+     } else if (!sinkOpenFile(&profileOutput, profilePath)) {
+         printf("Error: Cannot create file %s\n", profilePath);
          return 1;
      }
      
-     readSourceFile(argv[1]);
+     reportSource = sourcePath;
+     profileStart(&profile);
+     simdScanInit(SIMD_AVX2);
+     double started = profileNow();
+     readSourceFile(sourcePath);
+     profilePhase("readSourceFile", profileNow() - started, 0, 0, sourceLength);
+     beginReport();
+     started = profileNow();
      tokenize();
+     profilePhase("tokenize", profileNow() - started, tokenCount, 0, sourceLength);
+     sinkFlush(&output);
      analyzeCode();
+     started = profileNow();
+     unsigned long long written = output.bytes;
      printResults();
+     endReport();
+     written = output.bytes - written;
+     sinkClose(&output);
+     profilePhase("printResults", profileNow() - started, 0, 0, written);
+     if (profiling) {
+         writeProfile();
+     }
+     sinkClose(&profileOutput);
+     releaseSourceFile();
+     arenaFree(&analysisArena);
      
      return 0;
  }
  
  /**
-  * Reads the source code file into memory
+  * Reads a whole stream into a heap buffer, growing it geometrically.
+  * Used for pipes, stdin and anything else whose size is not known up front.
   */
- void readSourceFile(const char* filename) {
-     FILE *file = fopen(filename, "r");
-     if (!file) {
-         printf("Error: Cannot open file %s\n", filename);
-         exit(1);
+ static bool readSourceStream(FILE *file) {
+     size_t capacity = 64 * 1024;
+     size_t length = 0;
+     char *buffer = malloc(capacity);
+     
+     if (!buffer) {
+         return false;
+     }
+     
+     while (true) {
+         if (capacity - length < 2) {
+             char *grown = realloc(buffer, capacity * 2);
+             if (!grown) {
+                 free(buffer);
+                 return false;
+             }
+             buffer = grown;
+             capacity *= 2;
+         }
+         
+         size_t n = fread(buffer + length, 1, capacity - length - 1, file);
+         length += n;
+         if (n == 0) {
+             break;
+         }
      }
      
-     char line[MAX_LINE_LENGTH];
-     sourceCode[0] = '\0';
+     if (ferror(file)) {
+         free(buffer);
+         return false;
+     }
      
-     while (fgets(line, MAX_LINE_LENGTH, file)) {
-         strcat(sourceCode, line);
+     if (capacity < length + 1 + SIMD_SCAN_PADDING) {
+         char *grown = realloc(buffer, length + 1 + SIMD_SCAN_PADDING);
+         if (!grown) {
+             free(buffer);
+             return false;
+         }
+         buffer = grown;
      }
      
-     fclose(file);
-     printf("File read successfully: %s\n", filename);
+     memset(buffer + length, 0, 1 + SIMD_SCAN_PADDING);
+     sourceCode = buffer;
+     sourceLength = length;
+     sourceMappedSize = 0;
+     return true;
  }
  
  /**
-  * Tokenizes the source code
+  * Reads a file of known size with a single sized read
   */
- void tokenize() {
-     char *current = sourceCode;
-     int line = 1;
-     int column = 1;
-     char lexeme[MAX_IDENTIFIER_LENGTH];
-     int lexemeIndex;
-     
-     while (*current != '\0') {
-         // Skip whitespace
-         if (isspace(*current)) {
-             if (*current == '\n') {
-                 line++;
-                 column = 1;
-             } else {
-                 column++;
-             }
-             current++;
-             continue;
-         }
-         
-         // Handle comments
-         if (*current == '/' && *(current + 1) == '/') {
-             // Single-line comment
-             while (*current != '\0' && *current != '\n') {
-                 current++;
-             }
-             continue;
-         }
-         
-         if (*current == '/' && *(current + 1) == '*') {
-             // Multi-line comment
-             current += 2;
-             column += 2;
-             while (*current != '\0' && !(*current == '*' && *(current + 1) == '/')) {
-                 if (*current == '\n') {
-                     line++;
-                     column = 1;
-                 } else {
-                     column++;
-                 }
-                 current++;
-             }
-             if (*current != '\0') {
-                 current += 2;
-                 column += 2;
-             }
-             continue;
-         }
-         
-        // Handle preprocessor directives
-if (*current == '#') {
-    lexemeIndex = 0;
-    lexeme[lexemeIndex++] = *current++;
-    column++;
-    
-    // Skip whitespace after #
-    while (*current != '\0' && isspace(*current) && *current != '\n') {
-        current++;
-        column++;
-    }
-    
-    // Get the directive name
-    while (*current != '\0' && !isspace(*current) && *current != '\n') {
-        if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-            lexeme[lexemeIndex++] = *current;
-        }
-        current++;
-        column++;
-    }
-    
-    // Skip whitespace after directive name
-    while (*current != '\0' && isspace(*current) && *current != '\n') {
-        current++;
-        column++;
-    }
-    
-    // Get the rest of the line for include directives
-    if (strncmp(lexeme, "#include", 8) == 0) {
-        while (*current != '\0' && *current != '\n') {
-            if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                lexeme[lexemeIndex++] = *current;
-            }
-            current++;
-            column++;
-        }
-    } else {
-        // For other directives, just get to the end of line
-        while (*current != '\0' && *current != '\n') {
-            if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                lexeme[lexemeIndex++] = *current;
-            }
-            current++;
-            column++;
-        }
-    }
-    
-    lexeme[lexemeIndex] = '\0';
-    
-    tokens[tokenCount].type = TOKEN_PREPROCESSOR;
-    strcpy(tokens[tokenCount].lexeme, lexeme);
-    tokens[tokenCount].line = line;
-    tokens[tokenCount].column = column - lexemeIndex;
-    tokenCount++;
-    
-    continue;
-}
-         
-         // Handle string literals
-         if (*current == '"') {
-             lexemeIndex = 0;
-             lexeme[lexemeIndex++] = *current++;
-             column++;
-             
-             while (*current != '\0' && *current != '"') {
-                 if (*current == '\\' && *(current + 1) != '\0') {
-                     // Skip escaped characters
-                     if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                         lexeme[lexemeIndex++] = *current;
-                     }
-                     current++;
-                     column++;
-                 }
-                 
-                 if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                     lexeme[lexemeIndex++] = *current;
-                 }
-                 
-                 if (*current == '\n') {
-                     line++;
-                     column = 1;
-                 } else {
-                     column++;
-                 }
-                 
-                 current++;
-             }
-             
-             if (*current == '"') {
-                 if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                     lexeme[lexemeIndex++] = *current;
-                 }
-                 current++;
-                 column++;
-             }
-             
-             lexeme[lexemeIndex] = '\0';
-             
-             tokens[tokenCount].type = TOKEN_STRING;
-             strcpy(tokens[tokenCount].lexeme, lexeme);
-             tokens[tokenCount].line = line;
-             tokens[tokenCount].column = column - lexemeIndex;
-             tokenCount++;
-             
-             continue;
+ static bool readSourceSized(FILE *file, size_t size) {
+     char *buffer = malloc(size + 1 + SIMD_SCAN_PADDING);
+     
+     if (!buffer) {
+         return false;
+     }
+     
+     size_t length = fread(buffer, 1, size, file);
+     if (ferror(file)) {
+         free(buffer);
+         return false;
+     }
+     
+     memset(buffer + length, 0, 1 + SIMD_SCAN_PADDING);
+     sourceCode = buffer;
+     sourceLength = length;
+     sourceMappedSize = 0;
+     return true;
+ }
+ 
+ #ifndef _WIN32
+ /**
+  * Maps a regular file read-only. An anonymous zero-filled region larger
+  * than the file by the terminator and the scan padding is reserved first
+  * and the file is mapped over it, so the bytes after the last character
+  * are always readable zeros even when the file size is an exact multiple
+  * of the page size.
+  */
+ static bool mapSourceFile(int fd, size_t size) {
+     size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+     size_t mappedSize = (size + 1 + SIMD_SCAN_PADDING + pageSize - 1) / pageSize * pageSize;
+     
+     char *region = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+     if (region == MAP_FAILED) {
+         return false;
+     }
+     
+     if (mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+         munmap(region, mappedSize);
+         return false;
+     }
+     
+     sourceCode = region;
+     sourceLength = size;
+     sourceMappedSize = mappedSize;
+     return true;
+ }
+ #endif
+ 
+ /**
+  * Loads the source code into memory without any size limit.
+  * Regular files are memory-mapped (or read in one sized read where mmap is
+  * unavailable); pipes and stdin ("-") are read in large blocks.
+  */
+ void readSourceFile(const char* filename) {
+     bool loaded = false;
+     
+     if (strcmp(filename, "-") == 0) {
+         loaded = readSourceStream(stdin);
+     } else {
+ #ifdef _WIN32
+         FILE *file = fopen(filename, "rb");
+         if (!file) {
+             printf("Error: Cannot open file %s\n", filename);
+             exit(1);
          }
          
-         // Handle character literals
-         if (*current == '\'') {
-             lexemeIndex = 0;
-             lexeme[lexemeIndex++] = *current++;
-             column++;
-             
-             while (*current != '\0' && *current != '\'') {
-                 if (*current == '\\' && *(current + 1) != '\0') {
-                     // Skip escaped characters
-                     if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                         lexeme[lexemeIndex++] = *current;
-                     }
-                     current++;
-                     column++;
-                 }
-                 
-                 if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                     lexeme[lexemeIndex++] = *current;
-                 }
-                 
-                 current++;
-                 column++;
-             }
-             
-             if (*current == '\'') {
-                 if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                     lexeme[lexemeIndex++] = *current;
-                 }
-                 current++;
-                 column++;
-             }
-             
-             lexeme[lexemeIndex] = '\0';
-             
-             tokens[tokenCount].type = TOKEN_CHAR;
-             strcpy(tokens[tokenCount].lexeme, lexeme);
-             tokens[tokenCount].line = line;
-             tokens[tokenCount].column = column - lexemeIndex;
-             tokenCount++;
-             
-             continue;
+         long size = -1;
+         if (fseek(file, 0, SEEK_END) == 0) {
+             size = ftell(file);
+             rewind(file);
          }
          
-         // Handle numbers
-         if (isdigit(*current)) {
-             lexemeIndex = 0;
-             
-             while (isdigit(*current) || *current == '.' || *current == 'e' || *current == 'E' ||
-                    *current == 'f' || *current == 'F' || *current == 'l' || *current == 'L' ||
-                    ((*current == '+' || *current == '-') && (*(current - 1) == 'e' || *(current - 1) == 'E'))) {
-                 if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                     lexeme[lexemeIndex++] = *current;
-                 }
-                 current++;
-                 column++;
-             }
-             
-             lexeme[lexemeIndex] = '\0';
-             
-             tokens[tokenCount].type = TOKEN_NUMBER;
-             strcpy(tokens[tokenCount].lexeme, lexeme);
-             tokens[tokenCount].line = line;
-             tokens[tokenCount].column = column - lexemeIndex;
-             tokenCount++;
-             
-             continue;
+         loaded = size >= 0 ? readSourceSized(file, (size_t)size) : readSourceStream(file);
+         fclose(file);
+ #else
+         int fd = open(filename, O_RDONLY);
+         if (fd < 0) {
+             printf("Error: Cannot open file %s\n", filename);
+             exit(1);
          }
          
-         // Handle identifiers and keywords
-         if (isalpha(*current) || *current == '_') {
-             lexemeIndex = 0;
-             
-             while (isalnum(*current) || *current == '_') {
-                 if (lexemeIndex < MAX_IDENTIFIER_LENGTH - 1) {
-                     lexeme[lexemeIndex++] = *current;
+         struct stat info;
+         if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+             loaded = mapSourceFile(fd, (size_t)info.st_size);
+             if (!loaded) {
+                 FILE *file = fdopen(fd, "rb");
+                 if (file) {
+                     loaded = readSourceSized(file, (size_t)info.st_size);
+                     fclose(file);
+                     fd = -1;
                  }
-                 current++;
-                 column++;
              }
-             
-             lexeme[lexemeIndex] = '\0';
-             
-             if (isKeyword(lexeme)) {
-                 tokens[tokenCount].type = TOKEN_KEYWORD;
-             } else {
-                 tokens[tokenCount].type = TOKEN_IDENTIFIER;
+         } else {
+             FILE *file = fdopen(fd, "rb");
+             if (file) {
+                 loaded = readSourceStream(file);
+                 fclose(file);
+                 fd = -1;
              }
-             
-             strcpy(tokens[tokenCount].lexeme, lexeme);
-             tokens[tokenCount].line = line;
-             tokens[tokenCount].column = column - lexemeIndex;
-             tokenCount++;
-             
-             continue;
          }
          
-         // Handle operators and separators
-         if (strchr("+-*/%%=<>!&|^~?:.,;()[]{}", *current)) {
-             // Handle multi-character operators
-             if ((*current == '+' && *(current + 1) == '+') ||
-                 (*current == '-' && *(current + 1) == '-') ||
-                 (*current == '=' && *(current + 1) == '=') ||
-                 (*current == '!' && *(current + 1) == '=') ||
-                 (*current == '<' && *(current + 1) == '=') ||
-                 (*current == '>' && *(current + 1) == '=') ||
-                 (*current == '&' && *(current + 1) == '&') ||
-                 (*current == '|' && *(current + 1) == '|') ||
-                 (*current == '+' && *(current + 1) == '=') ||
-                 (*current == '-' && *(current + 1) == '=') ||
-                 (*current == '*' && *(current + 1) == '=') ||
-                 (*current == '/' && *(current + 1) == '=') ||
-                 (*current == '%' && *(current + 1) == '=') ||
-                 (*current == '&' && *(current + 1) == '=') ||
-                 (*current == '|' && *(current + 1) == '=') ||
-                 (*current == '^' && *(current + 1) == '=') ||
-                 (*current == '-' && *(current + 1) == '>')) {
-                 
-                 lexeme[0] = *current++;
-                 lexeme[1] = *current++;
-                 lexeme[2] = '\0';
-                 column += 2;
-             } else {
-                 lexeme[0] = *current++;
-                 lexeme[1] = '\0';
-                 column++;
-             }
-             
-             tokens[tokenCount].type = (strchr(".,;()[]{}", lexeme[0])) ? TOKEN_SEPARATOR : TOKEN_OPERATOR;
-             strcpy(tokens[tokenCount].lexeme, lexeme);
-             tokens[tokenCount].line = line;
-             tokens[tokenCount].column = column - strlen(lexeme);
-             tokenCount++;
-             
-             continue;
+         if (fd >= 0) {
+             close(fd);
          }
-         
-         // Skip unrecognized characters
-         current++;
-         column++;
+ #endif
      }
      
-     // Add EOF token
-     tokens[tokenCount].type = TOKEN_EOF;
-     strcpy(tokens[tokenCount].lexeme, "EOF");
-     tokens[tokenCount].line = line;
-     tokens[tokenCount].column = column;
-     tokenCount++;
+     if (!loaded) {
+         printf("Error: Cannot read file %s\n", filename);
+         exit(1);
+     }
+     
+     indexLines();
+     printReport("File read successfully: %s\n", filename);
+ }
+ 
+ /**
+  * Builds the line-start index of the loaded source with one newline scan,
+  * so that nothing after loading has to count lines: a position's line is
+  * found by binary search and the line's text sliced straight out
+  */
+ void indexLines() {
+     lineCount = (int)findNewlines(sourceCode, sourceLength, NULL) + 1;
+     if (lineCapacity < lineCount) {
+         lineStarts = arenaGrow(&analysisArena, lineStarts, lineCapacity * sizeof(lineStarts[0]),
+                                lineCount * sizeof(lineStarts[0]));
+         lineCapacity = lineCount;
+     }
+     lineStarts[0] = 0;
+     findNewlines(sourceCode, sourceLength, lineStarts + 1);
+ }
+ 
+ /**
+  * Releases the buffer created by readSourceFile
+  */
+ void releaseSourceFile() {
+ #ifndef _WIN32
+     if (sourceMappedSize > 0) {
+         munmap(sourceCode, sourceMappedSize);
+     } else
+ #endif
+     {
+         free(sourceCode);
+     }
      
-     printf("Tokenization complete. Found %d tokens.\n", tokenCount);
+     sourceCode = NULL;
+     sourceLength = 0;
+     sourceMappedSize = 0;
  }
  
+ /* Lexer byte classes: the DFA sees every source byte through byteClasses[] */
+ typedef enum {
+     CLASS_END,                // NUL terminator
+     CLASS_OTHER,              // Any byte the language does not use
+     CLASS_SPACE, CLASS_NEWLINE,
+     CLASS_LETTER,             // [A-Za-z_] except the exponent letters below
+     CLASS_EXPONENT,           // e E
+     CLASS_BINARY_EXPONENT,    // p P
+     CLASS_DIGIT,
+     CLASS_DOUBLE_QUOTE, CLASS_SINGLE_QUOTE, CLASS_BACKSLASH, CLASS_HASH,
+     CLASS_DOT, CLASS_SLASH, CLASS_STAR, CLASS_PLUS, CLASS_MINUS, CLASS_PERCENT, CLASS_ASSIGN,
+     CLASS_LESS, CLASS_GREATER, CLASS_NOT, CLASS_AMPERSAND, CLASS_PIPE, CLASS_CARET,
+     CLASS_TILDE, CLASS_QUESTION, CLASS_COLON, CLASS_COMMA, CLASS_SEMICOLON,
+     CLASS_LPAREN, CLASS_RPAREN, CLASS_LBRACKET, CLASS_RBRACKET, CLASS_LBRACE, CLASS_RBRACE,
+     CLASS_COUNT
+ } CharClass;
+ 
+ /* Lexer states. Each punctuator has its own accepting state, LEX_PUNCTUATOR + kind. */
+ enum {
+     LEX_STOP,                 // No transition: the current token ends here
+     LEX_START,
+     LEX_WHITESPACE,
+     LEX_UNKNOWN,
+     LEX_LINE_COMMENT,
+     LEX_BLOCK_COMMENT,
+     LEX_BLOCK_COMMENT_STAR,
+     LEX_BLOCK_COMMENT_END,
+     LEX_DIRECTIVE,
+     LEX_STRING,
+     LEX_STRING_ESCAPE,
+     LEX_STRING_END,
+     LEX_CHAR,
+     LEX_CHAR_ESCAPE,
+     LEX_CHAR_END,
+     LEX_IDENTIFIER,
+     LEX_NUMBER,
+     LEX_NUMBER_EXPONENT,
+     LEX_DOT_DOT,              // ".." is not a token: the lexer backs up to "."
+     LEX_PUNCTUATOR,
+     LEX_STATE_COUNT = LEX_PUNCTUATOR + KIND_AUTO
+ };
+ 
+ #define PUNCTUATOR_STATE(kind) (LEX_PUNCTUATOR + (kind))
+ #define LEX_SKIPPED 0xFF      // lexStateTypes[] entry for states that produce no token
  
+ static unsigned char byteClasses[256];
+ static unsigned char lexTransitions[LEX_STATE_COUNT][CLASS_COUNT];
+ static unsigned char lexTable[LEX_STATE_COUNT][256];    // lexTransitions indexed by byte
+ static unsigned char lexStateTypes[LEX_STATE_COUNT];
+ static unsigned char lexStateKinds[LEX_STATE_COUNT];
+ static bool lexTablesReady = false;
  
  /**
-  * Runs all analysis passes on the code
+  * Sets the transition out of a state on every byte class except the terminator
   */
- void analyzeCode() {
-     checkBalancedDelimiters();
-     checkMissingSemicolons();
-     checkUnmatchedQuotes();
-     identifyFunctions();
-     trackVariables();
-     calculateMemoryUsage();
-     identifyKeywords();
-     checkPrintfErrors();
-     checkScanfErrors();
-     checkHeaderFileErrors();
-     checkIncludePlacement();
-     checkKeywordCaseSensitivity();
-     checkStandardFunctionSpelling();
-     checkIncludeDirectiveFormat();
-     validateMainFunction();
+ static void lexOnAny(int state, int next) {
+     for (int charClass = CLASS_END + 1; charClass < CLASS_COUNT; charClass++) {
+         lexTransitions[state][charClass] = next;
+     }
  }
  
- void validateMainFunction() {
-    printf("Validating the 'main' function...\n");
-
-    bool mainFound = false;
-
-    for (int i = 0; i < functionCount; i++) {
-        // Check if the function name is "main"
-        if (strcmp(functions[i].name, "main") == 0) {
-            mainFound = true;
-        } else if (strcasecmp(functions[i].name, "main") == 0) {
-            // Case-insensitive match but incorrect case
-            reportError("Case sensitivity error: 'main' function must be lowercase", functions[i].line, 0);
-        }
-    }
-
-    if (!mainFound) {
-        reportError("No 'main' function found in the program", 0, 0);
-    }
-}
  /**
-  * Checks for balanced delimiters (parentheses, braces, brackets)
+  * Adds the transition for a punctuator character and makes its state accepting
   */
- void checkBalancedDelimiters() {
-     char stack[MAX_STACK_SIZE];
-     int stackTop = -1;
-     int positions[MAX_STACK_SIZE];
-     int lines[MAX_STACK_SIZE];
-     int columns[MAX_STACK_SIZE];
+ static void lexPunctuator(int state, char c, TokenKind kind) {
+     int next = PUNCTUATOR_STATE(kind);
      
-     printf("Checking for balanced delimiters...\n");
+     lexTransitions[state][byteClasses[(unsigned char)c]] = next;
+     lexStateTypes[next] = kind <= KIND_ELLIPSIS ? TOKEN_SEPARATOR : TOKEN_OPERATOR;
+     lexStateKinds[next] = kind;
+ }
+ 
+ /**
+  * Builds the byte-class and transition tables used by lexSource
+  */
+ static void initLexerTables() {
+     const char *spaces = " \t\v\f\r";
+     const char *punctuators = "\"'\\#./*+-%=<>!&|^~?:,;()[]{}";
      
-     for (int i = 0; i < tokenCount; i++) {
-         if (tokens[i].type == TOKEN_SEPARATOR) {
-             if (strcmp(tokens[i].lexeme, "(") == 0 || 
-                 strcmp(tokens[i].lexeme, "{") == 0 || 
-                 strcmp(tokens[i].lexeme, "[") == 0) {
-                 
-                 if (stackTop >= MAX_STACK_SIZE - 1) {
-                     printf("Stack overflow during delimiter checking\n");
-                     return;
-                 }
-                 
-                 // Push onto stack
-                 stack[++stackTop] = tokens[i].lexeme[0];
-                 positions[stackTop] = i;
-                 lines[stackTop] = tokens[i].line;
-                 columns[stackTop] = tokens[i].column;
-             } else if (strcmp(tokens[i].lexeme, ")") == 0 || 
-                        strcmp(tokens[i].lexeme, "}") == 0 || 
-                        strcmp(tokens[i].lexeme, "]") == 0) {
-                 
-                 if (stackTop == -1) {
-                     // No matching opening delimiter
-                     char message[MAX_ERROR_MSG_LENGTH];
-                     sprintf(message, "Unmatched closing delimiter '%s'", tokens[i].lexeme);
-                     reportError(message, tokens[i].line, tokens[i].column);
-                     continue;
-                 }
-                 
-                 char expected;
-                 switch (stack[stackTop]) {
-                     case '(': expected = ')'; break;
-                     case '{': expected = '}'; break;
-                     case '[': expected = ']'; break;
-                     default: expected = '\0';
-                 }
-                 
-                 char actual = tokens[i].lexeme[0];
-                 
-                 if (actual != expected) {
-                     // Mismatched delimiter
-                     char message[MAX_ERROR_MSG_LENGTH];
-                     sprintf(message, "Mismatched delimiter: expected '%c' but found '%c'. Opening delimiter at line %d, column %d",
-                             expected, actual, lines[stackTop], columns[stackTop]);
-                     reportError(message, tokens[i].line, tokens[i].column);
+     memset(byteClasses, CLASS_OTHER, sizeof(byteClasses));
+     byteClasses['\0'] = CLASS_END;
+     byteClasses['\n'] = CLASS_NEWLINE;
+     for (const char *c = spaces; *c != '\0'; c++) {
+         byteClasses[(unsigned char)*c] = CLASS_SPACE;
+     }
+     for (int c = 'a'; c <= 'z'; c++) {
+         byteClasses[c] = CLASS_LETTER;
+         byteClasses[toupper(c)] = CLASS_LETTER;
+     }
+     byteClasses['_'] = CLASS_LETTER;
+     byteClasses['e'] = byteClasses['E'] = CLASS_EXPONENT;
+     byteClasses['p'] = byteClasses['P'] = CLASS_BINARY_EXPONENT;
+     for (int c = '0'; c <= '9'; c++) {
+         byteClasses[c] = CLASS_DIGIT;
+     }
+     // Punctuators take consecutive classes in the order of the string above
+     for (int i = 0; punctuators[i] != '\0'; i++) {
+         byteClasses[(unsigned char)punctuators[i]] = CLASS_DOUBLE_QUOTE + i;
+     }
+     
+     memset(lexStateTypes, LEX_SKIPPED, sizeof(lexStateTypes));
+     lexStateTypes[LEX_DIRECTIVE] = TOKEN_PREPROCESSOR;
+     lexStateTypes[LEX_STRING] = lexStateTypes[LEX_STRING_ESCAPE] = lexStateTypes[LEX_STRING_END] = TOKEN_STRING;
+     lexStateTypes[LEX_CHAR] = lexStateTypes[LEX_CHAR_ESCAPE] = lexStateTypes[LEX_CHAR_END] = TOKEN_CHAR;
+     lexStateTypes[LEX_IDENTIFIER] = TOKEN_IDENTIFIER;
+     lexStateTypes[LEX_NUMBER] = lexStateTypes[LEX_NUMBER_EXPONENT] = TOKEN_NUMBER;
+     
+     // Start state: dispatch on the first byte of a token
+     lexOnAny(LEX_START, LEX_UNKNOWN);
+     lexTransitions[LEX_START][CLASS_SPACE] = LEX_WHITESPACE;
+     lexTransitions[LEX_START][CLASS_NEWLINE] = LEX_WHITESPACE;
+     lexTransitions[LEX_START][CLASS_LETTER] = LEX_IDENTIFIER;
+     lexTransitions[LEX_START][CLASS_EXPONENT] = LEX_IDENTIFIER;
+     lexTransitions[LEX_START][CLASS_BINARY_EXPONENT] = LEX_IDENTIFIER;
+     lexTransitions[LEX_START][CLASS_DIGIT] = LEX_NUMBER;
+     lexTransitions[LEX_START][CLASS_DOUBLE_QUOTE] = LEX_STRING;
+     lexTransitions[LEX_START][CLASS_SINGLE_QUOTE] = LEX_CHAR;
+     lexTransitions[LEX_START][CLASS_HASH] = LEX_DIRECTIVE;
+     lexPunctuator(LEX_START, '(', KIND_LPAREN);
+     lexPunctuator(LEX_START, ')', KIND_RPAREN);
+     lexPunctuator(LEX_START, '{', KIND_LBRACE);
+     lexPunctuator(LEX_START, '}', KIND_RBRACE);
+     lexPunctuator(LEX_START, '[', KIND_LBRACKET);
+     lexPunctuator(LEX_START, ']', KIND_RBRACKET);
+     lexPunctuator(LEX_START, ';', KIND_SEMICOLON);
+     lexPunctuator(LEX_START, ',', KIND_COMMA);
+     lexPunctuator(LEX_START, '.', KIND_DOT);
+     lexPunctuator(LEX_START, '+', KIND_PLUS);
+     lexPunctuator(LEX_START, '-', KIND_MINUS);
+     lexPunctuator(LEX_START, '*', KIND_STAR);
+     lexPunctuator(LEX_START, '/', KIND_SLASH);
+     lexPunctuator(LEX_START, '%', KIND_PERCENT);
+     lexPunctuator(LEX_START, '=', KIND_ASSIGN);
+     lexPunctuator(LEX_START, '<', KIND_LESS);
+     lexPunctuator(LEX_START, '>', KIND_GREATER);
+     lexPunctuator(LEX_START, '!', KIND_NOT);
+     lexPunctuator(LEX_START, '&', KIND_AMPERSAND);
+     lexPunctuator(LEX_START, '|', KIND_PIPE);
+     lexPunctuator(LEX_START, '^', KIND_CARET);
+     lexPunctuator(LEX_START, '~', KIND_TILDE);
+     lexPunctuator(LEX_START, '?', KIND_QUESTION);
+     lexPunctuator(LEX_START, ':', KIND_COLON);
+     
+     // Whitespace runs are skipped as a single unit
+     lexTransitions[LEX_WHITESPACE][CLASS_SPACE] = LEX_WHITESPACE;
+     lexTransitions[LEX_WHITESPACE][CLASS_NEWLINE] = LEX_WHITESPACE;
+     
+     // Identifiers and keywords
+     lexTransitions[LEX_IDENTIFIER][CLASS_LETTER] = LEX_IDENTIFIER;
+     lexTransitions[LEX_IDENTIFIER][CLASS_EXPONENT] = LEX_IDENTIFIER;
+     lexTransitions[LEX_IDENTIFIER][CLASS_BINARY_EXPONENT] = LEX_IDENTIFIER;
+     lexTransitions[LEX_IDENTIFIER][CLASS_DIGIT] = LEX_IDENTIFIER;
+     
+     // Preprocessing numbers: digits, letters and dots, with a sign allowed
+     // only straight after an exponent (1e+5, 0x1p-3)
+     for (int state = LEX_NUMBER; state <= LEX_NUMBER_EXPONENT; state++) {
+         lexTransitions[state][CLASS_LETTER] = LEX_NUMBER;
+         lexTransitions[state][CLASS_DIGIT] = LEX_NUMBER;
+         lexTransitions[state][CLASS_DOT] = LEX_NUMBER;
+         lexTransitions[state][CLASS_EXPONENT] = LEX_NUMBER_EXPONENT;
+         lexTransitions[state][CLASS_BINARY_EXPONENT] = LEX_NUMBER_EXPONENT;
+     }
+     lexTransitions[LEX_NUMBER_EXPONENT][CLASS_PLUS] = LEX_NUMBER;
+     lexTransitions[LEX_NUMBER_EXPONENT][CLASS_MINUS] = LEX_NUMBER;
+     
+     // ".5" is a number, "..." an ellipsis, ".." two dots
+     lexTransitions[PUNCTUATOR_STATE(KIND_DOT)][CLASS_DIGIT] = LEX_NUMBER;
+     lexTransitions[PUNCTUATOR_STATE(KIND_DOT)][CLASS_DOT] = LEX_DOT_DOT;
+     lexPunctuator(LEX_DOT_DOT, '.', KIND_ELLIPSIS);
+     
+     // Preprocessor directives span the rest of the line
+     lexOnAny(LEX_DIRECTIVE, LEX_DIRECTIVE);
+     lexTransitions[LEX_DIRECTIVE][CLASS_NEWLINE] = LEX_STOP;
+     
+     // String and character literals; a backslash escapes any following byte
+     lexOnAny(LEX_STRING, LEX_STRING);
+     lexTransitions[LEX_STRING][CLASS_BACKSLASH] = LEX_STRING_ESCAPE;
+     lexTransitions[LEX_STRING][CLASS_DOUBLE_QUOTE] = LEX_STRING_END;
+     lexOnAny(LEX_STRING_ESCAPE, LEX_STRING);
+     lexOnAny(LEX_CHAR, LEX_CHAR);
+     lexTransitions[LEX_CHAR][CLASS_BACKSLASH] = LEX_CHAR_ESCAPE;
+     lexTransitions[LEX_CHAR][CLASS_SINGLE_QUOTE] = LEX_CHAR_END;
+     lexOnAny(LEX_CHAR_ESCAPE, LEX_CHAR);
+     
+     // Comments hang off the '/' operator state
+     lexTransitions[PUNCTUATOR_STATE(KIND_SLASH)][CLASS_SLASH] = LEX_LINE_COMMENT;
+     lexTransitions[PUNCTUATOR_STATE(KIND_SLASH)][CLASS_STAR] = LEX_BLOCK_COMMENT;
+     lexOnAny(LEX_LINE_COMMENT, LEX_LINE_COMMENT);
+     lexTransitions[LEX_LINE_COMMENT][CLASS_NEWLINE] = LEX_STOP;
+     lexOnAny(LEX_BLOCK_COMMENT, LEX_BLOCK_COMMENT);
+     lexTransitions[LEX_BLOCK_COMMENT][CLASS_STAR] = LEX_BLOCK_COMMENT_STAR;
+     lexOnAny(LEX_BLOCK_COMMENT_STAR, LEX_BLOCK_COMMENT);
+     lexTransitions[LEX_BLOCK_COMMENT_STAR][CLASS_STAR] = LEX_BLOCK_COMMENT_STAR;
+     lexTransitions[LEX_BLOCK_COMMENT_STAR][CLASS_SLASH] = LEX_BLOCK_COMMENT_END;
+     
+     // Multi-character operators
+     lexPunctuator(PUNCTUATOR_STATE(KIND_PLUS), '+', KIND_INCREMENT);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_PLUS), '=', KIND_PLUS_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_MINUS), '-', KIND_DECREMENT);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_MINUS), '=', KIND_MINUS_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_MINUS), '>', KIND_ARROW);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_STAR), '=', KIND_STAR_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_SLASH), '=', KIND_SLASH_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_PERCENT), '=', KIND_PERCENT_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_ASSIGN), '=', KIND_EQUAL);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_NOT), '=', KIND_NOT_EQUAL);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_LESS), '=', KIND_LESS_EQUAL);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_LESS), '<', KIND_SHIFT_LEFT);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_SHIFT_LEFT), '=', KIND_SHIFT_LEFT_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_GREATER), '=', KIND_GREATER_EQUAL);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_GREATER), '>', KIND_SHIFT_RIGHT);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_SHIFT_RIGHT), '=', KIND_SHIFT_RIGHT_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_AMPERSAND), '&', KIND_AND);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_AMPERSAND), '=', KIND_AND_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_PIPE), '|', KIND_OR);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_PIPE), '=', KIND_OR_ASSIGN);
+     lexPunctuator(PUNCTUATOR_STATE(KIND_CARET), '=', KIND_XOR_ASSIGN);
+     
+     // Expand the table to one column per byte so the scan loop needs one lookup per byte
+     for (int state = 0; state < LEX_STATE_COUNT; state++) {
+         for (int c = 0; c < 256; c++) {
+             lexTable[state][c] = lexTransitions[state][byteClasses[c]];
+         }
+     }
+     lexTablesReady = true;
+ }
+ 
+ /**
+  * Resizes every token column to hold the given number of tokens
+  */
+ static void reserveTokens(int capacity) {
+     tokenTypes = arenaGrow(&analysisArena, tokenTypes, tokenCapacity, capacity);
+     tokenKinds = arenaGrow(&analysisArena, tokenKinds, tokenCapacity, capacity);
+     tokenOffsets = arenaGrow(&analysisArena, tokenOffsets, tokenCapacity * sizeof(unsigned int), capacity * sizeof(unsigned int));
+     tokenLengths = arenaGrow(&analysisArena, tokenLengths, tokenCapacity * sizeof(unsigned int), capacity * sizeof(unsigned int));
+     tokenSymbols = arenaGrow(&analysisArena, tokenSymbols, tokenCapacity * sizeof(int), capacity * sizeof(int));
+     tokenCapacity = capacity;
+ }
+ 
+ /**
+  * Appends a token viewing sourceCode[start, end)
+  */
+ static void addToken(TokenType type, TokenKind kind, const char *start, const char *end) {
+     if (tokenCount == tokenCapacity) {
+         reserveTokens(tokenCapacity * 2);
+     }
+     
+     tokenTypes[tokenCount] = type;
+     tokenKinds[tokenCount] = kind;
+     tokenOffsets[tokenCount] = (unsigned int)(start - sourceCode);
+     tokenLengths[tokenCount] = (unsigned int)(end - start);
+     tokenSymbols[tokenCount] = -1;
+     tokenCount++;
+ }
+ 
+ /**
+  * Sets up the lexer tables, an empty token stream sized from the input
+  * and the identifier table
+  */
+ static void prepareLexer() {
+     if (!lexTablesReady) {
+         initLexerTables();
+     }
+     
+     // Size the stream from the input: typical C averages well over four
+     // bytes per token and thirty per line; the arrays double if that is short
+     tokenCount = 0;
+     if (tokenCapacity < (int)(sourceLength / 4) + 64) {
+         reserveTokens((int)(sourceLength / 4) + 64);
+     }
+     internInit(&identifierTable, &analysisArena, (int)(sourceLength / 128));
+ }
+ 
+ /**
+  * Runs the DFA from LEX_START over one token at *cursor, moving *cursor
+  * past it. Returns the state it stopped in; LEX_START means only the
+  * terminator was left.
+  */
+ static inline int lexToken(const char **cursor) {
+     const char *current = *cursor;
+     int state = LEX_START;
+     
+     for (;;) {
+         int next = lexTable[state][(unsigned char)*current];
+         
+         if (next == LEX_STOP) {
+             break;
+         }
+         current++;
+         
+         // Whitespace, comment, directive and literal bodies are skipped by
+         // the vector kernels up to the next byte the DFA has to see
+         switch (next) {
+             case LEX_WHITESPACE:
+                 current = skipWhitespace(current);
+                 break;
+             case LEX_LINE_COMMENT:
+             case LEX_DIRECTIVE:
+                 current = skipToLineEnd(current);
+                 break;
+             case LEX_BLOCK_COMMENT:
+                 current = skipCommentBody(current);
+                 break;
+             case LEX_STRING:
+                 current = skipQuotedBody(current, '"');
+                 break;
+             case LEX_CHAR:
+                 current = skipQuotedBody(current, '\'');
+                 break;
+             default: {
+                 // Other states that loop on themselves (identifiers, numbers)
+                 // stay on one table row while they do
+                 const unsigned char *row = lexTable[next];
+                 while (row[(unsigned char)*current] == next) {
+                     current++;
                  }
-                 
-                 // Pop from stack
-                 stackTop--;
+                 break;
              }
          }
+         state = next;
      }
      
-     // Check for unclosed delimiters
-     while (stackTop >= 0) {
-         char message[MAX_ERROR_MSG_LENGTH];
-         sprintf(message, "Unclosed delimiter '%c'", stack[stackTop]);
-         reportError(message, lines[stackTop], columns[stackTop]);
-         stackTop--;
+     if (state == LEX_DOT_DOT) {
+         current--;
+         state = PUNCTUATOR_STATE(KIND_DOT);
      }
+     *cursor = current;
+     return state;
  }
  
- /* Checks for missing semicolons and incorrect use of commas
- */
-void checkMissingSemicolons() {
-    printf("Checking for missing semicolons...\n");
-
-    for (int i = 0; i < tokenCount - 1; i++) {
-        // Skip preprocessor directives and their contents
-        if (tokens[i].type == TOKEN_PREPROCESSOR) {
-            while (i < tokenCount - 1 && tokens[i].line == tokens[i + 1].line) {
-                i++;
-            }
-            continue;
-        }
+ /**
+  * Splits sourceCode into the token stream. Each token
+  * is one run of the DFA from LEX_START until no transition applies; the
+  * state it stops in says what was read. Safe to call again on a new source.
+  */
+ static void lexSource() {
+     const char *current = sourceCode;
+     
+     prepareLexer();
+     
+     for (;;) {
+         const char *start = current;
+         int state = lexToken(&current);
+         
+         if (state == LEX_START) {
+             break;  // Only the terminator is left
+         }
+         if (lexStateTypes[state] == LEX_SKIPPED) {
+             continue;
+         }
+         
+         if (state == LEX_IDENTIFIER) {
+             int keyword = lookupKeyword(start, (int)(current - start));
+             if (keyword >= 0) {
+                 addToken(TOKEN_KEYWORD, KIND_AUTO + keyword, start, current);
+                 continue;
+             }
+             addToken(TOKEN_IDENTIFIER, KIND_NONE, start, current);
+             tokenSymbols[tokenCount - 1] = internName(&identifierTable, start, (int)(current - start));
+             continue;
+         }
+         
+         addToken(lexStateTypes[state], lexStateKinds[state], start, current);
+     }
+     
+     // Add EOF token (an empty view at the end of the source)
+     addToken(TOKEN_EOF, KIND_NONE, current, current);
+ }
+ 
+ /* One slice of the source for lexSourceInParallel(), lexed into its own
+  * columns on the guess that it starts on a token boundary */
+ typedef struct {
+     const char *start;      // Where lexing starts: a guess until fixed up
+     const char *limit;      // Tokens starting here or later belong to the next chunk
+     const char *end;        // Where lexing stopped: the next chunk's true start
+     bool hitTerminator;     // Stopped at a NUL byte, which ends the token stream
+     Arena arena;            // Holds the columns below
+     unsigned char *types;
+     unsigned char *kinds;
+     unsigned int *offsets;
+     unsigned int *lengths;
+     unsigned int *hashes;   // internHash() of each identifier's name
+     int count;
+     int capacity;
+ } LexChunk;
+ 
+ /**
+  * Resizes a chunk's token columns to hold the given number of tokens
+  */
+ static void reserveChunkTokens(LexChunk *chunk, int capacity) {
+     chunk->types = arenaGrow(&chunk->arena, chunk->types, chunk->capacity, capacity);
+     chunk->kinds = arenaGrow(&chunk->arena, chunk->kinds, chunk->capacity, capacity);
+     chunk->offsets = arenaGrow(&chunk->arena, chunk->offsets, chunk->capacity * sizeof(unsigned int), capacity * sizeof(unsigned int));
+     chunk->lengths = arenaGrow(&chunk->arena, chunk->lengths, chunk->capacity * sizeof(unsigned int), capacity * sizeof(unsigned int));
+     chunk->hashes = arenaGrow(&chunk->arena, chunk->hashes, chunk->capacity * sizeof(unsigned int), capacity * sizeof(unsigned int));
+     chunk->capacity = capacity;
+ }
+ 
+ /**
+  * Lexes a chunk from its start up to the first token starting at or past
+  * its limit. Identifiers are only hashed here; they are interned in order
+  * when the chunks are stitched together.
+  */
+ static void lexChunk(LexChunk *chunk) {
+     const char *current = chunk->start;
+     
+     chunk->count = 0;
+     chunk->hitTerminator = false;
+     if (chunk->capacity == 0) {
+         reserveChunkTokens(chunk, (int)((chunk->limit - chunk->start) / 4) + 64);
+     }
+     
+     while (current < chunk->limit) {
+         const char *start = current;
+         int state = lexToken(&current);
+         
+         if (state == LEX_START) {
+             chunk->hitTerminator = true;
+             break;
+         }
+         if (lexStateTypes[state] == LEX_SKIPPED) {
+             continue;
+         }
+         
+         if (chunk->count == chunk->capacity) {
+             reserveChunkTokens(chunk, chunk->capacity * 2);
+         }
+         int n = chunk->count++;
+         chunk->types[n] = lexStateTypes[state];
+         chunk->kinds[n] = lexStateKinds[state];
+         chunk->offsets[n] = (unsigned int)(start - sourceCode);
+         chunk->lengths[n] = (unsigned int)(current - start);
+         chunk->hashes[n] = 0;
+         
+         if (state == LEX_IDENTIFIER) {
+             int keyword = lookupKeyword(start, (int)(current - start));
+             if (keyword >= 0) {
+                 chunk->types[n] = TOKEN_KEYWORD;
+                 chunk->kinds[n] = KIND_AUTO + keyword;
+             } else {
+                 chunk->types[n] = TOKEN_IDENTIFIER;
+                 chunk->kinds[n] = KIND_NONE;
+                 chunk->hashes[n] = internHash(start, (int)(current - start));
+             }
+         }
+     }
+     
+     chunk->end = current;
+ }
+ 
+ /**
+  * Pool task: lexes one chunk speculatively
+  */
+ static void runLexChunk(void *argument) {
+     lexChunk(argument);
+ }
+ 
+ /**
+  * Parallel version of lexSource() for large inputs, with the same result.
+  * The source is cut at line starts into chunks that are lexed at once, each
+  * assuming it does not begin inside a comment, literal or directive. A
+  * sequential fix-up then walks the chunks in order: a chunk whose start is
+  * not where the previous one stopped guessed wrong and is lexed again from
+  * there. Identifiers are interned in order so IDs match lexSource().
+  */
+ static void lexSourceInParallel(int jobs) {
+     int chunkCount = jobs * LEX_CHUNKS_PER_THREAD;
+     LexChunk *chunks;
+     
+     prepareLexer();
+     
+     if ((size_t)chunkCount > sourceLength / LEX_MIN_CHUNK_BYTES) {
+         chunkCount = (int)(sourceLength / LEX_MIN_CHUNK_BYTES);
+     }
+     if (chunkCount < 1) {
+         chunkCount = 1;
+     }
+     chunks = arenaAlloc(&analysisArena, chunkCount * sizeof(LexChunk));
+     memset(chunks, 0, chunkCount * sizeof(LexChunk));
+     
+     // Cut at the first line start past each target offset whose first byte
+     // the DFA does not take as whitespace, so a whitespace run never
+     // straddles a cut. Lines are ordered, so one forward search does it.
+     int cuts = 0;
+     int lineIndex = 0;
+     chunks[0].start = sourceCode;
+     for (int c = 1; c < chunkCount; c++) {
+         size_t target = sourceLength / chunkCount * c;
+         
+         while (lineIndex < lineCount &&
+                (lineStarts[lineIndex] < target ||
+                 lexTable[LEX_START][(unsigned char)sourceCode[lineStarts[lineIndex]]] == LEX_WHITESPACE ||
+                 sourceCode[lineStarts[lineIndex]] == '\0')) {
+             lineIndex++;
+         }
+         if (lineIndex == lineCount) {
+             break;
+         }
+         chunks[cuts].limit = sourceCode + lineStarts[lineIndex];
+         chunks[++cuts].start = sourceCode + lineStarts[lineIndex];
+     }
+     chunks[cuts].limit = sourceCode + sourceLength;
+     chunkCount = cuts + 1;
+     
+     ThreadPool *pool = threadPoolCreate(jobs);
+     for (int c = 0; c < chunkCount; c++) {
+         threadPoolSubmit(pool, runLexChunk, &chunks[c]);
+     }
+     threadPoolWait(pool);
+     threadPoolDestroy(pool);
+     
+     const char *expected = sourceCode;
+     for (int c = 0; c < chunkCount; c++) {
+         LexChunk *chunk = &chunks[c];
+         
+         if (chunk->start != expected) {
+             // The previous chunk's last token ran past the cut: lex again from its end
+             chunk->start = expected;
+             if (expected < chunk->limit) {
+                 lexChunk(chunk);
+             } else {
+                 chunk->count = 0;
+                 chunk->hitTerminator = false;
+                 chunk->end = expected;
+             }
+         }
+         
+         if (tokenCount + chunk->count + 1 > tokenCapacity) {
+             reserveTokens(tokenCount + chunk->count + 1);
+         }
+         memcpy(tokenTypes + tokenCount, chunk->types, chunk->count);
+         memcpy(tokenKinds + tokenCount, chunk->kinds, chunk->count);
+         memcpy(tokenOffsets + tokenCount, chunk->offsets, chunk->count * sizeof(unsigned int));
+         memcpy(tokenLengths + tokenCount, chunk->lengths, chunk->count * sizeof(unsigned int));
+         for (int t = 0; t < chunk->count; t++) {
+             tokenSymbols[tokenCount] = chunk->types[t] == TOKEN_IDENTIFIER
+                 ? internHashedName(&identifierTable, tokenText(tokenCount), (int)chunk->lengths[t], chunk->hashes[t])
+                 : -1;
+             tokenCount++;
+         }
+         
+         expected = chunk->end;
+         arenaFree(&chunk->arena);
+         
+         if (chunk->hitTerminator) {
+             // Nothing after a NUL byte is lexed
+             for (int rest = c + 1; rest < chunkCount; rest++) {
+                 arenaFree(&chunks[rest].arena);
+             }
+             break;
+         }
+     }
+     
+     // Add EOF token (an empty view at the end of the source)
+     addToken(TOKEN_EOF, KIND_NONE, expected, expected);
+ }
+ 
+ /**
+  * Tokenizes the source code
+  */
+ void tokenize() {
+     int jobs = analysisJobs > 0 ? analysisJobs : threadPoolDefaultSize();
+     
+     if (jobs > 1 && sourceLength >= PARALLEL_LEX_MIN_BYTES) {
+         lexSourceInParallel(jobs);
+     } else {
+         lexSource();
+     }
+     
+     printReport("Tokenization complete. Found %d tokens.\n", tokenCount);
+ }
+ 
+ /**
+  * Returns a pointer to the first character of a token's lexeme
+  */
+ const char *tokenText(int index) {
+     return sourceCode + tokenOffsets[index];
+ }
+ 
+ /**
+  * Returns the 1-based line holding a source offset, by binary search of
+  * the line-start index
+  */
+ int offsetLine(unsigned int offset) {
+     int low = 0, high = lineCount - 1;
+     
+     // Find the last line starting at or before the offset
+     while (low < high) {
+         int middle = low + (high - low + 1) / 2;
+         if (lineStarts[middle] <= offset) {
+             low = middle;
+         } else {
+             high = middle - 1;
+         }
+     }
+     return low + 1;
+ }
+ 
+ /**
+  * Returns the 1-based line of a token's first character
+  */
+ int tokenLine(int index) {
+     return offsetLine(tokenOffsets[index]);
+ }
+ 
+ /**
+  * Returns the 1-based column of a token, derived from the line-start index
+  */
+ int tokenColumn(int index) {
+     return (int)(tokenOffsets[index] - lineStarts[tokenLine(index) - 1]) + 1;
+ }
+ 
+ /**
+  * Returns the offset just past a token's text, before any line break it
+  * ends with (an unterminated literal runs on to the end of the file), so
+  * a position after the token stays on its last line
+  */
+ int tokenEndOffset(int index) {
+     int end = tokenOffsets[index] + tokenLengths[index];
+     while (end > tokenOffsets[index] && (sourceCode[end - 1] == '\n' || sourceCode[end - 1] == '\r')) {
+         end--;
+     }
+     return end;
+ }
+ 
+ /**
+  * Checks whether the next token starts on a later line than this one,
+  * by looking for a newline in this token or the gap after it
+  */
+ bool lineBreakAfter(int index) {
+     return memchr(sourceCode + tokenOffsets[index], '\n', tokenOffsets[index + 1] - tokenOffsets[index]) != NULL;
+ }
+ 
+ /**
+  * Checks whether a token's lexeme is exactly the given text
+  */
+ bool tokenIs(int index, const char *text) {
+     size_t length = tokenLengths[index];
+     return strncmp(tokenText(index), text, length) == 0 && text[length] == '\0';
+ }
+ 
+ /**
+  * Copies a token's lexeme into a NUL-terminated buffer, truncating if needed
+  */
+ void copyTokenText(int index, char *buffer, size_t size) {
+     size_t length = tokenLengths[index] < size - 1 ? tokenLengths[index] : size - 1;
+     memcpy(buffer, tokenText(index), length);
+     buffer[length] = '\0';
+ }
+ 
+ /**
+  * Renders a preprocessor token in normalized form: '#', the directive name
+  * and the rest of the line, with the whitespace between them removed
+  * (e.g. "#  include <stdio.h>" becomes "#include<stdio.h>").
+  * The buffer must hold MAX_IDENTIFIER_LENGTH characters. Returns the length.
+  */
+ int directiveText(int index, char *buffer) {
+     const char *current = tokenText(index);
+     const char *end = current + tokenLengths[index];
+     int length = 0;
+     
+     buffer[length++] = *current++;
+     
+     while (current < end && isspace(*current)) {
+         current++;
+     }
+     while (current < end && !isspace(*current)) {
+         if (length < MAX_IDENTIFIER_LENGTH - 1) {
+             buffer[length++] = *current;
+         }
+         current++;
+     }
+     while (current < end && isspace(*current)) {
+         current++;
+     }
+     while (current < end) {
+         if (length < MAX_IDENTIFIER_LENGTH - 1) {
+             buffer[length++] = *current;
+         }
+         current++;
+     }
+     
+     buffer[length] = '\0';
+     return length;
+ }
+
+ /**
+  * Returns the name of a preprocessor token's directive as written, after
+  * the '#' and any spaces, with its length in *length
+  */
+ const char *directiveName(int index, int *length) {
+     const char *name = tokenText(index) + 1;
+     const char *end = tokenText(index) + tokenLengths[index];
+     
+     while (name < end && (*name == ' ' || *name == '\t')) {
+         name++;
+     }
+     *length = 0;
+     while (name + *length < end && (isalnum((unsigned char)name[*length]) || name[*length] == '_')) {
+         (*length)++;
+     }
+     return name;
+ }
+ 
+ /**
+  * Checks whether a header name is a standard header's without its ".h"
+  */
+ bool isHeaderWithoutExtension(const char *name, int length) {
+     char withExtension[MAX_IDENTIFIER_LENGTH];
+     
+     if (memchr(name, '.', length) != NULL || length + 3 > MAX_IDENTIFIER_LENGTH) {
+         return false;
+     }
+     memcpy(withExtension, name, length);
+     memcpy(withExtension + length, ".h", 3);
+     return fuzzyMatch(&headerDictionary, withExtension, length + 2, 0).exact;
+ }
+ 
+ 
+ 
+ /**
+  * Records in delimiterMatches the token closing each '(' and '{', counting
+  * only delimiters of the same kind, so passes need not walk to find it
+  */
+ static void matchDelimiters() {
+     int *parens = NULL;
+     int *braces = NULL;
+     int parenCapacity = 0, braceCapacity = 0;
+     int parenTop = 0, braceTop = 0;
+     
+     delimiterMatches = arenaAlloc(&analysisArena, (size_t)tokenCount * sizeof(int));
+     
+     for (int i = 0; i < tokenCount; i++) {
+         delimiterMatches[i] = tokenCount;
+         
+         switch (tokenKinds[i]) {
+             case KIND_LPAREN:
+                 parens = arenaGrowArray(&analysisArena, parens, parenTop, &parenCapacity, sizeof(parens[0]));
+                 parens[parenTop++] = i;
+                 break;
+             case KIND_RPAREN:
+                 if (parenTop > 0) {
+                     delimiterMatches[parens[--parenTop]] = i;
+                 }
+                 break;
+             case KIND_LBRACE:
+                 braces = arenaGrowArray(&analysisArena, braces, braceTop, &braceCapacity, sizeof(braces[0]));
+                 braces[braceTop++] = i;
+                 break;
+             case KIND_RBRACE:
+                 if (braceTop > 0) {
+                     delimiterMatches[braces[--braceTop]] = i;
+                 }
+                 break;
+             default:
+                 break;
+         }
+     }
+ }
+ 
+ /**
+  * Returns the index just past the token closing the '(' or '{' at index,
+  * or tokenCount if it is never closed
+  */
+ static int skipDelimited(int index) {
+     int close = delimiterMatches[index];
+     return close < tokenCount ? close + 1 : tokenCount;
+ }
+ 
+ /**
+  * Records every call site with its argument ranges, and chains the sites of
+  * each name, in one scan, so the passes about calls visit only their own
+  */
+ static void indexCallSites() {
+     int *lastCallSite = arenaAlloc(&analysisArena, ((size_t)identifierTable.count + 1) * sizeof(int));
+     
+     firstCallSite = arenaAlloc(&analysisArena, ((size_t)identifierTable.count + 1) * sizeof(int));
+     for (int id = 0; id < identifierTable.count; id++) {
+         firstCallSite[id] = -1;
+         lastCallSite[id] = -1;
+     }
+     
+     for (int i = 0; i + 1 < tokenCount; i++) {
+         if (tokenTypes[i] != TOKEN_IDENTIFIER || tokenKinds[i+1] != KIND_LPAREN) {
+             continue;
+         }
+         
+         callSites = arenaGrowArray(&analysisArena, callSites, callSiteCount, &callSiteCapacity, sizeof(CallSite));
+         CallSite *site = &callSites[callSiteCount];
+         site->token = i;
+         site->nextCall = -1;
+         site->firstArgument = callArgumentCount;
+         site->argumentCount = 0;
+         
+         // Split the arguments at the commas outside nested '(' and '{'
+         int close = delimiterMatches[i + 1];
+         int from = i + 2;
+         int j = from;
+         while (j < close) {
+             if (tokenKinds[j] == KIND_LPAREN || tokenKinds[j] == KIND_LBRACE) {
+                 j = skipDelimited(j);
+                 continue;
+             }
+             if (tokenKinds[j] == KIND_COMMA) {
+                 callArguments = arenaGrowArray(&analysisArena, callArguments, callArgumentCount, &callArgumentCapacity, sizeof(ArgumentRange));
+                 callArguments[callArgumentCount++] = (ArgumentRange){from, j};
+                 site->argumentCount++;
+                 from = j + 1;
+             }
+             j++;
+         }
+         if (from < close || site->argumentCount > 0) {
+             callArguments = arenaGrowArray(&analysisArena, callArguments, callArgumentCount, &callArgumentCapacity, sizeof(ArgumentRange));
+             callArguments[callArgumentCount++] = (ArgumentRange){from, close};
+             site->argumentCount++;
+         }
+         
+         int id = tokenSymbols[i];
+         if (lastCallSite[id] < 0) {
+             firstCallSite[id] = callSiteCount;
+         } else {
+             callSites[lastCallSite[id]].nextCall = callSiteCount;
+         }
+         lastCallSite[id] = callSiteCount;
+         callSiteCount++;
+     }
+ }
+ 
+ /**
+  * Notes the role of the identifier each node names, and the declaration
+  * each type begins
+  */
+ static void markNames() {
+     for (int node = 0; node < syntaxTree.count; node++) {
+         const Node *n = &syntaxTree.nodes[node];
+         int role = NAME_USE;
+         
+         switch (n->kind) {
+             case NODE_DECLARATOR:
+             case NODE_ENUMERATOR: role = NAME_DECLARED; break;
+             case NODE_TYPE_NAME: role = NAME_TYPE; break;
+             case NODE_RECORD: role = NAME_TAG; break;
+             case NODE_LABEL:
+             case NODE_GOTO: role = NAME_LABEL; break;
+             case NODE_MEMBER: role = NAME_MEMBER; break;
+             case NODE_DECLARATION:
+                 if (n->token >= 0) {
+                     declarationNodes[n->token] = node;
+                 }
+                 break;
+             default: break;
+         }
+         if (role != NAME_USE && n->token >= 0 && tokenTypes[n->token] == TOKEN_IDENTIFIER) {
+             nameRoles[n->token] = (unsigned char)role;
+         }
+     }
+ }
+ 
+ /**
+  * Parses the token stream into syntaxTree, for the passes that need to
+  * know what a name is rather than guess it from the tokens around it
+  */
+ static void buildSyntaxTree() {
+     ParseInput input = {tokenTypes, tokenKinds, tokenSymbols, identifierTable.count, tokenCount};
+     
+     parseTokens(&input, &analysisArena, &syntaxTree);
+     nameRoles = arenaAlloc(&analysisArena, (size_t)tokenCount);
+     memset(nameRoles, NAME_USE, (size_t)tokenCount);
+     declarationNodes = arenaAlloc(&analysisArena, (size_t)tokenCount * sizeof(int));
+     memset(declarationNodes, 0xff, (size_t)tokenCount * sizeof(int));
+     markNames();
+ }
+ 
+ /**
+  * Returns the call site whose name is the token at index, or NULL
+  */
+ static const CallSite *findCallSite(int index) {
+     int low = 0, high = callSiteCount - 1;
+     
+     while (low <= high) {
+         int middle = low + (high - low) / 2;
+         if (callSites[middle].token == index) {
+             return &callSites[middle];
+         } else if (callSites[middle].token < index) {
+             low = middle + 1;
+         } else {
+             high = middle - 1;
+         }
+     }
+     return NULL;
+ }
+ 
+ /**
+  * Moves the walk context past the token at index
+  */
+ static void advanceContext(PassContext *context, int index, int mainId) {
+     switch (tokenKinds[index]) {
+         case KIND_LBRACE: context->braceDepth++; break;
+         case KIND_RBRACE: context->braceDepth--; break;
+         case KIND_LPAREN: context->parenDepth++; break;
+         case KIND_RPAREN: context->parenDepth--; break;
+         default: break;
+     }
+     if (tokenTypes[index] == TOKEN_IDENTIFIER && tokenSymbols[index] == mainId) {
+         context->afterMain = true;
+     }
+ }
+ 
+ /**
+  * Counts a token handed to a pass's visit(), for --profile
+  */
+ static inline void countVisit(Pass *pass, int index) {
+     pass->visited++;
+     pass->visitedBytes += tokenLengths[index];
+ }
+ 
+ /**
+  * Hands each token in [from, to) to the passes that asked for its type,
+  * carrying on from context, the walk's state just before from
+  */
+ static void walkRange(Pass **passes, int passCount, int from, int to, PassContext context) {
+     Pass *dispatch[TOKEN_TYPE_COUNT][MAX_PASSES];
+     int dispatchCount[TOKEN_TYPE_COUNT] = {0};
+     int visitors = 0;
+     int mainId = internFind(&identifierTable, "main", 4);
+     
+     for (int p = 0; p < passCount; p++) {
+         for (int type = 0; type < TOKEN_TYPE_COUNT && passes[p]->visit && !passes[p]->callsOnly; type++) {
+             if (passes[p]->tokenMask & TOKEN_MASK(type)) {
+                 dispatch[type][dispatchCount[type]++] = passes[p];
+                 visitors++;
+             }
+         }
+     }
+     
+     for (int i = from; i < to && visitors > 0; i++) {
+         int type = tokenTypes[i];
+         
+         advanceContext(&context, i, mainId);
+         for (int p = 0; p < dispatchCount[type]; p++) {
+             Pass *pass = dispatch[type][p];
+             if (i >= pass->resumeAt) {
+                 currentPass = pass;
+                 countVisit(pass, i);
+                 pass->visit(pass, i, &context);
+             }
+         }
+     }
+     currentPass = NULL;
+ }
+ 
+ /* The pool running the passes, and one arena per worker for what they allocate */
+ static ThreadPool *passPool = NULL;
+ static Arena *workerArenas = NULL;
+ 
+ /**
+  * Returns the arena for allocations of a task on the calling thread
+  */
+ static Arena *taskArena() {
+     int worker = passPool ? threadPoolWorkerIndex(passPool) : -1;
+     return worker >= 0 ? &workerArenas[worker] : &analysisArena;
+ }
+ 
+ /**
+  * Hands a callsOnly pass its call sites, and the tokens named as it asks
+  */
+ static void visitCallSites(Pass *pass) {
+     bool *alsoNamed = NULL;
+     bool anyNamed = false;
+     int callee = pass->callee ? internFind(&identifierTable, pass->callee, (int)strlen(pass->callee)) : -1;
+     
+     // Ask about each distinct name once rather than at each occurrence
+     if (pass->alsoVisits) {
+         alsoNamed = arenaAlloc(pass->arena, (size_t)identifierTable.count + 1);
+         for (int id = 0; id < identifierTable.count; id++) {
+             alsoNamed[id] = pass->alsoVisits(identifierTable.texts[id], identifierTable.lengths[id]);
+             anyNamed |= alsoNamed[id];
+         }
+     }
+     
+     currentPass = pass;
+     if (anyNamed) {
+         // Such names are rare: when they do appear, go through the identifiers in order
+         for (int i = 0; i < tokenCount; i++) {
+             if (tokenTypes[i] != TOKEN_IDENTIFIER) {
+                 continue;
+             }
+             bool isCall = i + 1 < tokenCount && tokenKinds[i+1] == KIND_LPAREN &&
+                           (pass->callee == NULL || tokenSymbols[i] == callee);
+             if (isCall || alsoNamed[tokenSymbols[i]]) {
+                 countVisit(pass, i);
+                 pass->visit(pass, i, NULL);
+             }
+         }
+     } else if (pass->callee == NULL) {
+         for (int c = 0; c < callSiteCount; c++) {
+             countVisit(pass, callSites[c].token);
+             pass->visit(pass, callSites[c].token, NULL);
+         }
+     } else if (callee >= 0) {
+         for (int c = firstCallSite[callee]; c >= 0; c = callSites[c].nextCall) {
+             countVisit(pass, callSites[c].token);
+             pass->visit(pass, callSites[c].token, NULL);
+         }
+     }
+     currentPass = NULL;
+ }
+ 
+ /**
+  * Walks the tokens once for the given passes, handing each token only to
+  * the passes that asked for its type, with start and finish around it.
+  * With --profile each pass gets a walk of its own, so its time is its own.
+  */
+ static void walkPasses(Pass **passes, int passCount) {
+     if (profiling && passCount > 1) {
+         for (int p = 0; p < passCount; p++) {
+             walkPasses(&passes[p], 1);
+         }
+         return;
+     }
+     
+     double started = profiling ? profileNow() : 0;
+     for (int p = 0; p < passCount; p++) {
+         Pass *pass = passes[p];
+         
+         currentPass = pass;
+         pass->arena = taskArena();
+         pass->resumeAt = 0;
+         if (pass->start) {
+             pass->start(pass);
+         }
+     }
+     
+     for (int p = 0; p < passCount; p++) {
+         if (passes[p]->callsOnly) {
+             visitCallSites(passes[p]);
+         }
+     }
+     walkRange(passes, passCount, 0, tokenCount, (PassContext){0});
+     
+     for (int p = 0; p < passCount; p++) {
+         if (passes[p]->finish) {
+             currentPass = passes[p];
+             passes[p]->finish(passes[p]);
+         }
+     }
+     currentPass = NULL;
+     if (profiling) {
+         passes[0]->seconds += profileNow() - started;
+     }
+ }
+ 
+ /**
+  * Checks whether pass later must wait for pass earlier, which comes before
+  * it in the table: one produces data the other reads or also produces
+  */
+ static bool passDependsOn(const Pass *later, const Pass *earlier) {
+     return (earlier->writes & (later->reads | later->writes)) != 0 ||
+            (earlier->reads & later->writes) != 0;
+ }
+ 
+ /**
+  * Stores in levels[] one more than the deepest level of the passes each
+  * pass depends on, and returns the number of levels
+  */
+ static int passLevels(const Pass *passes, int passCount, int *levels) {
+     int levelCount = 0;
+     
+     for (int p = 0; p < passCount; p++) {
+         levels[p] = 0;
+         for (int q = 0; q < p; q++) {
+             if (passDependsOn(&passes[p], &passes[q]) && levels[q] + 1 > levels[p]) {
+                 levels[p] = levels[q] + 1;
+             }
+         }
+         if (levels[p] + 1 > levelCount) {
+             levelCount = levels[p] + 1;
+         }
+     }
+     return levelCount;
+ }
+ 
+ /* The table being printed in order as its passes finish, and the next pass
+  * to print. While passes run on the pool, reportLock guards the order and
+  * the output, which whichever thread finishes a pass writes to. */
+ static Pass *reportPasses = NULL;
+ static int reportPassCount = 0;
+ static int nextToReport = 0;
+ static bool reportLocking = false;
+ static pthread_mutex_t reportLock = PTHREAD_MUTEX_INITIALIZER;
+ static double reportingSeconds = 0;    // Time spent printing, summaries aside
+ 
+ /**
+  * Prints each pass whose turn has come, in table order: its banner, the
+  * errors it held back and, once it is done, its summary. The first pass
+  * not yet done is left streaming, printing the rest of its errors as it
+  * reports them.
+  */
+ static void reportFinishedPasses() {
+     double started = profileNow();
+     double summarizing = 0;
+     
+     while (nextToReport < reportPassCount) {
+         Pass *pass = &reportPasses[nextToReport];
+         
+         if (!pass->streaming) {
+             if (pass->banner) {
+                 printReport("%s\n", pass->banner);
+             }
+             for (int e = 0; e < pass->errorCount; e++) {
+                 printError(&pass->errors[e]);
+             }
+             pass->errorCount = 0;
+             pass->streaming = true;
+         }
+         if (!pass->done) {
+             break;
+         }
+         if (pass->summary) {
+             double summaryStarted = profileNow();
+             int before = errorCount;
+             pass->summary();
+             pass->reported += errorCount - before;
+             pass->seconds += profileNow() - summaryStarted;
+             summarizing += profileNow() - summaryStarted;
+         }
+         nextToReport++;
+     }
+     sinkFlush(&output);
+     reportingSeconds += profileNow() - started - summarizing;
+ }
+ 
+ /* The table being run on the pool; scheduleLock guards the waiting counts */
+ static Pass *scheduledPasses = NULL;
+ static int scheduledPassCount = 0;
+ static pthread_mutex_t scheduleLock = PTHREAD_MUTEX_INITIALIZER;
+ 
+ /**
+  * Pool task: runs one pass with its own walk, prints what is ready to be,
+  * then queues the passes that were waiting only for it
+  */
+ static void runScheduledPass(void *argument) {
+     Pass *pass = argument;
+     
+     walkPasses(&pass, 1);
+     
+     pthread_mutex_lock(&reportLock);
+     pass->done = true;
+     reportFinishedPasses();
+     pthread_mutex_unlock(&reportLock);
+     
+     pthread_mutex_lock(&scheduleLock);
+     for (Pass *later = pass + 1; later < scheduledPasses + scheduledPassCount; later++) {
+         if (passDependsOn(later, pass) && --later->waiting == 0) {
+             threadPoolSubmit(passPool, runScheduledPass, later);
+         }
+     }
+     pthread_mutex_unlock(&scheduleLock);
+ }
+ 
+ /* A run of whole top-level definitions, walked as one task by --by-function */
+ typedef struct {
+     int from;               // First token of the run
+     int to;                 // One past its last token
+     PassContext context;    // Walk context just before from
+     Pass *passes;           // The run's copies of the per-function passes
+     int passCount;
+ } FunctionChunk;
+ 
+ /**
+  * Splits the tokens after the closing braces of top-level definitions into
+  * runs of at least CHUNK_MIN_TOKENS tokens, in one scan
+  */
+ static FunctionChunk *splitAtFunctions(int *chunkCount) {
+     FunctionChunk *chunks = NULL;
+     int chunkCapacity = 0;
+     int mainId = internFind(&identifierTable, "main", 4);
+     PassContext context = {0};
+     PassContext startContext = context;
+     int from = 0;
+     
+     *chunkCount = 0;
+     for (int i = 0; i < tokenCount; i++) {
+         advanceContext(&context, i, mainId);
+         
+         bool endsDefinition = tokenKinds[i] == KIND_RBRACE && context.braceDepth == 0;
+         if ((endsDefinition && i + 1 - from >= CHUNK_MIN_TOKENS) || i == tokenCount - 1) {
+             chunks = arenaGrowArray(&analysisArena, chunks, *chunkCount, &chunkCapacity, sizeof(FunctionChunk));
+             chunks[*chunkCount].from = from;
+             chunks[*chunkCount].to = i + 1;
+             chunks[*chunkCount].context = startContext;
+             (*chunkCount)++;
+             from = i + 1;
+             startContext = context;
+         }
+     }
+     return chunks;
+ }
+ 
+ /**
+  * Pool task: walks one run of definitions with its copies of the passes
+  */
+ static void runFunctionChunk(void *argument) {
+     FunctionChunk *chunk = argument;
+     Pass *copies[MAX_PASSES];
+     
+     for (int p = 0; p < chunk->passCount; p++) {
+         copies[p] = &chunk->passes[p];
+         copies[p]->arena = taskArena();
+     }
+     if (!profiling) {
+         walkRange(copies, chunk->passCount, chunk->from, chunk->to, chunk->context);
+         return;
+     }
+     for (int p = 0; p < chunk->passCount; p++) {
+         double started = profileNow();
+         walkRange(&copies[p], 1, chunk->from, chunk->to, chunk->context);
+         copies[p]->seconds = profileNow() - started;
+     }
+ }
+ 
+ /**
+  * Pool task: runs one pass over all the tokens
+  */
+ static void runWholePass(void *argument) {
+     Pass *pass = argument;
+     walkPasses(&pass, 1);
+ }
+ 
+ /**
+  * Runs one dependency level for --by-function: each per-function pass as
+  * copies over every run of definitions, the others whole, all on the pool
+  */
+ static void runLevelByFunction(Pass **group, int groupCount, FunctionChunk *chunks, int chunkCount) {
+     Pass *local[MAX_PASSES];
+     int localCount = 0;
+     
+     for (int p = 0; p < groupCount; p++) {
+         if (group[p]->perFunction && group[p]->visit) {
+             Pass *pass = group[p];
+             
+             local[localCount++] = pass;
+             double started = profileNow();
+             currentPass = pass;
+             pass->arena = &analysisArena;
+             pass->resumeAt = 0;
+             if (pass->start) {
+                 pass->start(pass);
+             }
+             currentPass = NULL;
+             pass->seconds += profileNow() - started;
+         }
+     }
+     
+     // Copies are made after start(), so they see what it set up
+     for (int c = 0; c < chunkCount && localCount > 0; c++) {
+         chunks[c].passes = arenaAlloc(&analysisArena, localCount * sizeof(Pass));
+         chunks[c].passCount = localCount;
+         for (int k = 0; k < localCount; k++) {
+             Pass *copy = &chunks[c].passes[k];
+             
+             *copy = *local[k];
+             copy->resumeAt = chunks[c].from;
+             copy->state = NULL;
+             copy->errors = NULL;
+             copy->errorCount = 0;
+             copy->errorCapacity = 0;
+             copy->visited = 0;
+             copy->visitedBytes = 0;
+             copy->seconds = 0;
+         }
+     }
+     
+     for (int p = 0; p < groupCount; p++) {
+         if (!(group[p]->perFunction && group[p]->visit)) {
+             threadPoolSubmit(passPool, runWholePass, group[p]);
+         }
+     }
+     for (int c = 0; c < chunkCount && localCount > 0; c++) {
+         threadPoolSubmit(passPool, runFunctionChunk, &chunks[c]);
+     }
+     threadPoolWait(passPool);
+     
+     for (int k = 0; k < localCount; k++) {
+         Pass *pass = local[k];
+         bool crossed = false;
+         
+         for (int c = 0; c < chunkCount; c++) {
+             Pass *part = &chunks[c].passes[k];
+             
+             // A skip past the end of its run means the split did not suit the pass
+             if (part->resumeAt > chunks[c].to) {
+                 crossed = true;
+             }
+             for (int e = 0; e < part->errorCount; e++) {
+                 pass->errors = arenaGrowArray(pass->arena, pass->errors, pass->errorCount, &pass->errorCapacity, sizeof(Error));
+                 pass->errors[pass->errorCount++] = part->errors[e];
+             }
+             if (pass->merge) {
+                 pass->merge(pass, part);
+             }
+             pass->visited += part->visited;
+             pass->visitedBytes += part->visitedBytes;
+             pass->seconds += part->seconds;
+         }
+         
+         if (crossed) {
+             // Only unbalanced braces get here: run the pass again over everything
+             pass->errorCount = 0;
+             pass->state = NULL;
+             walkPasses(&pass, 1);
+         } else if (pass->finish) {
+             double started = profileNow();
+             currentPass = pass;
+             pass->finish(pass);
+             currentPass = NULL;
+             pass->seconds += profileNow() - started;
+         }
+     }
+ }
+ 
+ /* An error waiting to be sorted by position, and where it was in table order */
+ typedef struct {
+     const Error *error;
+     int order;
+ } SortedError;
+ 
+ /**
+  * Orders errors by line, then column, then the order they were reported
+  */
+ static int compareErrorPositions(const void *a, const void *b) {
+     const SortedError *firstEntry = a;
+     const SortedError *secondEntry = b;
+     const Error *first = firstEntry->error;
+     const Error *second = secondEntry->error;
+     int firstLine = errorLine(first), secondLine = errorLine(second);
+     int firstColumn = errorColumn(first), secondColumn = errorColumn(second);
+     
+     if (firstLine != secondLine) {
+         return firstLine < secondLine ? -1 : 1;
+     }
+     if (firstColumn != secondColumn) {
+         return firstColumn < secondColumn ? -1 : 1;
+     }
+     return firstEntry->order - secondEntry->order;
+ }
+ 
+ /**
+  * Runs the passes, respecting what each reads and produces. On one thread,
+  * passes whose inputs are ready together share one walk over the tokens;
+  * on several, each pass starts as soon as the passes it depends on finish.
+  * Either way each pass's banner, errors and summary are printed in table
+  * order, so the output does not depend on the schedule; a pass's errors
+  * are printed as soon as the passes before it have been. With
+  * --by-function the per-function passes run on each run of top-level
+  * definitions in parallel, and the banners and summaries come first, then
+  * every error sorted by position, once all the passes are done.
+  */
+ static void runPasses(Pass *passes, int passCount) {
+     int jobs = analysisJobs;
+     int levels[MAX_PASSES];
+     
+     if (jobs <= 0) {
+         // Starting threads only pays off once the walks take a while
+         jobs = tokenCount < PARALLEL_MIN_TOKENS && !splitByFunction ? 1 : threadPoolDefaultSize();
+     }
+     if (passCount > MAX_PASSES) {
+         printf("Error: Too many analysis passes (%d, at most %d)\n", passCount, MAX_PASSES);
+         exit(1);
+     }
+     
+     double started = profileNow();
+     matchDelimiters();
+     profilePhase("matchDelimiters", profileNow() - started, tokenCount, 0, 0);
+     started = profileNow();
+     indexCallSites();
+     profilePhase("indexCallSites", profileNow() - started, tokenCount, 0, 0);
+     started = profileNow();
+     buildSyntaxTree();
+     profilePhase("buildSyntaxTree", profileNow() - started, tokenCount, 0, 0);
+     int levelCount = passLevels(passes, passCount, levels);
+     unsigned long long written = output.bytes;
+     
+     reportPasses = passes;
+     reportPassCount = passCount;
+     nextToReport = 0;
+     reportingSeconds = 0;
+     if (splitByFunction) {
+         int chunkCount;
+         FunctionChunk *chunks = splitAtFunctions(&chunkCount);
+         
+         workerArenas = arenaAlloc(&analysisArena, jobs * sizeof(Arena));
+         memset(workerArenas, 0, jobs * sizeof(Arena));
+         passPool = threadPoolCreate(jobs);
+         for (int level = 0; level < levelCount; level++) {
+             Pass *group[MAX_PASSES];
+             int groupCount = 0;
+             
+             for (int p = 0; p < passCount; p++) {
+                 if (levels[p] == level) {
+                     group[groupCount++] = &passes[p];
+                 }
+             }
+             runLevelByFunction(group, groupCount, chunks, chunkCount);
+         }
+     } else if (jobs == 1) {
+         for (int level = 0; level < levelCount; level++) {
+             Pass *group[MAX_PASSES];
+             int groupCount = 0;
+             
+             for (int p = 0; p < passCount; p++) {
+                 if (levels[p] == level) {
+                     group[groupCount++] = &passes[p];
+                 }
+             }
+             walkPasses(group, groupCount);
+             for (int p = 0; p < groupCount; p++) {
+                 group[p]->done = true;
+             }
+             reportFinishedPasses();
+         }
+     } else {
+         if (jobs > passCount) {
+             jobs = passCount;
+         }
+         scheduledPasses = passes;
+         scheduledPassCount = passCount;
+         workerArenas = arenaAlloc(&analysisArena, jobs * sizeof(Arena));
+         memset(workerArenas, 0, jobs * sizeof(Arena));
+         passPool = threadPoolCreate(jobs);
+         
+         // Count each pass's dependencies before any of them can finish
+         for (int p = 0; p < passCount; p++) {
+             passes[p].waiting = 0;
+             for (int q = 0; q < p; q++) {
+                 if (passDependsOn(&passes[p], &passes[q])) {
+                     passes[p].waiting++;
+                 }
+             }
+         }
+         // Passes' errors may be printed from any thread from now on
+         reportLocking = true;
+         reportFinishedPasses();
+         
+         // Held so that no pass finishing early can release one not yet looked at
+         pthread_mutex_lock(&scheduleLock);
+         for (int p = 0; p < passCount; p++) {
+             if (passes[p].waiting == 0) {
+                 threadPoolSubmit(passPool, runScheduledPass, &passes[p]);
+             }
+         }
+         pthread_mutex_unlock(&scheduleLock);
+         
+         threadPoolWait(passPool);
+         reportLocking = false;
+     }
+     
+     if (passPool) {
+         // What the passes built (functions[], variables[], ...) lives as long as the analysis
+         threadPoolDestroy(passPool);
+         passPool = NULL;
+         for (int w = 0; w < jobs; w++) {
+             arenaAdopt(&analysisArena, &workerArenas[w]);
+         }
+     }
+     
+     if (splitByFunction) {
+         // Sorted by position, so nothing can be printed before every pass is done
+         SortedError *sorted = NULL;
+         int sortedCount = 0, sortedCapacity = 0;
+         double summarizing = 0;
+         
+         started = profileNow();
+         
+         for (int p = 0; p < passCount; p++) {
+             if (passes[p].banner) {
+                 printReport("%s\n", passes[p].banner);
+             }
+             if (passes[p].summary) {
+                 // Held back like the rest, so they are sorted with them
+                 double summaryStarted = profileNow();
+                 currentPass = &passes[p];
+                 passes[p].arena = &analysisArena;
+                 passes[p].summary();
+                 currentPass = NULL;
+                 passes[p].seconds += profileNow() - summaryStarted;
+                 summarizing += profileNow() - summaryStarted;
+             }
+             passes[p].reported = passes[p].errorCount;
+         }
+         for (int p = 0; p < passCount; p++) {
+             for (int e = 0; e < passes[p].errorCount; e++) {
+                 sorted = arenaGrowArray(&analysisArena, sorted, sortedCount, &sortedCapacity, sizeof(sorted[0]));
+                 sorted[sortedCount].error = &passes[p].errors[e];
+                 sorted[sortedCount].order = sortedCount;
+                 sortedCount++;
+             }
+         }
+         if (sortedCount > 0) {
+             qsort(sorted, sortedCount, sizeof(sorted[0]), compareErrorPositions);
+         }
+         for (int e = 0; e < sortedCount; e++) {
+             recordError(sorted[e].error);
+         }
+         reportingSeconds = profileNow() - started - summarizing;
+     }
+     
+     profilePhase("report errors", reportingSeconds, 0, errorCount, output.bytes - written);
+     for (int p = 0; p < passCount; p++) {
+         profilePhase(passes[p].name, passes[p].seconds, passes[p].visited, passes[p].reported, passes[p].visitedBytes);
+     }
+ }
+ 
+ /**
+  * Runs all analysis passes on the code
+  */
+ void analyzeCode() {
+     fuzzyInit(&keywordDictionary, &analysisArena, keywordNames, KEYWORD_COUNT);
+     fuzzyInit(&stdLibDictionary, &analysisArena, stdLibFunctionNames, STDLIB_FUNCTION_COUNT);
+     fuzzyInit(&headerDictionary, &analysisArena, stdHeaders, sizeof(stdHeaders) / sizeof(stdHeaders[0]));
+     fuzzyInit(&directiveDictionary, &analysisArena, directiveNames, sizeof(directiveNames) / sizeof(directiveNames[0]));
+     
+     // Results are printed in this order
+     Pass passes[] = {
+         {.name = "checkBalancedDelimiters", .banner = "Checking for balanced delimiters...",
+          .tokenMask = TOKEN_MASK(TOKEN_SEPARATOR),
+          .start = resetDelimiterStack, .visit = checkBalancedDelimiters, .finish = reportUnclosedDelimiters},
+         {.name = "checkMissingSemicolons", .banner = "Checking for missing semicolons...",
+          .tokenMask = ALL_TOKEN_TYPES, .perFunction = true,
+          .visit = checkMissingSemicolons},
+         {.name = "checkUnmatchedQuotes", .banner = "Checking for unmatched quotes...",
+          .tokenMask = TOKEN_MASK(TOKEN_STRING) | TOKEN_MASK(TOKEN_CHAR),
+          .visit = checkUnmatchedQuotes},
+         {.name = "identifyFunctions", .banner = "Identifying functions...", .writes = PASS_DATA_FUNCTIONS,
+          .callsOnly = true,
+          .start = resetStdLibCalls, .visit = identifyFunctions, .finish = addFunctions},
+         {.name = "trackVariables", .banner = "Tracking variables...", .writes = PASS_DATA_VARIABLES,
+          .tokenMask = TOKEN_MASK(TOKEN_KEYWORD) | TOKEN_MASK(TOKEN_IDENTIFIER), .perFunction = true,
+          .visit = trackVariables, .finish = addTrackedVariables, .merge = mergeTrackedVariables},
+         {.name = "resolveNames", .reads = PASS_DATA_VARIABLES, .writes = PASS_DATA_BINDINGS,
+          .tokenMask = TOKEN_MASK(TOKEN_SEPARATOR) | TOKEN_MASK(TOKEN_IDENTIFIER),
+          .start = startNameResolution, .visit = resolveNames},
+         {.name = "checkUndefinedVariables", .reads = PASS_DATA_FUNCTIONS | PASS_DATA_VARIABLES | PASS_DATA_BINDINGS,
+          .tokenMask = TOKEN_MASK(TOKEN_IDENTIFIER), .perFunction = true,
+          .start = markSymbolRoles, .visit = checkUndefinedVariables},
+         {.name = "calculateMemoryUsage", .banner = "Calculating memory usage...", .reads = PASS_DATA_VARIABLES,
+          .summary = calculateMemoryUsage},
+         {.name = "identifyKeywords", .banner = "Identifying keywords...",
+          .tokenMask = TOKEN_MASK(TOKEN_KEYWORD),
+          .start = resetKeywordCounts, .visit = identifyKeywords, .summary = printKeywordUsage},
+         {.name = "checkPrintfErrors", .banner = "Checking for printf errors...", .reads = PASS_DATA_VARIABLES | PASS_DATA_BINDINGS,
+          .callsOnly = true, .callee = "printf", .alsoVisits = isPrintfCaseVariant,
+          .start = startPrintfFormats, .visit = checkPrintfErrors},
+         {.name = "checkScanfErrors", .banner = "Checking for scanf errors...", .reads = PASS_DATA_VARIABLES | PASS_DATA_BINDINGS,
+          .callsOnly = true, .callee = "scanf", .alsoVisits = isScanfCaseVariant,
+          .start = startScanfFormats, .visit = checkScanfErrors},
+         {.name = "checkHeaderFileErrors", .banner = "Checking for header file errors...",
+          .tokenMask = TOKEN_MASK(TOKEN_PREPROCESSOR),
+          .visit = checkHeaderFileErrors},
+         {.name = "checkIncludePlacement", .banner = "Checking for invalid placement of #include directives...",
+          .tokenMask = TOKEN_MASK(TOKEN_PREPROCESSOR),
+          .visit = checkIncludePlacement},
+         {.name = "checkKeywordCaseSensitivity", .banner = "Checking for keyword case sensitivity errors...",
+          .tokenMask = TOKEN_MASK(TOKEN_IDENTIFIER),
+          .visit = checkKeywordCaseSensitivity},
+         {.name = "checkStandardFunctionSpelling", .banner = "Checking for standard function spelling errors...",
+          .callsOnly = true,
+          .start = startFunctionSpelling, .visit = checkStandardFunctionSpelling},
+         {.name = "checkIncludeDirectiveFormat", .banner = "Checking for include directive format errors...",
+          .tokenMask = TOKEN_MASK(TOKEN_PREPROCESSOR),
+          .visit = checkIncludeDirectiveFormat},
+         {.name = "validateMainFunction", .banner = "Validating the 'main' function...", .reads = PASS_DATA_FUNCTIONS,
+          .summary = validateMainFunction}
+     };
+     
+     runPasses(passes, sizeof(passes) / sizeof(passes[0]));
+ }
+ 
+ void validateMainFunction() {
+    bool mainFound = false;
+    int mainId = internFind(&identifierTable, "main", 4);
 
-        // Skip function declarations/definitions (they don't need semicolons)
-        if (i + 2 < tokenCount &&
-            tokens[i].type == TOKEN_IDENTIFIER &&
-            strcmp(tokens[i + 1].lexeme, "(") == 0) {
-            // Find the matching closing parenthesis
-            int j = i + 2;
-            int parenCount = 1;
+    for (int i = 0; i < functionCount; i++) {
+        // Check if the function name is "main"
+        if (functions[i].nameId == mainId) {
+            mainFound = true;
+        } else if (strcasecmp(functions[i].name, "main") == 0) {
+            // Case-insensitive match but incorrect case
+            reportErrorAt(ERROR_MAIN_CASE, functions[i].token, tokenOffsets[functions[i].token]);
+        }
+    }
 
-            while (j < tokenCount && parenCount > 0) {
-                if (strcmp(tokens[j].lexeme, "(") == 0) parenCount++;
-                if (strcmp(tokens[j].lexeme, ")") == 0) parenCount--;
-                j++;
-            }
+    if (!mainFound) {
+        reportErrorAt(ERROR_NO_MAIN, -1, -1);
+    }
+}
+ /* Token indices of the delimiters checkBalancedDelimiters() has seen open */
+ static int *delimiterStack = NULL;
+ static int delimiterStackCapacity = 0;
+ static int delimiterStackTop = -1;
+ 
+ /**
+  * Empties the open-delimiter stack before a walk
+  */
+ void resetDelimiterStack(Pass *pass) {
+     delimiterStackTop = -1;
+ }
+ 
+ /**
+  * Checks for balanced delimiters (parentheses, braces, brackets)
+  */
+ void checkBalancedDelimiters(Pass *pass, int i, const PassContext *context) {
+     TokenKind kind = tokenKinds[i];
+     
+     if (kind == KIND_LPAREN || kind == KIND_LBRACE || kind == KIND_LBRACKET) {
+         // Push onto stack
+         delimiterStack = arenaGrowArray(pass->arena, delimiterStack, delimiterStackTop + 1,
+                                         &delimiterStackCapacity, sizeof(delimiterStack[0]));
+         delimiterStack[++delimiterStackTop] = i;
+     } else if (kind == KIND_RPAREN || kind == KIND_RBRACE || kind == KIND_RBRACKET) {
+         if (delimiterStackTop == -1) {
+             // No matching opening delimiter
+             reportError(ERROR_UNMATCHED_CLOSING, i);
+             return;
+         }
+         
+         TokenKind expected;
+         switch (tokenKinds[delimiterStack[delimiterStackTop]]) {
+             case KIND_LPAREN: expected = KIND_RPAREN; break;
+             case KIND_LBRACE: expected = KIND_RBRACE; break;
+             default: expected = KIND_RBRACKET; break;
+         }
+         
+         if (kind != expected) {
+             // Mismatched delimiter
+             int open = delimiterStack[delimiterStackTop];
+             reportError(ERROR_MISMATCHED_DELIMITER, i,
+                         *tokenText(open) == '(' ? ')' : *tokenText(open) == '{' ? '}' : ']',
+                         *tokenText(i), open);
+         }
+         
+         // Pop from stack
+         delimiterStackTop--;
+     }
+ }
+ 
+ /**
+  * Reports the delimiters still open at the end of the file
+  */
+ void reportUnclosedDelimiters(Pass *pass) {
+     while (delimiterStackTop >= 0) {
+         int open = delimiterStack[delimiterStackTop];
+         reportError(ERROR_UNCLOSED_DELIMITER, open);
+         delimiterStackTop--;
+     }
+ }
+ 
+ /* Checks for missing semicolons and incorrect use of commas
+ */
+void checkMissingSemicolons(Pass *pass, int i, const PassContext *context) {
+    if (i >= tokenCount - 1) {
+        return;
+    }
 
-            // Check if this is followed by a block (function definition) or semicolon (prototype)
-            if (j < tokenCount && strcmp(tokens[j].lexeme, "{") == 0) {
-                // This is a function definition, skip to the end of the function
-                int braceCount = 1;
-                j++;
+    // Skip preprocessor directives and their contents
+    if (tokenTypes[i] == TOKEN_PREPROCESSOR) {
+        while (i < tokenCount - 1 && !lineBreakAfter(i)) {
+            i++;
+        }
+        pass->resumeAt = i + 1;
+        return;
+    }
 
-                while (j < tokenCount && braceCount > 0) {
-                    if (strcmp(tokens[j].lexeme, "{") == 0) braceCount++;
-                    if (strcmp(tokens[j].lexeme, "}") == 0) braceCount--;
-                    j++;
-                }
+    // Skip function declarations/definitions (they don't need semicolons)
+    if (i + 2 < tokenCount &&
+        tokenTypes[i] == TOKEN_IDENTIFIER &&
+        tokenKinds[i + 1] == KIND_LPAREN) {
+        // Find the matching closing parenthesis
+        int j = skipDelimited(i + 1);
 
-                i = j - 1;
-                continue;
-            }
+        // Check if this is followed by a block (function definition) or semicolon (prototype)
+        if (j < tokenCount && tokenKinds[j] == KIND_LBRACE) {
+            // This is a function definition, skip to the end of the function
+            pass->resumeAt = skipDelimited(j);
+            return;
         }
+    }
 
-        // Check for missing semicolon in variable declarations and function calls
-        if (tokens[i].type == TOKEN_KEYWORD && 
-            (strcmp(tokens[i].lexeme, "float") == 0 || 
-             strcmp(tokens[i].lexeme, "char") == 0 || 
-             
-             strcmp(tokens[i].lexeme, "double") == 0)) {
-            
-            // Check if the next token is an identifier
-            if (i + 1 < tokenCount && tokens[i + 1].type == TOKEN_IDENTIFIER) {
-                // Check if the declaration ends with a semicolon
-                if (i + 2 >= tokenCount || strcmp(tokens[i + 2].lexeme, ";") != 0) {
-                    reportError("Missing semicolon after variable declaration", tokens[i + 1].line, tokens[i + 1].column + strlen(tokens[i + 1].lexeme));
-                }
+    // Check for missing semicolon in variable declarations and function calls
+    if (tokenTypes[i] == TOKEN_KEYWORD && 
+        (tokenKinds[i] == KIND_FLOAT || 
+         tokenKinds[i] == KIND_CHAR || 
+         
+         tokenKinds[i] == KIND_DOUBLE)) {
+        
+        // Check if the next token is an identifier
+        if (i + 1 < tokenCount && tokenTypes[i + 1] == TOKEN_IDENTIFIER) {
+            // Check if the declaration ends with a semicolon
+            if (i + 2 >= tokenCount || tokenKinds[i + 2] != KIND_SEMICOLON) {
+                reportErrorAt(ERROR_DECLARATION_SEMICOLON, i + 1, tokenEndOffset(i + 1));
             }
         }
+    }
 
-        // Check for statements that should end with semicolons
-        if ((tokens[i].type == TOKEN_IDENTIFIER ||
-             tokens[i].type == TOKEN_NUMBER ||
-             strcmp(tokens[i].lexeme, ")") == 0 ||
-             strcmp(tokens[i].lexeme, "]") == 0 ||
-             strcmp(tokens[i].lexeme, "++") == 0 ||
-             strcmp(tokens[i].lexeme, "--") == 0 ||
-             tokens[i].type == TOKEN_STRING ||
-             tokens[i].type == TOKEN_CHAR) &&
-            tokens[i + 1].line > tokens[i].line &&
-            strcmp(tokens[i].lexeme, ";") != 0 &&
-            strcmp(tokens[i].lexeme, "{") != 0 &&
-            strcmp(tokens[i].lexeme, "}") != 0) {
-            
-            // Check if the previous line ended with a semicolon
-            bool hasEndingSemicolon = false;
-            int j = i;
-            while (j >= 0 && tokens[j].line == tokens[i].line) {
-                if (strcmp(tokens[j].lexeme, ";") == 0) {
-                    hasEndingSemicolon = true;
-                    break;
-                }
-                j--;
+    // Check for statements that should end with semicolons
+    if ((tokenTypes[i] == TOKEN_IDENTIFIER ||
+         tokenTypes[i] == TOKEN_NUMBER ||
+         tokenKinds[i] == KIND_RPAREN ||
+         tokenKinds[i] == KIND_RBRACKET ||
+         tokenKinds[i] == KIND_INCREMENT ||
+         tokenKinds[i] == KIND_DECREMENT ||
+         tokenTypes[i] == TOKEN_STRING ||
+         tokenTypes[i] == TOKEN_CHAR) &&
+        lineBreakAfter(i) &&
+        tokenKinds[i] != KIND_SEMICOLON &&
+        tokenKinds[i] != KIND_LBRACE &&
+        tokenKinds[i] != KIND_RBRACE) {
+        
+        // Check if the previous line ended with a semicolon
+        bool hasEndingSemicolon = false;
+        unsigned int lineStart = lineStarts[tokenLine(i) - 1];
+        int j = i;
+        while (j >= 0 && tokenOffsets[j] >= lineStart) {
+            if (tokenKinds[j] == KIND_SEMICOLON) {
+                hasEndingSemicolon = true;
+                break;
             }
+            j--;
+        }
 
-            if (!hasEndingSemicolon) {
-                reportError("Missing semicolon at end of statement", tokens[i].line, tokens[i].column + strlen(tokens[i].lexeme));
-            }
+        if (!hasEndingSemicolon) {
+            reportErrorAt(ERROR_STATEMENT_SEMICOLON, i, tokenEndOffset(i));
         }
+    }
 
-        // Check for incorrect use of a comma instead of a semicolon
-        if (tokens[i].type == TOKEN_SEPARATOR && strcmp(tokens[i].lexeme, ",") == 0) {
-            // Check if the comma is used where a semicolon is expected
-            if (tokens[i + 1].line > tokens[i].line) {
-                reportError("Comma used instead of semicolon", tokens[i].line, tokens[i].column);
-            }
+    // Check for incorrect use of a comma instead of a semicolon
+    if (tokenTypes[i] == TOKEN_SEPARATOR && tokenKinds[i] == KIND_COMMA) {
+        // Check if the comma is used where a semicolon is expected
+        if (lineBreakAfter(i)) {
+            reportError(ERROR_COMMA_FOR_SEMICOLON, i);
         }
     }
 }
@@ -682,33 +2530,29 @@ void checkMissingSemicolons() {
  /**
   * Checks for unmatched quotes in string and character literals
   */
- void checkUnmatchedQuotes() {
-     printf("Checking for unmatched quotes...\n");
-     
-     for (int i = 0; i < tokenCount; i++) {
-         if (tokens[i].type == TOKEN_STRING) {
-             const char* lexeme = tokens[i].lexeme;
-             int len = strlen(lexeme);
-             
-             // A properly formed string token should start and end with double quotes
-             if (len < 2 || lexeme[0] != '"' || lexeme[len-1] != '"') {
-                 reportError("Unterminated string literal", tokens[i].line, tokens[i].column);
-             }
-         } else if (tokens[i].type == TOKEN_CHAR) {
-             const char* lexeme = tokens[i].lexeme;
-             int len = strlen(lexeme);
-             
-             // A properly formed character token should start and end with single quotes
-             if (len < 2 || lexeme[0] != '\'' || lexeme[len-1] != '\'') {
-                 reportError("Unterminated character literal", tokens[i].line, tokens[i].column);
-             }
-             
-             // Character literals should contain exactly one character or escape sequence
-             if (len == 2) {
-                 reportError("Empty character literal", tokens[i].line, tokens[i].column);
-             } else if (len > 4 && lexeme[1] != '\\') {
-                 reportError("Multi-character literal (too many characters)", tokens[i].line, tokens[i].column);
-             }
+ void checkUnmatchedQuotes(Pass *pass, int i, const PassContext *context) {
+     if (tokenTypes[i] == TOKEN_STRING) {
+         const char* lexeme = tokenText(i);
+         int len = tokenLengths[i];
+         
+         // A properly formed string token should start and end with double quotes
+         if (len < 2 || lexeme[0] != '"' || lexeme[len-1] != '"') {
+             reportError(ERROR_UNTERMINATED_STRING, i);
+         }
+     } else if (tokenTypes[i] == TOKEN_CHAR) {
+         const char* lexeme = tokenText(i);
+         int len = tokenLengths[i];
+         
+         // A properly formed character token should start and end with single quotes
+         if (len < 2 || lexeme[0] != '\'' || lexeme[len-1] != '\'') {
+             reportError(ERROR_UNTERMINATED_CHAR, i);
+         }
+         
+         // Character literals should contain exactly one character or escape sequence
+         if (len == 2) {
+             reportError(ERROR_EMPTY_CHAR, i);
+         } else if (len > 4 && lexeme[1] != '\\') {
+             reportError(ERROR_MULTI_CHAR, i);
          }
      }
  }
@@ -716,111 +2560,63 @@ void checkMissingSemicolons() {
  /**
  * Checks for errors in header file names
  */
-void checkHeaderFileErrors() {
-    printf("Checking for header file errors...\n");
-    
-    const char *stdHeaders[] = {
-        "stdio.h", "stdlib.h", "string.h", "ctype.h", "math.h", 
-        "time.h", "stdbool.h", "stddef.h", "stdint.h", "float.h",
-        "limits.h", "assert.h", "locale.h", "setjmp.h", "signal.h"
-    };
-    int stdHeaderCount = sizeof(stdHeaders) / sizeof(stdHeaders[0]);
-    
-    for (int i = 0; i < tokenCount; i++) {
-        if (tokens[i].type == TOKEN_PREPROCESSOR) {
-            // Check for #include directives
-            if (strstr(tokens[i].lexeme, "#include") != NULL) {
-                // Extract the header name
-                char *start = strstr(tokens[i].lexeme, "<");
-                char *end = NULL;
-                bool hasAngleBrackets = false;
-                
+void checkHeaderFileErrors(Pass *pass, int i, const PassContext *context) {
+    if (tokenTypes[i] == TOKEN_PREPROCESSOR) {
+        char lexeme[MAX_IDENTIFIER_LENGTH];
+        directiveText(i, lexeme);
+        
+        // Check for #include directives
+        if (strstr(lexeme, "#include") != NULL) {
+            // Extract the header name
+            char *start = strstr(lexeme, "<");
+            char *end = NULL;
+            bool hasAngleBrackets = false;
+            
+            if (start != NULL) {
+                start++;
+                end = strstr(start, ">");
+                hasAngleBrackets = true;
+            } else {
+                start = strstr(lexeme, "\"");
                 if (start != NULL) {
                     start++;
-                    end = strstr(start, ">");
-                    hasAngleBrackets = true;
-                } else {
-                    start = strstr(tokens[i].lexeme, "\"");
-                    if (start != NULL) {
-                        start++;
-                        end = strstr(start, "\"");
-                    }
+                    end = strstr(start, "\"");
                 }
+            }
+            
+            if (start != NULL && end != NULL) {
+                int headerLen = end - start;
+                char headerName[MAX_IDENTIFIER_LENGTH];
+                strncpy(headerName, start, headerLen);
+                headerName[headerLen] = '\0';
                 
-                if (start != NULL && end != NULL) {
-                    int headerLen = end - start;
-                    char headerName[MAX_IDENTIFIER_LENGTH];
-                    strncpy(headerName, start, headerLen);
-                    headerName[headerLen] = '\0';
-                    
-                    // Check for common misspellings
-                    if (strcmp(headerName, "stdio") == 0) {
-                        reportError("Missing '.h' extension in header file name", tokens[i].line, tokens[i].column);
-                    } else if (strcmp(headerName, "stDio.h") == 0 || strcmp(headerName, "STDIO.H") == 0 || strcmp(headerName, "StDio.h") == 0 || strcmp(headerName, "StDiO.h") == 0 || strcmp(headerName, "stDio.h") == 0 || strcmp(headerName, "STDiO.h") == 0 || strcmp(headerName, "StdIO.h") == 0 || strcmp(headerName, "stdIO.h") == 0 || strcmp(headerName, "stdo.h") == 0 || strcmp(headerName, "stdi.h") == 0 ||
-                    strcmp(headerName, "stdIo.h") == 0 || strcmp(headerName, "STDIO.H") == 0 || strcmp(headerName, "Stdio.H") == 0 || strcmp(headerName, "StDiO.H") == 0 || strcmp(headerName, "STDIo.h") == 0 || strcmp(headerName, "stdiO.h") == 0 || strcmp(headerName, "StDIO.h") == 0 || strcmp(headerName, "StdIo.h") == 0 || strcmp(headerName, "tdio.h") == 0 || strcmp(headerName, "stio.h") == 0 ||
-                    strcmp(headerName, "StdIO.H") == 0 || strcmp(headerName, "stdIo.H") == 0 || strcmp(headerName, "sTDIO.H") == 0 || strcmp(headerName, "stDIO.h") == 0 || strcmp(headerName, "stDio.H") == 0 || strcmp(headerName, "stDIO.h") == 0 || strcmp(headerName, "StDIO.h") == 0 || strcmp(headerName, "stdIo.H") == 0 || strcmp(headerName, "stdO.H") == 0 || strcmp(headerName, "sdio.h") == 0 ||
-                    strcmp(headerName, "StDiO.h") == 0 || strcmp(headerName, "stDiO.h") == 0 || strcmp(headerName, "stDio.H") == 0 || strcmp(headerName, "STDIO.h") == 0 || strcmp(headerName, "StdIo.H") == 0 || strcmp(headerName, "StDIO.h") == 0 || strcmp(headerName, "STDiO.H") == 0 || strcmp(headerName, "StDiO.h") == 0 ||
-                    strcmp(headerName, "StdIO.h") == 0 || strcmp(headerName, "stdIo.H") == 0 || strcmp(headerName, "StDIO.H") == 0 || strcmp(headerName, "stdiO.H") == 0 || strcmp(headerName, "STDIO.h") == 0 || strcmp(headerName, "stDIO.h") == 0 || strcmp(headerName, "StDIO.H") == 0 || strcmp(headerName, "stdiO.h") == 0 ||
-                    strcmp(headerName, "stDIo.H") == 0 || strcmp(headerName, "stDIO.h") == 0 || strcmp(headerName, "StdiO.H") == 0 || strcmp(headerName, "STDiO.H") == 0 || strcmp(headerName, "Stdio.H") == 0 || strcmp(headerName, "stDIo.h") == 0 || strcmp(headerName, "stDio.H") == 0 || strcmp(headerName, "stDIo.h") == 0 ||
-                    strcmp(headerName, "sTDiO.h") == 0 || strcmp(headerName, "StDIo.h") == 0 || strcmp(headerName, "StDiO.h") == 0 || strcmp(headerName, "stdIo.H") == 0 || strcmp(headerName, "StDIO.h") == 0 || strcmp(headerName, "stDiO.h") == 0 || strcmp(headerName, "StDiO.H") == 0 || strcmp(headerName, "STDiO.h") == 0 ||
-                    strcmp(headerName, "stDIo.h") == 0 || strcmp(headerName, "StDIO.h") == 0 || strcmp(headerName, "stdiO.H") == 0 || strcmp(headerName, "stDIO.H") == 0 || strcmp(headerName, "stdiO.h") == 0 || strcmp(headerName, "stdiO.h") == 0 || strcmp(headerName, "STDIo.H") == 0 || strcmp(headerName, "StDIO.H") == 0 ||
-                    strcmp(headerName, "Stdio.H") == 0 || strcmp(headerName, "STDIo.h") == 0 || strcmp(headerName, "STDiO.h") == 0 || strcmp(headerName, "stdio.H") == 0 || strcmp(headerName, "stDIo.h") == 0 || strcmp(headerName, "stdiO.h") == 0 || strcmp(headerName, "stDiO.h") == 0 || strcmp(headerName, "stDiO.h") == 0) {
-                        reportError("Case sensitivity error in header file name (should be 'stdio.h')", tokens[i].line, tokens[i].column);
-                    } else if (strcmp(headerName, "stido.h") == 0 || strcmp(headerName, "sdtio.h") == 0 || strcmp(headerName, "stidoh.h") == 0 ||
-                    strcmp(headerName, "sdto.h") == 0 || strcmp(headerName, "sdti.o") == 0 || strcmp(headerName, "stddo.h") == 0 ||
-                    strcmp(headerName, "stdioh.h") == 0 || strcmp(headerName, "stdo.h") == 0 || strcmp(headerName, "stdo.h") == 0 ||
-                    strcmp(headerName, "stdi.h") == 0 || strcmp(headerName, "sdtio.h") == 0 || strcmp(headerName, "sdtioh.h") == 0 || 
-                    strcmp(headerName, "stdoi.h") == 0 || strcmp(headerName, "stdioh.h") == 0 || strcmp(headerName, "stdih.o") == 0 || strcmp(headerName, "stdoi.h") == 0) {
-                        reportError("Possible misspelling in header file name (should be 'stdio.h')", tokens[i].line, tokens[i].column);
-                    } 
-                    
-                    // Check if it's a standard header but used with quotes instead of angle brackets
-                    bool isStdHeader = false;
-                    for (int j = 0; j < stdHeaderCount; j++) {
-                        if (strcmp(headerName, stdHeaders[j]) == 0) {
-                            isStdHeader = true;
-                            break;
-                        }
-                    }
-                    
-                    if (isStdHeader && !hasAngleBrackets) {
-                        reportError("Standard library header should use angle brackets '<>' instead of quotes", tokens[i].line, tokens[i].column);
-                    }
-                    
-                    // Check for close misspellings of standard headers
-                    if (!isStdHeader) {
-                        for (int j = 0; j < stdHeaderCount; j++) {
-                            // Simple check for headers that are off by 1-2 characters
-                            if (strlen(headerName) > 3 && strlen(stdHeaders[j]) > 3) {
-                                int matches = 0;
-                                int minLength = strlen(headerName) < strlen(stdHeaders[j]) ? 
-                                               strlen(headerName) : strlen(stdHeaders[j]);
-                                
-                                for (int k = 0; k < minLength; k++) {
-                                    if (headerName[k] == stdHeaders[j][k]) {
-                                        matches++;
-                                    }
-                                }
-                                
-                                // If names are similar but not identical
-                                if (matches > minLength * 0.7 && matches < minLength) {
-                                    char message[MAX_ERROR_MSG_LENGTH];
-                                    sprintf(message, "Possible misspelling in header name: '%s', did you mean '%s'?", 
-                                            headerName, stdHeaders[j]);
-                                    reportError(message, tokens[i].line, tokens[i].column);
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                } else {
-                    reportError("Malformed #include directive", tokens[i].line, tokens[i].column);
+                // Compare with the standard headers, ignoring case and allowing a typo or two
+                FuzzyMatch match = fuzzyMatch(&headerDictionary, headerName, headerLen, headerLen < 9 ? 1 : 2);
+                bool isStdHeader = match.exact;
+                
+                if (isHeaderWithoutExtension(headerName, headerLen)) {
+                    reportError(ERROR_HEADER_EXTENSION, i);
+                } else if (match.word >= 0 && !match.exact && match.distance == 0) {
+                    reportError(ERROR_HEADER_CASE, i, match.word);
+                } else if (match.word >= 0 && match.distance > 0) {
+                    // The name as written is the same bytes in the raw token, after its first '<' or '"'
+                    const char *written = memchr(tokenText(i), start[-1], tokenLengths[i]);
+                    reportError(ERROR_HEADER_SPELLING, i, (int)(written + 1 - tokenText(i)), headerLen, match.word);
                 }
                 
-                // Check for missing space after #include
-                if (strstr(tokens[i].lexeme, "#include<stdo.h>") != NULL || strstr(tokens[i].lexeme, "#include\"") != NULL) {
-                    reportError("Missing space after '#include'", tokens[i].line, tokens[i].column);
+                // Check if it's a standard header but used with quotes instead of angle brackets
+                if (isStdHeader && !hasAngleBrackets) {
+                    reportError(ERROR_HEADER_QUOTES, i);
                 }
+            } else {
+                reportError(ERROR_MALFORMED_INCLUDE, i);
+            }
+            
+            // Check for missing space after #include, in the token as written
+            int nameLength;
+            const char *name = directiveName(i, &nameLength);
+            if (name[nameLength] == '<' || name[nameLength] == '"') {
+                reportError(ERROR_INCLUDE_SPACE, i);
             }
         }
     }
@@ -829,431 +2625,607 @@ void checkHeaderFileErrors() {
 /**
  * Checks for case sensitivity errors in keywords
  */
-void checkKeywordCaseSensitivity() {
-    printf("Checking for keyword case sensitivity errors...\n");
-    
-    for (int i = 0; i < tokenCount; i++) {
-        if (tokens[i].type == TOKEN_IDENTIFIER) {
-            // Check if identifier is a keyword but with wrong case
-            for (int j = 0; j < MAX_KEYWORDS; j++) {
-                if (strcasecmp(tokens[i].lexeme, keywords[j]) == 0 && 
-                    strcmp(tokens[i].lexeme, keywords[j]) != 0) {
-                    char message[MAX_ERROR_MSG_LENGTH];
-                    sprintf(message, "Case sensitivity error: '%s' should be '%s'", 
-                            tokens[i].lexeme, keywords[j]);
-                    reportError(message, tokens[i].line, tokens[i].column);
-                    break;
-                }
-            }
+void checkKeywordCaseSensitivity(Pass *pass, int i, const PassContext *context) {
+    if (tokenTypes[i] == TOKEN_IDENTIFIER) {
+        // Check if identifier is a keyword but with wrong case
+        FuzzyMatch match = fuzzyMatch(&keywordDictionary, tokenText(i), tokenLengths[i], 0);
+        if (match.word >= 0 && !match.exact) {
+            reportError(ERROR_KEYWORD_CASE, i, match.word);
         }
     }
 }
 
 /**
- * Checks for spelling errors in standard library function calls
+ * Notes the names the file declares itself, kept in pass->state: a call
+ * to one of those is not a misspelled library call
  */
-void checkStandardFunctionSpelling() {
-    printf("Checking for standard function spelling errors...\n");
+void startFunctionSpelling(Pass *pass) {
+    bool *declared = arenaAlloc(pass->arena, (size_t)identifierTable.count + 1);
     
-    for (int i = 0; i < tokenCount - 1; i++) {
-        if (tokens[i].type == TOKEN_IDENTIFIER && 
-            i+1 < tokenCount && strcmp(tokens[i+1].lexeme, "(") == 0) {
-            
-            const char *funcName = tokens[i].lexeme;
-            
-            // Check if this is close to a standard library function but not exact
-            if (!isStdLibFunction(funcName)) {
-                for (int j = 0; j < sizeof(stdLibFunctions) / sizeof(stdLibFunctions[0]); j++) {
-                    // Calculate similarity
-                    int matches = 0;
-                    int minLength = strlen(funcName) < strlen(stdLibFunctions[j]) ? 
-                                   strlen(funcName) : strlen(stdLibFunctions[j]);
-                    
-                    for (int k = 0; k < minLength; k++) {
-                        if (funcName[k] == stdLibFunctions[j][k]) {
-                            matches++;
-                        }
-                    }
-                    
-                    // If names are similar but not identical
-                    if (matches > minLength * 0.7 && matches < minLength) {
-                        char message[MAX_ERROR_MSG_LENGTH];
-                        sprintf(message, "Possible misspelling of standard function: '%s', did you mean '%s'?", 
-                                funcName, stdLibFunctions[j]);
-                        reportError(message, tokens[i].line, tokens[i].column);
-                        break;
-                    }
-                    
-                    // Check for case sensitivity
-                    if (strcasecmp(funcName, stdLibFunctions[j]) == 0 && 
-                        strcmp(funcName, stdLibFunctions[j]) != 0) {
-                        char message[MAX_ERROR_MSG_LENGTH];
-                        sprintf(message, "Case sensitivity error in function call: '%s' should be '%s'", 
-                                funcName, stdLibFunctions[j]);
-                        reportError(message, tokens[i].line, tokens[i].column);
-                        break;
-                    }
-                }
-            }
+    memset(declared, 0, (size_t)identifierTable.count + 1);
+    for (int i = 0; i < tokenCount; i++) {
+        if (nameRoles[i] == NAME_DECLARED) {
+            declared[tokenSymbols[i]] = true;
         }
     }
+    pass->state = declared;
 }
 
 /**
- * Checks for proper format of include directives
+ * Checks for spelling errors in standard library function calls
  */
-void checkIncludePlacement() {
-    printf("Checking for invalid placement of #include directives...\n");
-
-    bool insideFunction = false;
-
-    for (int i = 0; i < tokenCount; i++) {
-        if (tokens[i].type == TOKEN_IDENTIFIER && strcmp(tokens[i].lexeme, "main") == 0) {
-            // Assume we are inside a function after encountering "main"
-            insideFunction = true;
-        }
+void checkStandardFunctionSpelling(Pass *pass, int i, const PassContext *context) {
+    const bool *declared = pass->state;
+    
+    if (declared[tokenSymbols[i]]) {
+        return;
+    }
+    
+    // Allow a typo in a name of four letters or more, two from eight
+    int length = tokenLengths[i];
+    FuzzyMatch match = fuzzyMatch(&stdLibDictionary, tokenText(i), length, length < 4 ? 0 : length < 8 ? 1 : 2);
+    
+    if (match.word < 0 || match.exact) {
+        return;
+    }
+    if (match.distance == 0) {
+        reportError(ERROR_FUNCTION_CASE, i, match.word);
+    } else {
+        reportError(ERROR_FUNCTION_SPELLING, i, match.word);
+    }
+}
 
-        if (tokens[i].type == TOKEN_PREPROCESSOR && strstr(tokens[i].lexeme, "#include") != NULL) {
-            if (insideFunction) {
-                reportError("Invalid placement of #include directive. It must be outside of functions.", tokens[i].line, tokens[i].column);
-            }
+/**
+ * Checks for proper format of include directives
+ */
+void checkIncludePlacement(Pass *pass, int i, const PassContext *context) {
+    // Assume we are inside a function after encountering "main"
+    if (tokenTypes[i] == TOKEN_PREPROCESSOR && context->afterMain) {
+        char lexeme[MAX_IDENTIFIER_LENGTH];
+        directiveText(i, lexeme);
+        
+        if (strstr(lexeme, "#include") != NULL) {
+            reportError(ERROR_INCLUDE_PLACEMENT, i);
         }
     }
 }
-void checkIncludeDirectiveFormat() {
-    printf("Checking for include directive format errors...\n");
-
-    for (int i = 0; i < tokenCount; i++) {
-        if (tokens[i].type == TOKEN_PREPROCESSOR) {
-            const char *lexeme = tokens[i].lexeme;
-
-            // Check if the directive starts with '#'
-            if (lexeme[0] == '#') {
-                // Check if the lexeme starts with '#include' or something similar
-                if (strncmp(lexeme, "#include", 8) == 0) {
-                    // Check if there's anything after #include
-                    if (strlen(lexeme) <= 8) {
-                        reportError("Incomplete #include directive", tokens[i].line, tokens[i].column);
-                        continue;
-                    }
-
-                    // Check for correct opening and closing brackets/quotes
-                    bool hasOpeningBracket = strstr(lexeme, "<") != NULL;
-                    bool hasClosingBracket = strstr(lexeme, ">") != NULL;
-                    bool hasOpeningQuote = strstr(lexeme, "\"") != NULL;
-                    bool hasClosingQuote = (strstr(lexeme, "\"") != strrchr(lexeme, '\"'));
-
-                    if (hasOpeningBracket && !hasClosingBracket) {
-                        reportError("Missing closing '>' in #include directive", tokens[i].line, tokens[i].column);
-                    } else if (!hasOpeningBracket && hasClosingBracket) {
-                        reportError("Missing opening '<' in #include directive", tokens[i].line, tokens[i].column);
-                    } else if (hasOpeningQuote && !hasClosingQuote) {
-                        reportError("Missing closing '\"' in #include directive", tokens[i].line, tokens[i].column);
-                    } else if (!hasOpeningQuote && !hasOpeningBracket) {
-                        reportError("Missing file name in #include directive", tokens[i].line, tokens[i].column);
-                    } else if (hasOpeningBracket && hasOpeningQuote) {
-                        reportError("Cannot use both angle brackets and quotes in #include directive", tokens[i].line, tokens[i].column);
-                    }
-
-                    // Check for extra characters after the closing bracket/quote
-                    const char *end = NULL;
-                    if (hasClosingBracket) {
-                        end = strrchr(lexeme, '>');
-                    } else if (hasClosingQuote) {
-                        end = strrchr(lexeme, '\"');
-                    }
-
-                    if (end != NULL && *(end + 1) != '\0' && !isspace(*(end + 1))) {
-                        reportError("Extra characters after header name in #include directive", tokens[i].line, tokens[i].column);
-                    }
-                } 
-                else {
-                    // Check for typos in '#include' by checking characters after '#'
-                    const char *expectedInclude = "include";
-                    int typoCount = 0, len = strlen(lexeme);
+void checkIncludeDirectiveFormat(Pass *pass, int i, const PassContext *context) {
+    if (tokenTypes[i] == TOKEN_PREPROCESSOR) {
+        char lexeme[MAX_IDENTIFIER_LENGTH];
+        directiveText(i, lexeme);
 
-                    for (int j = 1, k = 0; j < len && k < 7; j++, k++) {
-                        if (j >= len || lexeme[j] != expectedInclude[k]) {
-                            typoCount++;
-                        }
-                    }
+        // Check if the directive starts with '#'
+        if (lexeme[0] == '#') {
+            // Check if the lexeme starts with '#include' or something similar
+            if (strncmp(lexeme, "#include", 8) == 0) {
+                // Check if there's anything after #include
+                if (strlen(lexeme) <= 8) {
+                    reportError(ERROR_INCLUDE_INCOMPLETE, i);
+                    return;
+                }
 
-                    // Additional check for shorter strings
-                    if (strlen(lexeme) < 8) {
-                        typoCount += (8 - strlen(lexeme));
-                    }
+                // Check for correct opening and closing brackets/quotes
+                bool hasOpeningBracket = strstr(lexeme, "<") != NULL;
+                bool hasClosingBracket = strstr(lexeme, ">") != NULL;
+                bool hasOpeningQuote = strstr(lexeme, "\"") != NULL;
+                bool hasClosingQuote = (strstr(lexeme, "\"") != strrchr(lexeme, '\"'));
 
-                    if (typoCount > 0 && typoCount <= 2) { // Allowing up to 2 typos
-                        reportError("Possible typo in '#include' directive", tokens[i].line, tokens[i].column);
-                    }
+                if (hasOpeningBracket && !hasClosingBracket) {
+                    reportError(ERROR_INCLUDE_CLOSING_ANGLE, i);
+                } else if (!hasOpeningBracket && hasClosingBracket) {
+                    reportError(ERROR_INCLUDE_OPENING_ANGLE, i);
+                } else if (hasOpeningQuote && !hasClosingQuote) {
+                    reportError(ERROR_INCLUDE_CLOSING_QUOTE, i);
+                } else if (!hasOpeningQuote && !hasOpeningBracket) {
+                    reportError(ERROR_INCLUDE_NO_NAME, i);
+                } else if (hasOpeningBracket && hasOpeningQuote) {
+                    reportError(ERROR_INCLUDE_MIXED, i);
+                }
 
-                    // Additional case-insensitive check
-                    if (strncasecmp(lexeme, "#include", 8) == 0) {
-                        reportError("'#include' directive must be lowercase", tokens[i].line, tokens[i].column);
-                    }
+                // Check for extra characters after the closing bracket/quote
+                const char *end = NULL;
+                if (hasClosingBracket) {
+                    end = strrchr(lexeme, '>');
+                } else if (hasClosingQuote) {
+                    end = strrchr(lexeme, '\"');
+                }
 
-                    // Special check for '#iclude' or similar cases (Missing letters)
-                    if (strlen(lexeme) > 1 && strstr(lexeme, "iclude") != NULL || strstr(lexeme, "icnlude") != NULL || strstr(lexeme, "inlude") != NULL || strstr(lexeme, "inclde") != NULL || strstr(lexeme, "includ") != NULL || strstr(lexeme, "iclde") != NULL || strstr(lexeme, "iclude") != NULL || strstr(lexeme, "nclude") != NULL || strstr(lexeme, "incude") != NULL || strstr(lexeme, "inlude") != NULL ){
-                        reportError("Possible typo: Did you mean '#include'?", tokens[i].line, tokens[i].column);
-                    }
+                if (end != NULL && *(end + 1) != '\0' && !isspace(*(end + 1))) {
+                    reportError(ERROR_INCLUDE_TRAILING, i);
                 }
-            } else {
-                // Check if it's a preprocessor directive with a missing '#'
-                if (strncmp(lexeme, "include", 7) == 0) {
-                    reportError("Missing '#' before 'include' directive", tokens[i].line, tokens[i].column);
+            } 
+            else {
+                // Compare the directive's name with the directive names, ignoring case
+                int nameLength;
+                const char *name = directiveName(i, &nameLength);
+                FuzzyMatch match = fuzzyMatch(&directiveDictionary, name, nameLength, 2);
+                
+                if (match.word == DIRECTIVE_INCLUDE && match.distance == 0) {
+                    reportError(ERROR_INCLUDE_CASE, i);
+                } else if (match.word == DIRECTIVE_INCLUDE && nameLength == (int)strlen("include")) {
+                    // Letters swapped or replaced
+                    reportError(ERROR_INCLUDE_TYPO, i);
+                } else if (match.word == DIRECTIVE_INCLUDE) {
+                    // Letters missing or added
+                    reportError(ERROR_INCLUDE_MISSPELLED, i);
                 }
             }
+        } else {
+            // Check if it's a preprocessor directive with a missing '#'
+            if (strncmp(lexeme, "include", 7) == 0) {
+                reportError(ERROR_INCLUDE_NO_HASH, i);
+            }
         }
     }
 }
 
 
 
+ /* Standard library calls seen by identifyFunctions(), as token indices; they
+  * are added to functions[] once the declarations have all been found */
+ static int *stdLibCalls = NULL;
+ static int stdLibCallCount = 0;
+ static int stdLibCallCapacity = 0;
+ 
+ /**
+  * Forgets the standard library calls of a previous walk
+  */
+ void resetStdLibCalls(Pass *pass) {
+     stdLibCallCount = 0;
+ }
+ 
+ /**
+  * Remembers the standard library functions called, for addFunctions()
+  */
+ void identifyFunctions(Pass *pass, int i, const PassContext *context) {
+     // A name followed by '(' is called unless it is being declared
+     if (nameRoles[i] == NAME_USE && isStdLibFunction(tokenText(i), tokenLengths[i])) {
+         stdLibCalls = arenaGrowArray(pass->arena, stdLibCalls, stdLibCallCount, &stdLibCallCapacity, sizeof(stdLibCalls[0]));
+         stdLibCalls[stdLibCallCount++] = i;
+     }
+ }
+ 
  /**
-  * Identifies functions (both user-defined and standard library)
+  * Adds a function to functions[] unless one of the same name is already
+  * there, as seen[] (by symbol ID) records
   */
- void identifyFunctions() {
-     printf("Identifying functions...\n");
+ static void addFunction(Pass *pass, unsigned char *seen, int nameToken, bool isUserDefined, bool isPrototype) {
+     if (seen[tokenSymbols[nameToken]]) {
+         return;
+     }
+     seen[tokenSymbols[nameToken]] = 1;
      
-     // First pass: identify function declarations and definitions
-     for (int i = 0; i < tokenCount - 2; i++) {
-         // Look for patterns like: type identifier(params)
-         // or: type * identifier(params)
-         if ((i > 0 && tokens[i-1].type == TOKEN_KEYWORD && tokens[i].type == TOKEN_IDENTIFIER) || 
-             (i > 1 && tokens[i-2].type == TOKEN_KEYWORD && tokens[i-1].type == TOKEN_OPERATOR && 
-              strcmp(tokens[i-1].lexeme, "*") == 0 && tokens[i].type == TOKEN_IDENTIFIER)) {
-             
-             if (i+1 < tokenCount && strcmp(tokens[i+1].lexeme, "(") == 0) {
-                 // Found potential function declaration or definition
-                 Function func;
-                 strcpy(func.name, tokens[i].lexeme);
-                 func.line = tokens[i].line;
-                 
-                 // Determine if it's a prototype or definition
-                 // Find closing parenthesis
-                 int j = i + 2;
-                 int parenCount = 1;
-                 
-                 while (j < tokenCount && parenCount > 0) {
-                     if (strcmp(tokens[j].lexeme, "(") == 0) parenCount++;
-                     if (strcmp(tokens[j].lexeme, ")") == 0) parenCount--;
-                     j++;
-                 }
-                 
-                 if (j < tokenCount) {
-                     // Check what follows the closing parenthesis
-                     while (j < tokenCount && (tokens[j].type == TOKEN_OPERATOR || isspace(*tokens[j].lexeme))) {
-                         j++;
-                     }
-                     
-                     if (j < tokenCount && strcmp(tokens[j].lexeme, "{") == 0) {
-                         // This is a function definition
-                         func.isUserDefined = true;
-                         func.isPrototype = false;
-                     } else {
-                         // This is a function prototype
-                         func.isUserDefined = true;
-                         func.isPrototype = true;
-                     }
-                     
-                     // Add to functions array if not already present
-                     bool alreadyExists = false;
-                     for (int k = 0; k < functionCount; k++) {
-                         if (strcmp(functions[k].name, func.name) == 0) {
-                             alreadyExists = true;
-                             break;
-                         }
-                     }
-                     
-                     if (!alreadyExists && functionCount < MAX_FUNCTIONS) {
-                         functions[functionCount++] = func;
-                     }
-                 }
-                 
-             }
+     Function func;
+     copyTokenText(nameToken, func.name, sizeof(func.name));
+     func.nameId = tokenSymbols[nameToken];
+     func.isUserDefined = isUserDefined;
+     func.isPrototype = isPrototype;
+     func.line = tokenLine(nameToken);
+     func.token = nameToken;
+     functions = arenaGrowArray(pass->arena, functions, functionCount, &functionCapacity, sizeof(Function));
+     functions[functionCount++] = func;
+ }
+ 
+ /**
+  * Adds the functions the file declares or defines, in the order they
+  * appear, then the standard library functions called, in call order
+  */
+ void addFunctions(Pass *pass) {
+     const Node *nodes = syntaxTree.nodes;
+     
+     unsigned char *seen = arenaAlloc(pass->arena, identifierTable.count + 1);
+     memset(seen, 0, identifierTable.count + 1);
+     for (int j = 0; j < functionCount; j++) {
+         seen[functions[j].nameId] = 1;
+     }
+     
+     // Declarators are numbered in the order they appear
+     for (int node = 0; node < syntaxTree.count; node++) {
+         if (nodes[node].kind == NODE_DECLARATOR && nodes[node].token >= 0 &&
+             (nodes[node].flags & (NODE_FLAG_FUNCTION | NODE_FLAG_PARAMETER)) == NODE_FLAG_FUNCTION) {
+             addFunction(pass, seen, nodes[node].token, true, !(nodes[node].flags & NODE_FLAG_DEFINITION));
          }
      }
+     for (int c = 0; c < stdLibCallCount; c++) {
+         addFunction(pass, seen, stdLibCalls[c], false, false);
+     }
+ }
+ 
+ /* Declarations trackVariables() has found, in token order, duplicates included */
+ typedef struct {
+     Variable *items;
+     int count;
+     int capacity;
+ } VariableList;
+ 
+ /**
+  * Writes the type the declaration node declares its names with: its basic
+  * type keyword, "struct tag" (or the keyword alone for an anonymous
+  * record), or the typedef name
+  */
+ static void declarationType(int declaration, char *type, size_t size) {
+     const Node *nodes = syntaxTree.nodes;
+     const Node *n = &nodes[declaration];
+     int first = n->firstChild;
      
-     // Second pass: identify function calls
-     for (int i = 0; i < tokenCount - 1; i++) {
-         if (tokens[i].type == TOKEN_IDENTIFIER && 
-             i+1 < tokenCount && strcmp(tokens[i+1].lexeme, "(") == 0) {
-             
-             // Check if this is a function call (not a declaration)
-             if (i == 0 || tokens[i-1].type != TOKEN_KEYWORD) {
-                 const char* funcName = tokens[i].lexeme;
-                 
-                 // Check if it's a standard library function
-                 if (isStdLibFunction(funcName)) {
-                     // Add to functions array if not already present
-                     bool alreadyExists = false;
-                     for (int j = 0; j < functionCount; j++) {
-                         if (strcmp(functions[j].name, funcName) == 0) {
-                             alreadyExists = true;
-                             break;
-                         }
-                     }
-                     
-                     if (!alreadyExists && functionCount < MAX_FUNCTIONS) {
-                         Function func;
-                         strcpy(func.name, funcName);
-                         func.isUserDefined = false;
-                         func.isPrototype = false;
-                         func.line = tokens[i].line;
-                         functions[functionCount++] = func;
-                     }
-                 }
-             }
+     if (n->op == 0 && first >= 0 && nodes[first].kind == NODE_RECORD) {
+         const char *keyword = keywordNames[nodes[first].op - KIND_AUTO];
+         if (tokenKinds[nodes[first].token] == nodes[first].op) {
+             snprintf(type, size, "%s", keyword);
+         } else {
+             snprintf(type, size, "%s %.*s", keyword, (int)tokenLengths[nodes[first].token], tokenText(nodes[first].token));
          }
+     } else {
+         copyTokenText(n->token, type, size);
      }
  }
  
  /**
-  * Tracks variable declarations and usage
+  * Records the declaration of the name the declarator or enumerator node
+  * declares, with the given type
   */
- void trackVariables() {
-     printf("Tracking variables...\n");
+ static void addDeclaration(Pass *pass, const char *type, bool isBasicType, int node) {
+     const Node *nodes = syntaxTree.nodes;
+     int nameToken = nodes[node].token;
+     Variable var;
+     copyTokenText(nameToken, var.name, sizeof(var.name));
+     var.nameId = tokenSymbols[nameToken];
+     snprintf(var.type, sizeof(var.type), "%s", type);
+     var.size = getTypeSize(var.type);
+     var.line = tokenLine(nameToken);
+     var.token = nameToken;
+     var.isArray = false;
+     var.isPointer = nodes[node].kind == NODE_DECLARATOR && nodes[node].op > 0;
+     var.isBasicType = isBasicType;
+     var.isEnumerator = nodes[node].kind == NODE_ENUMERATOR;
+     var.arraySize =.1;
+     
+     // Check if it's an array, and whether its first dimension is a number
+     if (nodes[node].flags & NODE_FLAG_ARRAY) {
+         var.isArray = true;
+         
+         int size = nodes[nodes[node].firstChild].firstChild;
+         if (size >= 0 && nodes[size].kind == NODE_NUMBER) {
+             var.arraySize = atoi(tokenText(nodes[size].token));
+         }
+     }
      
-     // Keep track of scope level
-     int scopeLevel = 0;
+     // Keep it for addTrackedVariables(), which drops repeated names
+     VariableList *found = pass->state;
+     if (!found) {
+         found = pass->state = arenaAlloc(pass->arena, sizeof(VariableList));
+         memset(found, 0, sizeof(VariableList));
+     }
+     found->items = arenaGrowArray(pass->arena, found->items, found->count, &found->capacity, sizeof(Variable));
+     found->items[found->count++] = var;
+ }
+ 
+ /**
+  * Tracks variable declarations, whatever their type: "int a, *b = 2, c[4];",
+  * "FILE *fp;", "struct node n;", "myint v;", and the constants of an enum
+  */
+ void trackVariables(Pass *pass, int i, const PassContext *context) {
+     int declaration = declarationNodes[i];
+     if (declaration < 0) {
+         return;
+     }
      
-     for (int i = 0; i < tokenCount - 1; i++) {
-         // Track scope changes
-         if (tokens[i].type == TOKEN_SEPARATOR) {
-             if (strcmp(tokens[i].lexeme, "{") == 0) {
-                 scopeLevel++;
-             } else if (strcmp(tokens[i].lexeme, "}") == 0) {
-                 scopeLevel--;
+     // An enum's constants are ints, even in a typedef
+     const Node *nodes = syntaxTree.nodes;
+     for (int r = nodes[declaration].firstChild; r >= 0; r = nodes[r].nextSibling) {
+         if (nodes[r].kind == NODE_RECORD && nodes[r].op == KIND_ENUM) {
+             for (int e = nodes[r].firstChild; e >= 0; e = nodes[e].nextSibling) {
+                 addDeclaration(pass, "int", true, e);
              }
          }
-         
-         // Look for variable declarations
-         if (tokens[i].type == TOKEN_KEYWORD && 
-             (strcmp(tokens[i].lexeme, "int") == 0 || 
-              strcmp(tokens[i].lexeme, "char") == 0 || 
-              strcmp(tokens[i].lexeme, "float") == 0 || 
-              strcmp(tokens[i].lexeme, "double") == 0 || 
-              strcmp(tokens[i].lexeme, "void") == 0 || 
-              strcmp(tokens[i].lexeme, "long") == 0 || 
-              strcmp(tokens[i].lexeme, "short") == 0)) {
-             
-             // Skip function declarations
-             bool isFunction = false;
-             for (int j = i + 1; j < tokenCount && j < i + 10; j++) {
-                 if (tokens[j].type == TOKEN_SEPARATOR && strcmp(tokens[j].lexeme, "(") == 0) {
-                     isFunction = true;
-                     break;
-                 }
-                 if (tokens[j].type == TOKEN_SEPARATOR && strcmp(tokens[j].lexeme, ";") == 0) {
-                     break;
-                 }
+     }
+     if (nodes[declaration].flags & NODE_FLAG_TYPEDEF) {
+         return;
+     }
+     
+     // Each named declarator, skipping functions
+     char type[MAX_IDENTIFIER_LENGTH];
+     declarationType(declaration, type, sizeof(type));
+     bool isBasicType = nodes[declaration].op != 0;
+     for (int d = nodes[declaration].firstChild; d >= 0; d = nodes[d].nextSibling) {
+         if (nodes[d].kind == NODE_DECLARATOR && nodes[d].token >= 0 && !(nodes[d].flags & NODE_FLAG_FUNCTION)) {
+             addDeclaration(pass, type, isBasicType, d);
+         }
+     }
+ }
+ 
+ /**
+  * Appends the declarations a copy of the pass found after those found so far
+  */
+ void mergeTrackedVariables(Pass *pass, Pass *part) {
+     VariableList *found = pass->state;
+     VariableList *more = part->state;
+     
+     if (!more) {
+         return;
+     }
+     if (!found) {
+         found = pass->state = arenaAlloc(pass->arena, sizeof(VariableList));
+         memset(found, 0, sizeof(VariableList));
+     }
+     for (int k = 0; k < more->count; k++) {
+         found->items = arenaGrowArray(pass->arena, found->items, found->count, &found->capacity, sizeof(Variable));
+         found->items[found->count++] = more->items[k];
+     }
+ }
+ 
+ /**
+  * Orders declarations by the position of their name
+  */
+ static int compareDeclarationTokens(const void *a, const void *b) {
+     const Variable *first = a;
+     const Variable *second = b;
+     return (first->token > second->token) - (first->token < second->token);
+ }
+ 
+ /**
+  * Publishes the declarations found, in token order, and adds each declared
+  * name to variables[], keeping its first declaration
+  */
+ void addTrackedVariables(Pass *pass) {
+     VariableList *found = pass->state;
+     
+     if (!found) {
+         return;
+     }
+     
+     // A struct's members come before the names declared with it, but are
+     // found after them
+     qsort(found->items, found->count, sizeof(Variable), compareDeclarationTokens);
+     declarations = found->items;
+     declarationCount = found->count;
+     
+     unsigned char *seen = arenaAlloc(pass->arena, identifierTable.count + 1);
+     memset(seen, 0, identifierTable.count + 1);
+     for (int k = 0; k < variableCount; k++) {
+         seen[variables[k].nameId] = 1;
+     }
+     for (int k = 0; k < found->count; k++) {
+         if (!seen[found->items[k].nameId]) {
+             seen[found->items[k].nameId] = 1;
+             variables = arenaGrowArray(pass->arena, variables, variableCount, &variableCapacity, sizeof(Variable));
+             variables[variableCount++] = found->items[k];
+         }
+     }
+ }
+ 
+ /* Scopes resolveNames() has open, and its place in declarations[] */
+ static ScopeStack nameScopes;
+ static int nextDeclaration = 0;
+ static bool parameterScopeOpen = false;    // Opened by a parameter list, before its '{'
+ static int scopeState = 0;                 // Changed whenever a name comes into or goes out of scope
+ 
+ /**
+  * Starts name resolution with only the file scope open
+  */
+ void startNameResolution(Pass *pass) {
+     scopeInit(&nameScopes, pass->arena);
+     nextDeclaration = 0;
+     parameterScopeOpen = false;
+     scopeState = 0;
+     tokenBindings = arenaAlloc(pass->arena, (size_t)tokenCount * sizeof(int));
+     memset(tokenBindings, 0xff, (size_t)tokenCount * sizeof(int));
+     tokenScopes = arenaAlloc(pass->arena, (size_t)tokenCount * sizeof(int));
+     memset(tokenScopes, 0xff, (size_t)tokenCount * sizeof(int));
+     declarationEnds = arenaAlloc(pass->arena, ((size_t)declarationCount + 1) * sizeof(int));
+     for (int d = 0; d < declarationCount; d++) {
+         declarationEnds[d] = tokenCount;
+     }
+ }
+ 
+ /**
+  * Closes the innermost scope at the token at index, which ends the reach
+  * of the declarations in it
+  */
+ static void closeNameScope(int index) {
+     const Scope *scope = &nameScopes.scopes[nameScopes.depth - 1];
+     
+     if (nameScopes.depth > 1) {
+         for (int u = 0; u < scope->count; u++) {
+             declarationEnds[scope->values[scope->used[u]]] = index;
+         }
+     }
+     if (scope->count > 0) {
+         scopeState++;
+     }
+     scopePop(&nameScopes);
+ }
+ 
+ /**
+  * Binds each identifier to the declaration of its name visible where it
+  * appears. Each '{' opens a scope and each '}' closes one; declarations
+  * inside parentheses (parameters, for-loop variables) get a scope of their
+  * own that becomes the following block's, or closes at the next ';'.
+  */
+ void resolveNames(Pass *pass, int i, const PassContext *context) {
+     switch (tokenKinds[i]) {
+         case KIND_LBRACE:
+             if (parameterScopeOpen) {
+                 parameterScopeOpen = false;
+             } else {
+                 scopePush(&nameScopes);
              }
-             
-             if (!isFunction) {
-                 // This is a variable declaration
-                 int j = i + 1;
-                 
-                 // Skip modifiers and pointer asterisks
-                 while (j < tokenCount && 
-                        (tokens[j].type == TOKEN_KEYWORD || 
-                         (tokens[j].type == TOKEN_OPERATOR && strcmp(tokens[j].lexeme, "*") == 0))) {
-                     j++;
-                 }
-                 
-                 if (j < tokenCount && tokens[j].type == TOKEN_IDENTIFIER) {
-                     Variable var;
-                     strcpy(var.name, tokens[j].lexeme);
-                     strcpy(var.type, tokens[i].lexeme);
-                     var.size = getTypeSize(tokens[i].lexeme);
-                     var.line = tokens[j].line;
-                     var.isArray = false;
-                     var.arraySize =.1;
-                     
-                     // Check if it's an array
-                     if (j+1 < tokenCount && strcmp(tokens[j+1].lexeme, "[") == 0) {
-                         var.isArray = true;
-                         
-                         // Try to get array size
-                         if (j+2 < tokenCount && tokens[j+2].type == TOKEN_NUMBER) {
-                             var.arraySize = atoi(tokens[j+2].lexeme);
-                         }
-                     }
-                     
-                     // Add to variables array if not already present
-                     bool alreadyExists = false;
-                     for (int k = 0; k < variableCount; k++) {
-                         if (strcmp(variables[k].name, var.name) == 0) {
-                             alreadyExists = true;
-                             break;
-                         }
-                     }
-                     
-                     if (!alreadyExists && variableCount < MAX_VARIABLES) {
-                         variables[variableCount++] = var;
-                     }
-                 }
+             return;
+         case KIND_RBRACE:
+             if (parameterScopeOpen) {
+                 closeNameScope(i);
+                 parameterScopeOpen = false;
              }
-         }
+             closeNameScope(i);
+             return;
+         case KIND_SEMICOLON:
+             // Prototype parameters, or a for loop without a block
+             if (parameterScopeOpen && context->parenDepth == 0) {
+                 closeNameScope(i);
+                 parameterScopeOpen = false;
+             }
+             return;
+         default:
+             break;
+     }
+     if (tokenTypes[i] != TOKEN_IDENTIFIER) {
+         return;
      }
      
-     // Check for undefined variables
-     for (int i = 0; i < tokenCount; i++) {
-         if (tokens[i].type == TOKEN_IDENTIFIER) {
-             // Skip function names
-             bool isFunction = false;
-             for (int j = 0; j < functionCount; j++) {
-                 if (strcmp(functions[j].name, tokens[i].lexeme) == 0) {
-                     isFunction = true;
-                     break;
-                 }
+     while (nextDeclaration < declarationCount && declarations[nextDeclaration].token < i) {
+         nextDeclaration++;
+     }
+     if (nextDeclaration < declarationCount && declarations[nextDeclaration].token == i) {
+         if (scopeLookup(&nameScopes, tokenSymbols[i]) < 0) {
+             scopeState++;
+         }
+         if (declarations[nextDeclaration].isEnumerator) {
+             // Outside the enum's braces
+             scopeDeclareAt(&nameScopes, nameScopes.depth > 1 ? nameScopes.depth - 1 : 1, tokenSymbols[i], nextDeclaration);
+         } else {
+             if (context->parenDepth > 0 && !parameterScopeOpen) {
+                 scopePush(&nameScopes);
+                 parameterScopeOpen = true;
              }
-             
-             if (!isFunction) {
-                 // Check if this identifier is a declared variable
-                 bool isDeclared = false;
-                 for (int j = 0; j < variableCount; j++) {
-                     
-                     if (strcmp(variables[j].name, tokens[i].lexeme) == 0) {
-                        isDeclared = true;
-                        break;
-                    }
-                }
-                
-                if (!isDeclared) {
-                    // Check if this is a variable use, not a declaration
-                    bool isBeingDeclared = false;
-                    
-                    // Check if it's part of a declaration (looking backward)
-                    for (int j = i - 1; j >= 0 && j >= i - 5; j--) {
-                        if (tokens[j].type == TOKEN_KEYWORD && 
-                            (strcmp(tokens[j].lexeme, "int") == 0 || 
-                             strcmp(tokens[j].lexeme, "char") == 0 || 
-                             strcmp(tokens[j].lexeme, "float") == 0 || 
-                             strcmp(tokens[j].lexeme, "double") == 0 || 
-                             strcmp(tokens[j].lexeme, "void") == 0 || 
-                             strcmp(tokens[j].lexeme, "long") == 0 || 
-                             strcmp(tokens[j].lexeme, "short") == 0)) {
-                            isBeingDeclared = true;
-                            break;
-                        }
-                        
-                        if (tokens[j].type == TOKEN_SEPARATOR && strcmp(tokens[j].lexeme, ";") == 0) {
-                            break;
-                        }
-                    }
-                    
-                    if (!isBeingDeclared) {
-                        // Flag undefined variable
-                        char message[MAX_ERROR_MSG_LENGTH];
-                        sprintf(message, "Undefined variable '%s'", tokens[i].lexeme);
-                        reportError(message, tokens[i].line, tokens[i].column);
-                    }
-                }
-            }
-        }
-    }
-}
-
+             scopeDeclare(&nameScopes, tokenSymbols[i], nextDeclaration);
+         }
+     }
+     tokenBindings[i] = scopeLookup(&nameScopes, tokenSymbols[i]);
+     tokenScopes[i] = scopeState;
+ }
+ 
+ /* Role flags of each symbol ID, set by markSymbolRoles() */
+ static unsigned char *symbolRoles = NULL;
+ 
+ /* Every declared variable and function name, by symbol ID, for suggesting
+  * one in place of an undefined name; with, for each symbol ID, its first
+  * declaration and, for each declaration, the next one of the same name */
+ static SuggestIndex declaredNames;
+ static int *firstDeclarationOf = NULL;
+ static int *nextDeclarationOf = NULL;
+ 
+ /**
+  * Indexes the declared names, adding each one as its first declaration
+  * is met, then the function names
+  */
+ static void indexDeclaredNames(Pass *pass) {
+     int *lastDeclarationOf = arenaAlloc(pass->arena, ((size_t)identifierTable.count + 1) * sizeof(int));
+     
+     suggestInit(&declaredNames, pass->arena);
+     firstDeclarationOf = arenaAlloc(pass->arena, ((size_t)identifierTable.count + 1) * sizeof(int));
+     nextDeclarationOf = arenaAlloc(pass->arena, ((size_t)declarationCount + 1) * sizeof(int));
+     for (int id = 0; id < identifierTable.count; id++) {
+         firstDeclarationOf[id] = -1;
+     }
+     
+     for (int d = 0; d < declarationCount; d++) {
+         int id = declarations[d].nameId;
+         
+         nextDeclarationOf[d] = -1;
+         if (firstDeclarationOf[id] < 0) {
+             firstDeclarationOf[id] = d;
+             suggestAdd(&declaredNames, identifierTable.texts[id], identifierTable.lengths[id], id);
+         } else {
+             nextDeclarationOf[lastDeclarationOf[id]] = d;
+         }
+         lastDeclarationOf[id] = d;
+     }
+     for (int j = 0; j < functionCount; j++) {
+         int id = functions[j].nameId;
+         if (firstDeclarationOf[id] < 0) {
+             suggestAdd(&declaredNames, identifierTable.texts[id], identifierTable.lengths[id], id);
+         }
+     }
+ }
+ 
+ /**
+  * Checks whether the name with a symbol ID can be used at the token at
+  * *index: a function, or a variable with a declaration whose scope holds it
+  */
+ static bool isVisibleAt(int id, void *index) {
+     int i = *(const int *)index;
+     
+     if (symbolRoles[id] & SYMBOL_FUNCTION) {
+         return true;
+     }
+     for (int d = firstDeclarationOf[id]; d >= 0; d = nextDeclarationOf[d]) {
+         if (declarations[d].token < i && i < declarationEnds[d]) {
+             return true;
+         }
+     }
+     return false;
+ }
+ 
+ /**
+  * Marks which symbol IDs name a function or a declared variable, so each
+  * identifier is classified with one lookup, and indexes the declared names
+  */
+ void markSymbolRoles(Pass *pass) {
+     symbolRoles = arenaAlloc(pass->arena, identifierTable.count + 1);
+     memset(symbolRoles, 0, identifierTable.count + 1);
+     for (int j = 0; j < functionCount; j++) {
+         symbolRoles[functions[j].nameId] |= SYMBOL_FUNCTION;
+     }
+     for (int j = 0; j < variableCount; j++) {
+         symbolRoles[variables[j].nameId] |= SYMBOL_VARIABLE;
+     }
+     indexDeclaredNames(pass);
+ }
+ 
+ /* The names checkUndefinedVariables() last suggested for a symbol, in the
+  * slot its symbol ID picks, with the tokenScopes[] value they hold for */
+ typedef struct {
+     int symbol;                             // -1 while the slot is empty
+     int scope;
+     int suggestions[MAX_SUGGESTIONS];       // -1 past the last
+ } CachedSuggestions;
+ 
+ /**
+  * Looks up the declared names nearest to the undefined name at the token
+  * at index that are usable there, once for each name and scope
+  */
+ static void suggestNames(Pass *pass, int i, int *suggestions) {
+     CachedSuggestions *cache = pass->state;
+     if (!cache) {
+         cache = pass->state = arenaAlloc(pass->arena, SUGGESTION_CACHE_SIZE * sizeof(CachedSuggestions));
+         for (int k = 0; k < SUGGESTION_CACHE_SIZE; k++) {
+             cache[k].symbol = -1;
+         }
+     }
+     
+     CachedSuggestions *entry = &cache[tokenSymbols[i] & (SUGGESTION_CACHE_SIZE - 1)];
+     if (entry->symbol != tokenSymbols[i] || entry->scope != tokenScopes[i]) {
+         int maxDistance = tokenLengths[i] / 4 < MAX_SUGGESTION_DISTANCE ? tokenLengths[i] / 4 : MAX_SUGGESTION_DISTANCE;
+         int count = suggestNearest(&declaredNames, tokenText(i), tokenLengths[i], maxDistance,
+                                    isVisibleAt, &i, entry->suggestions, MAX_SUGGESTIONS);
+         for (int k = count; k < MAX_SUGGESTIONS; k++) {
+             entry->suggestions[k] = -1;
+         }
+         entry->symbol = tokenSymbols[i];
+         entry->scope = tokenScopes[i];
+     }
+     memcpy(suggestions, entry->suggestions, sizeof(entry->suggestions));
+ }
+ 
+ /**
+  * Checks for uses of undefined variables
+  */
+ void checkUndefinedVariables(Pass *pass, int i, const PassContext *context) {
+     // Skip function names and names with a declaration in scope
+     if ((symbolRoles[tokenSymbols[i]] & SYMBOL_FUNCTION) || tokenBindings[i] >= 0) {
+         return;
+     }
+     
+     // Only uses count: not names being declared, types, tags, labels, or
+     // members, which are declared in their struct rather than in any scope
+     if (nameRoles[i] == NAME_USE) {
+         // Flag undefined variable, suggesting the nearest names usable here
+         int suggestions[MAX_SUGGESTIONS];
+         suggestNames(pass, i, suggestions);
+         reportError(ERROR_UNDEFINED_VARIABLE, i, suggestions[0], suggestions[1], suggestions[2]);
+     }
+ }
+ 
 /**
  * Calculates memory usage by variables
  */
@@ -1262,8 +3234,6 @@ void calculateMemoryUsage() {
     
     int typeMemory[5] = {0}; // For int, char, float, double, other
     
-    printf("Calculating memory usage...\n");
-    
     for (int i = 0; i < variableCount; i++) {
         int size = variables[i].size;
         
@@ -1287,289 +3257,230 @@ void calculateMemoryUsage() {
         }
     }
     
-    printf("Total memory usage: %d bytes\n", totalMemory);
-    printf("  - Int variables: %d bytes\n", typeMemory[0]);
-    printf("  - Char variables: %d bytes\n", typeMemory[1]);
-    printf("  - Float variables: %d bytes\n", typeMemory[2]);
-    printf("  - Double variables: %d bytes\n", typeMemory[3]);
-    printf("  - Other variables: %d bytes\n", typeMemory[4]);
+    printReport("Total memory usage: %d bytes\n", totalMemory);
+    printReport("  - Int variables: %d bytes\n", typeMemory[0]);
+    printReport("  - Char variables: %d bytes\n", typeMemory[1]);
+    printReport("  - Float variables: %d bytes\n", typeMemory[2]);
+    printReport("  - Double variables: %d bytes\n", typeMemory[3]);
+    printReport("  - Other variables: %d bytes\n", typeMemory[4]);
+}
+
+/* Occurrences of each keyword, in keywordNames[] order */
+static int keywordCount[KEYWORD_COUNT];
+
+/**
+ * Clears the keyword counts before a walk
+ */
+void resetKeywordCounts(Pass *pass) {
+    memset(keywordCount, 0, sizeof(keywordCount));
 }
 
 /**
  * Identifies C language keywords and counts their usage
  */
-void identifyKeywords() {
-    int keywordCount[MAX_KEYWORDS] = {0};
-    
-    printf("Identifying keywords...\n");
-    
-    for (int i = 0; i < tokenCount; i++) {
-        if (tokens[i].type == TOKEN_KEYWORD) {
-            // Find the keyword in the keywords array
-            for (int j = 0; j < MAX_KEYWORDS; j++) {
-                if (strcmp(tokens[i].lexeme, keywords[j]) == 0) {
-                    keywordCount[j]++;
-                    break;
-                }
-            }
-        }
-    }
-    
-    // Print keyword usage
-    printf("Keyword usage:\n");
-    for (int i = 0; i < MAX_KEYWORDS; i++) {
+void identifyKeywords(Pass *pass, int i, const PassContext *context) {
+    keywordCount[tokenKinds[i] - KIND_AUTO]++;
+}
+
+/**
+ * Prints how often each keyword was used
+ */
+void printKeywordUsage() {
+    printReport("Keyword usage:\n");
+    for (int i = 0; i < KEYWORD_COUNT; i++) {
         if (keywordCount[i] > 0) {
-            printf("  - %s: %d occurrences\n", keywords[i], keywordCount[i]);
+            printReport("  - %s: %d occurrences\n", keywordNames[i], keywordCount[i]);
         }
     }
 }
+/**
+ * Starts the parsed printf format strings of a walk, kept in pass->state
+ */
+void startPrintfFormats(Pass *pass) {
+    FormatCache *formats = arenaAlloc(pass->arena, sizeof(FormatCache));
+    formatCacheInit(formats, pass->arena, FORMAT_PRINTF);
+    pass->state = formats;
+}
+
 /**
  * Checks for common printf-related errors
  */ 
-void checkPrintfErrors() {
-    printf("Checking for printf errors...\n");
+void checkPrintfErrors(Pass *pass, int i, const PassContext *context) {
+    if (i >= tokenCount - 2) {
+        return;
+    }
     
-    for (int i = 0; i < tokenCount - 2; i++) {
-        // Look for printf function calls
-        if (tokens[i].type == TOKEN_IDENTIFIER) {
-            // Check for case sensitivity errors
-            if (strcmp(tokens[i].lexeme, "prinTf") == 0 || strcmp(tokens[i].lexeme, "Printf") == 0 || strcmp(tokens[i].lexeme, "pRintf") == 0 || strcmp(tokens[i].lexeme, "prIntf") == 0 ||
-            strcmp(tokens[i].lexeme, "priNtf") == 0 || strcmp(tokens[i].lexeme, "prinTf") == 0 || strcmp(tokens[i].lexeme, "printF") == 0 || strcmp(tokens[i].lexeme, "PRintf") == 0 ||
-            strcmp(tokens[i].lexeme, "PRIntf") == 0 || strcmp(tokens[i].lexeme, "PRIntf") == 0 || strcmp(tokens[i].lexeme, "PRINtf") == 0 || strcmp(tokens[i].lexeme, "PRINTf") == 0 ||
-            strcmp(tokens[i].lexeme, "PRINTF") == 0 || strcmp(tokens[i].lexeme, "pRINTF") == 0 || strcmp(tokens[i].lexeme, "prINTF") == 0 || strcmp(tokens[i].lexeme, "priNTF") == 0 ||
-            strcmp(tokens[i].lexeme, "prinTF") == 0 || strcmp(tokens[i].lexeme, "printF") == 0 || strcmp(tokens[i].lexeme, "PrINTF") == 0 || strcmp(tokens[i].lexeme, "PRinTF") == 0 ||
-            strcmp(tokens[i].lexeme, "PRiNTF") == 0 || strcmp(tokens[i].lexeme, "PRInTF") == 0 || strcmp(tokens[i].lexeme, "PRIeNTF") == 0 || strcmp(tokens[i].lexeme, "PRIentf") == 0 ||
-            strcmp(tokens[i].lexeme, "PRintF") == 0 || strcmp(tokens[i].lexeme, "PRinTf") == 0 || strcmp(tokens[i].lexeme, "PRiNtf") == 0 || strcmp(tokens[i].lexeme, "PrIntF") == 0 ||
-            strcmp(tokens[i].lexeme, "PrIntf") == 0 || strcmp(tokens[i].lexeme, "PrinTF") == 0 || strcmp(tokens[i].lexeme, "PrintF") == 0 || strcmp(tokens[i].lexeme, "pRintF") == 0 ||
-            strcmp(tokens[i].lexeme, "pRinTF") == 0 || strcmp(tokens[i].lexeme, "pRInTf") == 0 || strcmp(tokens[i].lexeme, "pRINtf") == 0 || strcmp(tokens[i].lexeme, "prINTf") == 0 ||
-            strcmp(tokens[i].lexeme, "priNTf") == 0 || strcmp(tokens[i].lexeme, "prinTF") == 0 || strcmp(tokens[i].lexeme, "printF") == 0 || strcmp(tokens[i].lexeme, "PrINtf") == 0 ||
-            strcmp(tokens[i].lexeme, "PrIntF") == 0 || strcmp(tokens[i].lexeme, "PrinTF") == 0 || strcmp(tokens[i].lexeme, "PrintF") == 0 || strcmp(tokens[i].lexeme, "pRinTf") == 0 ||
-            strcmp(tokens[i].lexeme, "pRintF") == 0 || strcmp(tokens[i].lexeme, "pRinTF") == 0 || strcmp(tokens[i].lexeme, "pRINTF") == 0 || strcmp(tokens[i].lexeme, "prINtf") == 0 ||
-            strcmp(tokens[i].lexeme, "prIntF") == 0 || strcmp(tokens[i].lexeme, "priNTF") == 0 || strcmp(tokens[i].lexeme, "priNtF") == 0 || strcmp(tokens[i].lexeme, "priNtf") == 0 ||
-            strcmp(tokens[i].lexeme, "prinTf") == 0 || strcmp(tokens[i].lexeme, "printF") == 0
-             )
-                {
-                reportError("Case sensitivity error. Did you mean 'printf'?", tokens[i].line, tokens[i].column);
-                continue;
-            }
+    // Look for printf function calls
+    if (tokenTypes[i] == TOKEN_IDENTIFIER) {
+        // Check for case sensitivity errors
+        if (isPrintfCaseVariant(tokenText(i), tokenLengths[i])) {
+            reportError(ERROR_PRINTF_CASE, i);
+            return;
+        }
+        
+        if (tokenIs(i, "printf") && 
+            i+1 < tokenCount && tokenKinds[i+1] == KIND_LPAREN) {
             
-            if (strcmp(tokens[i].lexeme, "printf") == 0 && 
-                i+1 < tokenCount && strcmp(tokens[i+1].lexeme, "(") == 0) {
-                
-                // Found printf call - look for the format string
-                int j = i + 2;
-                int formatStringIndex = -1;
-                
-                // Find the format string (should be the first argument)
-                while (j < tokenCount && strcmp(tokens[j].lexeme, ")") != 0) {
-                    if (tokens[j].type == TOKEN_STRING) {
+            // Found printf call - its arguments were split by indexCallSites()
+            const CallSite *site = findCallSite(i);
+            const ArgumentRange *arguments = &callArguments[site->firstArgument];
+            int formatArgument = 0;
+            int formatStringIndex = -1;
+            
+            // Find the format string (should be the first argument)
+            for (int a = 0; a < site->argumentCount && formatStringIndex == -1; a++) {
+                for (int j = arguments[a].from; j < arguments[a].to; j++) {
+                    if (tokenTypes[j] == TOKEN_STRING) {
                         formatStringIndex = j;
+                        formatArgument = a;
                         break;
                     }
-                    j++;
-                }
-                
-                if (formatStringIndex == -1) {
-                    reportError("printf call missing format string", tokens[i].line, tokens[i].column);
-                    continue;
-                }
-                
-                // Extract format string
-                char formatString[MAX_IDENTIFIER_LENGTH];
-                strcpy(formatString, tokens[formatStringIndex].lexeme);
-                
-                // Remove surrounding quotes
-                int fmtLen = strlen(formatString);
-                if (fmtLen >= 2) {
-                    memmove(formatString, formatString + 1, fmtLen - 2);
-                    formatString[fmtLen - 2] = '\0';
-                }
-                
-                // Count format specifiers
-                int formatSpecifiers = 0;
-                bool inFormatSpecifier = false;
-                
-                for (int k = 0; k < strlen(formatString); k++) {
-                    if (formatString[k] == '%') {
-                        // Check for %% which is not a format specifier
-                        if (k + 1 < strlen(formatString) && formatString[k+1] == '%') {
-                            k++; // Skip the second %
-                            continue;
-                        }
-                        
-                        inFormatSpecifier = true;
-                        formatSpecifiers++;
-                    } else if (inFormatSpecifier) {
-                        // Check for invalid format specifiers
-                        if (strchr("diuoxXfFeEgGaAcspn", formatString[k])) {
-                            inFormatSpecifier = false;
-                        } else if (!isdigit(formatString[k]) && 
-                                  !strchr(".-+# hlLz", formatString[k])) {
-                            char errMsg[MAX_ERROR_MSG_LENGTH];
-                            sprintf(errMsg, "Invalid format specifier '%%%c' in printf", formatString[k]);
-                            reportError(errMsg, tokens[formatStringIndex].line, tokens[formatStringIndex].column);
-                            inFormatSpecifier = false;
-                        }
-                    }
-                }
-                
-                // Count arguments (excluding the format string)
-                int arguments = 0;
-                int commaCount = 0;
-                j = formatStringIndex + 1;
-                
-                while (j < tokenCount && strcmp(tokens[j].lexeme, ")") != 0) {
-                    if (strcmp(tokens[j].lexeme, ",") == 0) {
-                        commaCount++;
-                    }
-                    j++;
                 }
-                
-                arguments = commaCount;
-                
-                // Check for mismatch in format specifiers and arguments
-                if (formatSpecifiers > arguments) {
-                    reportError("Too few arguments for printf format string", tokens[i].line, tokens[i].column);
-                } else if (formatSpecifiers < arguments) {
-                    reportError("Too many arguments for printf format string", tokens[i].line, tokens[i].column);
+            }
+            
+            if (formatStringIndex == -1) {
+                reportError(ERROR_PRINTF_NO_FORMAT, i);
+                return;
+            }
+            
+            // View the format string without its surrounding quotes
+            const char *formatString = tokenText(formatStringIndex);
+            int formatLength = tokenLengths[formatStringIndex];
+            if (formatLength >= 2) {
+                formatString++;
+                formatLength -= 2;
+            }
+            
+            // Parse it, or find it parsed at an earlier call
+            const FormatString *format = formatCompile(pass->state, formatString, formatLength);
+            int formatSpecifiers = format->argumentCount;
+            
+            for (int k = 0; k < format->count; k++) {
+                if (format->specs[k].bad) {
+                    reportError(ERROR_PRINTF_BAD_SPECIFIER, formatStringIndex, format->specs[k].bad);
                 }
+            }
+            
+            // Count arguments (excluding the format string); commas inside
+            // nested calls and braces do not split them
+            int argumentCount = site->argumentCount - formatArgument - 1;
+            
+            // Check for mismatch in format specifiers and arguments
+            if (formatSpecifiers > argumentCount) {
+                reportError(ERROR_PRINTF_TOO_FEW, i);
+            } else if (formatSpecifiers < argumentCount) {
+                reportError(ERROR_PRINTF_TOO_MANY, i);
+            }
+            
+            // Now check each argument with corresponding format specifier
+            if (formatSpecifiers > 0) {
+                int nextArgument = formatArgument + 1;
                 
-                // Now check each argument with corresponding format specifier
-                if (formatSpecifiers > 0) {
-                    int currentArgIndex = formatStringIndex + 2; // Start after format string and comma
-                    int currentFmtIndex = 0;
+                for (int specifierIdx = 0; specifierIdx < format->count; specifierIdx++) {
+                    const FormatSpec *spec = &format->specs[specifierIdx];
                     
-                    for (int specifierIdx = 0; specifierIdx < formatSpecifiers; specifierIdx++) {
-                        // Find next format specifier
-                        while (currentFmtIndex < strlen(formatString)) {
-                            if (formatString[currentFmtIndex] == '%' && 
-                                (currentFmtIndex + 1 >= strlen(formatString) || 
-                                 formatString[currentFmtIndex + 1] != '%')) {
-                                break;
-                            }
-                            currentFmtIndex++;
+                    // A '*' width or precision takes an int argument first
+                    if (spec->flags & FORMAT_STAR_WIDTH) {
+                        nextArgument++;
+                    }
+                    if (spec->flags & FORMAT_STAR_PRECISION) {
+                        nextArgument++;
+                    }
+                    if (nextArgument >= site->argumentCount) {
+                        break;
+                    }
+                    
+                    // An invalid specifier has no conversion to check against
+                    char formatType = (char)spec->conversion;
+                    const ArgumentRange *argument = &arguments[nextArgument++];
+                    
+                    // Check the tokens of the corresponding argument
+                    for (int currentArgIndex = argument->from; currentArgIndex < argument->to; currentArgIndex++) {
+                        if (tokenTypes[currentArgIndex] == TOKEN_IDENTIFIER &&
+                            currentArgIndex + 1 < argument->to && tokenKinds[currentArgIndex+1] == KIND_LPAREN) {
+                            // What a call returns is not known here: skip it with its arguments
+                            currentArgIndex = delimiterMatches[currentArgIndex+1];
+                            continue;
                         }
                         
-                        if (currentFmtIndex < strlen(formatString)) {
-                            // Find the format specifier type
-                            int specStart = currentFmtIndex;
-                            currentFmtIndex++; // Skip the %
-                            
-                            // Skip modifiers
-                            while (currentFmtIndex < strlen(formatString) && 
-                                   !strchr("diuoxXfFeEgGaAcspn", formatString[currentFmtIndex])) {
-                                currentFmtIndex++;
-                            }
-                            
-                            char formatType = '\0';
-                            if (currentFmtIndex < strlen(formatString)) {
-                                formatType = formatString[currentFmtIndex];
-                                currentFmtIndex++; // Move past this format specifier
-                            }
-                            
-                            // Find and check the corresponding argument
-                            while (currentArgIndex < tokenCount && 
-                                   strcmp(tokens[currentArgIndex].lexeme, ",") != 0 && 
-                                   strcmp(tokens[currentArgIndex].lexeme, ")") != 0) {
+                        // Check if the argument matches the format type
+                        if (nameRoles[currentArgIndex] == NAME_MEMBER) {
+                            // A member's type is not known here
+                        } else if (tokenTypes[currentArgIndex] == TOKEN_IDENTIFIER) {
+                            // If it's a variable, check if it's declared
+                            bool isDeclared = false;
+                            int v = tokenBindings[currentArgIndex];
+                            if (v >= 0) {
+                                isDeclared = true;
                                 
-                                // Check if the argument matches the format type
-                                if (tokens[currentArgIndex].type == TOKEN_IDENTIFIER) {
-                                    // If it's a variable, check if it's declared
-                                    bool isDeclared = false;
-                                    for (int v = 0; v < variableCount; v++) {
-                                        if (strcmp(variables[v].name, tokens[currentArgIndex].lexeme) == 0) {
-                                            isDeclared = true;
+                                // Check type compatibility
+                                if (formatType && declarations[v].isBasicType) {
+                                    bool typeMatch = false;
+                                    
+                                    switch (formatType) {
+                                        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+                                            // Integer types
+                                            if (strcmp(declarations[v].type, "int") == 0 || 
+                                                strcmp(declarations[v].type, "short") == 0 || 
+                                                strcmp(declarations[v].type, "long") == 0) {
+                                                typeMatch = true;
+                                            }
+                                            break;
+                                            
+                                        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                                            // Floating-point types
+                                            if (strcmp(declarations[v].type, "float") == 0 || 
+                                                strcmp(declarations[v].type, "double") == 0) {
+                                                typeMatch = true;
+                                            }
+                                            break;
+                                            
+                                        case 'c':
+                                            // Character type
+                                            if (strcmp(declarations[v].type, "char") == 0) {
+                                                typeMatch = true;
+                                            }
+                                            break;
                                             
-                                            // Check type compatibility
-                                            if (formatType) {
-                                                bool typeMatch = false;
-                                                
-                                                switch (formatType) {
-                                                    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
-                                                        // Integer types
-                                                        if (strcmp(variables[v].type, "int") == 0 || 
-                                                            strcmp(variables[v].type, "short") == 0 || 
-                                                            strcmp(variables[v].type, "long") == 0) {
-                                                            typeMatch = true;
-                                                        }
-                                                        break;
-                                                        
-                                                    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
-                                                        // Floating-point types
-                                                        if (strcmp(variables[v].type, "float") == 0 || 
-                                                            strcmp(variables[v].type, "double") == 0) {
-                                                            typeMatch = true;
-                                                        }
-                                                        break;
-                                                        
-                                                    case 'c':
-                                                        // Character type
-                                                        if (strcmp(variables[v].type, "char") == 0) {
-                                                            typeMatch = true;
-                                                        }
-                                                        break;
-                                                        
-                                                    case 's':
-                                                        // String (char array) type
-                                                        if (strcmp(variables[v].type, "char") == 0 && variables[v].isArray) {
-                                                            typeMatch = true;
-                                                        }
-                                                        break;
-                                                        
-                                                    case 'p':
-                                                        // Pointer type
-                                                        // Simplified check
-                                                        typeMatch = true;
-                                                        break;
-                                                }
-                                                
-                                                if (!typeMatch) {
-                                                    char errMsg[MAX_ERROR_MSG_LENGTH];
-                                                    sprintf(errMsg, "Format specifier '%%%c' incompatible with variable type '%s'", 
-                                                            formatType, variables[v].type);
-                                                    reportError(errMsg, tokens[currentArgIndex].line, tokens[currentArgIndex].column);
-                                                }
+                                        case 's':
+                                            // String (char array or pointer) type
+                                            if (strcmp(declarations[v].type, "char") == 0 &&
+                                                (declarations[v].isArray || declarations[v].isPointer)) {
+                                                typeMatch = true;
                                             }
+                                            break;
                                             
+                                        case 'p':
+                                            // Pointer type
+                                            // Simplified check
+                                            typeMatch = true;
                                             break;
-                                        }
                                     }
                                     
-                                    if (!isDeclared) {
-                                        char errMsg[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(errMsg, "Undefined variable '%s' used in printf", tokens[currentArgIndex].lexeme);
-                                        reportError(errMsg, tokens[currentArgIndex].line, tokens[currentArgIndex].column);
-                                    }
-                                } 
-                                // Check literals for compatibility
-                                else if (tokens[currentArgIndex].type == TOKEN_NUMBER) {
-                                    if (formatType == 's' || formatType == 'c') {
-                                        char errMsg[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(errMsg, "Format specifier '%%%c' incompatible with numeric literal", formatType);
-                                        reportError(errMsg, tokens[currentArgIndex].line, tokens[currentArgIndex].column);
-                                    }
-                                } 
-                                else if (tokens[currentArgIndex].type == TOKEN_STRING) {
-                                    if (formatType != 's') {
-                                        char errMsg[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(errMsg, "Format specifier '%%%c' incompatible with string literal", formatType);
-                                        reportError(errMsg, tokens[currentArgIndex].line, tokens[currentArgIndex].column);
-                                    }
-                                }
-                                else if (tokens[currentArgIndex].type == TOKEN_CHAR) {
-                                    if (formatType != 'c' && formatType != 'd') {
-                                        char errMsg[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(errMsg, "Format specifier '%%%c' incompatible with character literal", formatType);
-                                        reportError(errMsg, tokens[currentArgIndex].line, tokens[currentArgIndex].column);
+                                    if (!typeMatch) {
+                                        reportError(ERROR_PRINTF_VARIABLE_TYPE, currentArgIndex, formatType, v);
                                     }
                                 }
-                                
-                                currentArgIndex++;
                             }
                             
-                            // Move to next argument
-                            if (currentArgIndex < tokenCount && strcmp(tokens[currentArgIndex].lexeme, ",") == 0) {
-                                currentArgIndex++;
+                            if (!isDeclared) {
+                                reportError(ERROR_PRINTF_UNDEFINED, currentArgIndex);
+                            }
+                        } 
+                        // Check literals for compatibility
+                        else if (tokenTypes[currentArgIndex] == TOKEN_NUMBER) {
+                            if (formatType == 's' || formatType == 'c') {
+                                reportError(ERROR_PRINTF_NUMBER, currentArgIndex, formatType);
+                            }
+                        } 
+                        else if (tokenTypes[currentArgIndex] == TOKEN_STRING) {
+                            if (formatType && formatType != 's') {
+                                reportError(ERROR_PRINTF_STRING, currentArgIndex, formatType);
+                            }
+                        }
+                        else if (tokenTypes[currentArgIndex] == TOKEN_CHAR) {
+                            if (formatType && formatType != 'c' && formatType != 'd') {
+                                reportError(ERROR_PRINTF_CHAR, currentArgIndex, formatType);
                             }
                         }
                     }
@@ -1577,201 +3488,183 @@ void checkPrintfErrors() {
             }
         }
     }
-} 
+}
+
+/**
+ * Starts the parsed scanf format strings of a walk, kept in pass->state
+ */
+void startScanfFormats(Pass *pass) {
+    FormatCache *formats = arenaAlloc(pass->arena, sizeof(FormatCache));
+    formatCacheInit(formats, pass->arena, FORMAT_SCANF);
+    pass->state = formats;
+}
+
+/**
+ * Returns the specification the argument at a position is converted for,
+ * past those whose '*' suppresses the assignment, or NULL if there is none
+ */
+static const FormatSpec *assignedSpec(const FormatString *format, int argument) {
+    for (int k = 0; k < format->count; k++) {
+        if (!(format->specs[k].flags & FORMAT_SUPPRESSED) && argument-- == 0) {
+            return &format->specs[k];
+        }
+    }
+    return NULL;
+}
 
 /**
  * Checks for common scanf function usage errors
  */
-void checkScanfErrors() {
-    printf("Checking for scanf errors...\n");
+void checkScanfErrors(Pass *pass, int i, const PassContext *context) {
+    if (i >= tokenCount - 1) {
+        return;
+    }
     
-    for (int i = 0; i < tokenCount - 1; i++) {
-        // Look for scanf function calls
-        if (tokens[i].type == TOKEN_IDENTIFIER && 
-            strcmp(tokens[i].lexeme, "scanf") == 0 &&
-            i+1 < tokenCount && strcmp(tokens[i+1].lexeme, "(") == 0) {
-            
-            // Find the format string and parameters
-            int j = i + 2;
-            
-            // Ensure scanf has parameters
-            if (j < tokenCount && strcmp(tokens[j].lexeme, ")") == 0) {
-                reportError("scanf called with no arguments", tokens[i].line, tokens[i].column);
-                continue;
-            }
-            
-            // Check if the first parameter is a string literal (format string)
-            if (j < tokenCount && tokens[j].type != TOKEN_STRING) {
-                reportError("scanf first argument should be a format string", tokens[j].line, tokens[j].column);
-                continue;
-            }
-            
-            // Extract the format string
-            char formatString[MAX_IDENTIFIER_LENGTH];
-            strncpy(formatString, tokens[j].lexeme + 1, strlen(tokens[j].lexeme) - 2); // Remove quotes
-            formatString[strlen(tokens[j].lexeme) - 2] = '\0';
-            
-            // Count format specifiers in the format string
-            int formatSpecCount = 0;
-            char formatSpecifiers[MAX_IDENTIFIER_LENGTH];
-            int formatSpecIndex = 0;
-            
-            for (int k = 0; k < strlen(formatString); k++) {
-                if (formatString[k] == '%') {
-                    // Skip %% which is literal %
-                    if (k+1 < strlen(formatString) && formatString[k+1] == '%') {
-                        k++;
-                    } else {
-                        formatSpecCount++;
-                        // Capture the specifier type (d, f, c, s, etc.)
-                        if (k+1 < strlen(formatString)) {
-                            formatSpecifiers[formatSpecIndex++] = formatString[k+1];
-                        }
-                    }
-                }
-            }
-            formatSpecifiers[formatSpecIndex] = '\0';
-            
-            // Count actual arguments after format string
-            int argCount = 0;
-            j++; // Move past format string
-            
-            if (j < tokenCount && strcmp(tokens[j].lexeme, ",") != 0) {
-                reportError("Expected comma after format string in scanf", tokens[j].line, tokens[j].column);
-            } else {
-                j++; // Move past comma
-            }
-            
-            // Count arguments (should be addresses with &, except for array names)
-            while (j < tokenCount && strcmp(tokens[j].lexeme, ")") != 0) {
-                if (tokens[j].type == TOKEN_OPERATOR && strcmp(tokens[j].lexeme, "&") == 0) {
-                    if (j+1 < tokenCount && tokens[j+1].type == TOKEN_IDENTIFIER) {
-                        // Check if the variable is declared
-                        bool isDeclared = false;
-                        for (int k = 0; k < variableCount; k++) {
-                            if (strcmp(variables[k].name, tokens[j+1].lexeme) == 0) {
-                                isDeclared = true;
-                                
-                                // Check if variable type matches format specifier
-                                if (argCount < formatSpecIndex) {
-                                    char specifier = formatSpecifiers[argCount];
-                                    // Check type compatibility
-                                    if ((specifier == 'd' || specifier == 'i') && 
-                                        strcmp(variables[k].type, "int") != 0) {
-                                        char message[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(message, "Format specifier %%d doesn't match variable type %s", variables[k].type);
-                                        reportError(message, tokens[j+1].line, tokens[j+1].column);
-                                    } else if (specifier == 'f' && 
-                                              strcmp(variables[k].type, "float") != 0 && 
-                                              strcmp(variables[k].type, "double") != 0) {
-                                        char message[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(message, "Format specifier %%f doesn't match variable type %s", variables[k].type);
-                                        reportError(message, tokens[j+1].line, tokens[j+1].column);
-                                    } else if (specifier == 'c' && 
-                                              strcmp(variables[k].type, "char") != 0) {
-                                        char message[MAX_ERROR_MSG_LENGTH];
-                                        sprintf(message, "Format specifier %%c doesn't match variable type %s", variables[k].type);
-                                        reportError(message, tokens[j+1].line, tokens[j+1].column);
-                                    } else if (specifier == 's' && 
-                                              (strcmp(variables[k].type, "char") != 0 || !variables[k].isArray)) {
-                                        reportError("Format specifier %s requires char array", tokens[j+1].line, tokens[j+1].column);
-                                    }
-                                }
-                                
-                                break;
-                            }
-                        }
-                        
-                        if (!isDeclared) {
-                            char message[MAX_ERROR_MSG_LENGTH];
-                            sprintf(message, "Undeclared variable '%s' used in scanf", tokens[j+1].lexeme);
-                            reportError(message, tokens[j+1].line, tokens[j+1].column);
-                        }
+    // Look for scanf function calls
+    if (tokenTypes[i] == TOKEN_IDENTIFIER && 
+        tokenIs(i, "scanf") &&
+        i+1 < tokenCount && tokenKinds[i+1] == KIND_LPAREN) {
+        
+        // Find the format string and parameters
+        int j = i + 2;
+        
+        // Ensure scanf has parameters
+        if (findCallSite(i)->argumentCount == 0) {
+            reportError(ERROR_SCANF_NO_ARGUMENTS, i);
+            return;
+        }
+        
+        // Check if the first parameter is a string literal (format string)
+        if (j < tokenCount && tokenTypes[j] != TOKEN_STRING) {
+            reportError(ERROR_SCANF_NO_FORMAT, j);
+            return;
+        }
+        
+        // View the format string without its surrounding quotes
+        const char *formatString = tokenText(j) + 1;
+        int formatLength = tokenLengths[j] >= 2 ? (int)tokenLengths[j] - 2 : 0;
+        
+        // Parse it, or find it parsed at an earlier call
+        const FormatString *format = formatCompile(pass->state, formatString, formatLength);
+        int formatSpecCount = format->argumentCount;
+        
+        // Count actual arguments after format string
+        int argCount = 0;
+        j++; // Move past format string
+        
+        if (j < tokenCount && tokenKinds[j] != KIND_COMMA) {
+            reportError(ERROR_SCANF_NO_COMMA, j);
+        } else {
+            j++; // Move past comma
+        }
+        
+        // Count arguments (should be addresses with &, except for array names)
+        while (j < tokenCount && tokenKinds[j] != KIND_RPAREN) {
+            if (tokenTypes[j] == TOKEN_OPERATOR && tokenKinds[j] == KIND_AMPERSAND) {
+                if (j+1 < tokenCount && tokenTypes[j+1] == TOKEN_IDENTIFIER) {
+                    // Check if the variable is declared
+                    bool isDeclared = false;
+                    int k = tokenBindings[j+1];
+                    if (k >= 0) {
+                        isDeclared = true;
                         
-                        argCount++;
-                        j += 2; // Skip over & and variable name
-                    } else {
-                        reportError("Expected variable name after & in scanf", tokens[j].line, tokens[j].column);
-                        j++;
-                    }
-                } else if (tokens[j].type == TOKEN_IDENTIFIER) {
-                    // This might be an array name (no & needed)
-                    bool isArray = false;
-                    for (int k = 0; k < variableCount; k++) {
-                        if (strcmp(variables[k].name, tokens[j].lexeme) == 0 && variables[k].isArray) {
-                            isArray = true;
-                            break;
+                        // Check if variable type matches format specifier; sized ones are not checked
+                        const FormatSpec *spec = assignedSpec(format, argCount);
+                        if (spec && spec->length == FORMAT_LENGTH_NONE && declarations[k].isBasicType) {
+                            char specifier = (char)spec->conversion;
+                            // Check type compatibility
+                            if ((specifier == 'd' || specifier == 'i') && 
+                                strcmp(declarations[k].type, "int") != 0) {
+                                reportError(ERROR_SCANF_VARIABLE_TYPE, j+1, 'd', k);
+                            } else if (specifier == 'f' && 
+                                      strcmp(declarations[k].type, "float") != 0 && 
+                                      strcmp(declarations[k].type, "double") != 0) {
+                                reportError(ERROR_SCANF_VARIABLE_TYPE, j+1, 'f', k);
+                            } else if (specifier == 'c' && 
+                                      strcmp(declarations[k].type, "char") != 0) {
+                                reportError(ERROR_SCANF_VARIABLE_TYPE, j+1, 'c', k);
+                            } else if ((specifier == 's' || specifier == '[') && 
+                                      (strcmp(declarations[k].type, "char") != 0 ||
+                                       !(declarations[k].isArray || declarations[k].isPointer))) {
+                                reportError(ERROR_SCANF_NEEDS_ARRAY, j+1);
+                            }
                         }
                     }
                     
-                    if (!isArray) {
-                        reportError("Missing & operator for non-array variable in scanf", tokens[j].line, tokens[j].column);
+                    if (!isDeclared) {
+                        reportError(ERROR_SCANF_UNDECLARED, j+1);
                     }
                     
                     argCount++;
-                    j++;
-                } else if (tokens[j].type == TOKEN_SEPARATOR && strcmp(tokens[j].lexeme, ",") == 0) {
-                    j++;
+                    j += 2; // Skip over & and variable name
                 } else {
+                    reportError(ERROR_SCANF_NO_NAME, j);
                     j++;
                 }
-            }
-            
-            // Check if format specifier count matches argument count
-            if (formatSpecCount != argCount) {
-                char message[MAX_ERROR_MSG_LENGTH];
-                sprintf(message, "scanf format specifier count (%d) doesn't match argument count (%d)", 
-                        formatSpecCount, argCount);
-                reportError(message, tokens[i].line, tokens[i].column);
+            } else if (tokenTypes[j] == TOKEN_IDENTIFIER) {
+                // This might be an array name (no & needed)
+                bool isArray = tokenBindings[j] >= 0 && declarations[tokenBindings[j]].isArray;
+                
+                if (!isArray) {
+                    reportError(ERROR_SCANF_MISSING_ADDRESS, j);
+                }
+                
+                argCount++;
+                j++;
+            } else if (tokenTypes[j] == TOKEN_SEPARATOR && tokenKinds[j] == KIND_COMMA) {
+                j++;
+            } else {
+                j++;
             }
         }
         
-        // Check for case sensitivity errors - "Scanf" instead of "scanf"
-        if (tokens[i].type == TOKEN_IDENTIFIER && (
-            strcmp(tokens[i].lexeme, "scanF") == 0 ||  strcmp(tokens[i].lexeme, "Scanf") == 0 || 
-            strcmp(tokens[i].lexeme, "sCanf") == 0 || strcmp(tokens[i].lexeme, "scAnf") == 0 || 
-            strcmp(tokens[i].lexeme, "scaNf") == 0 || strcmp(tokens[i].lexeme, "scanF") == 0 || 
-            strcmp(tokens[i].lexeme, "SCanf") == 0 || strcmp(tokens[i].lexeme, "ScAnf") == 0 || 
-            strcmp(tokens[i].lexeme, "ScaNf") == 0 ||  strcmp(tokens[i].lexeme, "ScanF") == 0 || 
-            strcmp(tokens[i].lexeme, "sCAnf") == 0 || strcmp(tokens[i].lexeme, "sCaNf") == 0 || 
-            strcmp(tokens[i].lexeme, "sCanF") == 0 ||  strcmp(tokens[i].lexeme, "scANf") == 0 || 
-            strcmp(tokens[i].lexeme, "scAnF") == 0 ||  strcmp(tokens[i].lexeme, "scaNF") == 0 || 
-            strcmp(tokens[i].lexeme, "SCAnf") == 0 ||  strcmp(tokens[i].lexeme, "SCaNf") == 0 || 
-            strcmp(tokens[i].lexeme, "SCanF") == 0 ||  strcmp(tokens[i].lexeme, "ScANf") == 0 || 
-            strcmp(tokens[i].lexeme, "ScAnF") == 0 ||  strcmp(tokens[i].lexeme, "ScaNF") == 0 || 
-            strcmp(tokens[i].lexeme, "sCANf") == 0 || strcmp(tokens[i].lexeme, "sCAnF") == 0 || 
-            strcmp(tokens[i].lexeme, "sCaNF") == 0 || strcmp(tokens[i].lexeme, "scANF") == 0 || 
-            strcmp(tokens[i].lexeme, "SCANf") == 0 || strcmp(tokens[i].lexeme, "ScANF") == 0 || 
-            strcmp(tokens[i].lexeme, "sCANF") == 0 || strcmp(tokens[i].lexeme, "SCANF") == 0)) 
-            {
-            
-            reportError("Case sensitivity error: 'scanf' is lowercase in C", tokens[i].line, tokens[i].column);
+        // Check if format specifier count matches argument count
+        if (formatSpecCount != argCount) {
+            reportError(ERROR_SCANF_COUNT, i, formatSpecCount, argCount);
         }
     }
+    
+    // Check for case sensitivity errors - "Scanf" instead of "scanf"
+    if (tokenTypes[i] == TOKEN_IDENTIFIER && isScanfCaseVariant(tokenText(i), tokenLengths[i])) {
+        reportError(ERROR_SCANF_CASE, i);
+    }
 }
 
 /**
  * Checks if an identifier is a C keyword
  */
-bool isKeyword(const char *identifier) {
-    for (int i = 0; i < MAX_KEYWORDS; i++) {
-        if (strcmp(identifier, keywords[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+bool isKeyword(const char *identifier, int length) {
+    return lookupKeyword(identifier, length) >= 0;
 }
 
 /**
- * Checks if an identifier is a standard library function
+ * Checks if an identifier is a C11 standard library function
  */
-bool isStdLibFunction(const char *identifier) {
-    for (int i = 0; i < sizeof(stdLibFunctions) / sizeof(stdLibFunctions[0]); i++) {
-        if (strcmp(identifier, stdLibFunctions[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+bool isStdLibFunction(const char *identifier, int length) {
+    return lookupStdLibFunction(identifier, length) >= 0;
+}
+
+/**
+ * Checks whether a name is a standard library function's name with the
+ * wrong case, and that function is the given one
+ */
+static bool isMiscapitalized(const char *name, int length, const char *function) {
+    FuzzyMatch match = fuzzyMatch(&stdLibDictionary, name, length, 0);
+    return match.word >= 0 && !match.exact && strcmp(stdLibFunctionNames[match.word], function) == 0;
+}
+
+/**
+ * Checks whether a name is a miscapitalized printf
+ */
+bool isPrintfCaseVariant(const char *name, int length) {
+    return isMiscapitalized(name, length, "printf");
+}
+
+/**
+ * Checks whether a name is a miscapitalized scanf
+ */
+bool isScanfCaseVariant(const char *name, int length) {
+    return isMiscapitalized(name, length, "scanf");
 }
 
 /**
@@ -1798,70 +3691,427 @@ int getTypeSize(const char *type) {
 }
 
 /**
- * Reports an error, storing it in the errors array
+ * Prints an error, or, inside the pass engine, holds it back until the
+ * passes before the current one have been printed
+ */
+void recordError(const Error *error) {
+    Pass *pass = currentPass;
+    
+    if (!pass) {
+        printError(error);
+        return;
+    }
+    if (reportLocking) {
+        pthread_mutex_lock(&reportLock);
+    }
+    pass->reported++;
+    if (pass->streaming) {
+        printError(error);
+    } else {
+        pass->errors = arenaGrowArray(pass->arena, pass->errors, pass->errorCount, &pass->errorCapacity, sizeof(Error));
+        pass->errors[pass->errorCount++] = *error;
+    }
+    if (reportLocking) {
+        pthread_mutex_unlock(&reportLock);
+    }
+}
+
+/**
+ * Counts an error and writes it out
+ */
+void printError(const Error *error) {
+#ifdef KEEP_ERROR_RECORDS
+    if (errorCount == errorCapacity) {
+        errorCapacity = errorCapacity ? errorCapacity * 2 : 1024;
+        errors = realloc(errors, errorCapacity * sizeof(Error));
+        if (!errors) {
+            printf("Error: Out of memory (error records)\n");
+            exit(1);
+        }
+    }
+    errors[errorCount] = *error;
+#endif
+    errorCount++;
+    errorCategoryCounts[errorKinds[error->code].category]++;
+    emitError(error);
+}
+
+/**
+ * Renders an error, the one time it is shown, straight into the output buffer
+ */
+void emitError(const Error *error) {
+    if (reportFormat != REPORT_TEXT) {
+        emitErrorObject(error);
+        return;
+    }
+    
+    char *line = sinkReserve(&output, MAX_ERROR_LINE_LENGTH);
+    int length = snprintf(line, MAX_ERROR_LINE_LENGTH - MAX_ERROR_MSG_LENGTH, "Error at line %d, column %d: ",
+                          errorLine(error), errorColumn(error));
+    
+    length += formatError(error, line + length, MAX_ERROR_MSG_LENGTH);
+    line[length++] = '\n';
+    sinkCommit(&output, length);
+    
+    if (showSnippets && error->offset >= 0) {
+        emitSnippet(error);
+    }
+}
+
+/**
+ * Shows the source line an error points at, sliced straight out of the
+ * source by the line-start index, with a caret under its column
+ */
+void emitSnippet(const Error *error) {
+    int lineNumber = errorLine(error);
+    int column = errorColumn(error);
+    const char *text = sourceCode + lineStarts[lineNumber - 1];
+    size_t end = lineNumber < lineCount ? lineStarts[lineNumber] - 1 : sourceLength;
+    size_t length = end - lineStarts[lineNumber - 1];
+    
+    // Shown up to a carriage return, a stray NUL, or MAX_LINE_LENGTH bytes
+    if (length > MAX_LINE_LENGTH) {
+        length = MAX_LINE_LENGTH;
+    }
+    const char *stop = memchr(text, '\0', length);
+    if (stop) {
+        length = stop - text;
+    }
+    if (length > 0 && text[length - 1] == '\r') {
+        length--;
+    }
+    
+    char *snippet = sinkReserve(&output, 2 * MAX_LINE_LENGTH + 32);
+    int used = sprintf(snippet, "%6d | ", lineNumber);
+    memcpy(snippet + used, text, length);
+    used += (int)length;
+    snippet[used++] = '\n';
+    
+    // Line-only errors get no caret
+    if (column > 0) {
+        used += sprintf(snippet + used, "       | ");
+        for (int i = 0; i < column - 1 && i <= MAX_LINE_LENGTH; i++) {
+            // Tabs are kept so the caret lines up however they are shown
+            snippet[used++] = (size_t)i < length && text[i] == '\t' ? '\t' : ' ';
+        }
+        snippet[used++] = '^';
+        snippet[used++] = '\n';
+    }
+    sinkCommit(&output, used);
+}
+
+/**
+ * Writes a string to the report
+ */
+void emitText(const char *text) {
+    sinkWrite(&output, text, strlen(text));
+}
+
+/**
+ * Writes the names an error suggests instead of what was written, as a
+ * JSON array: the headers, keywords, functions and declared names its
+ * message offers
+ */
+void emitSuggestions(const Error *error) {
+    const int *arg = error->args;
+    const int *end = error->args + errorKinds[error->code].argCount;
+    int count = 0;
+    
+    emitText("[");
+    for (const char *p = errorKinds[error->code].message; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        switch (*++p) {
+            case 'c':
+            case 'd':
+            case 'y':
+            case 'l':
+                arg++;
+                break;
+            case 's':
+                arg += 2;
+                break;
+            case 'h':
+            case 'k':
+            case 'f': {
+                const char *name = *p == 'h' ? stdHeaders[*arg] : *p == 'k' ? keywordNames[*arg] : stdLibFunctionNames[*arg];
+                emitText(count++ > 0 ? "," : "");
+                sinkJsonString(&output, name, strlen(name));
+                arg++;
+                break;
+            }
+            case 'm':
+                for (; arg < end && *arg >= 0; arg++) {
+                    emitText(count++ > 0 ? "," : "");
+                    sinkJsonString(&output, identifierTable.texts[*arg], identifierTable.lengths[*arg]);
+                }
+                break;
+        }
+    }
+    emitText("]");
+}
+
+/**
+ * Writes an error as one JSON object of the diagnostics array, or one
+ * SARIF result, on a line of its own
+ */
+void emitErrorObject(const Error *error) {
+    const ErrorKind *kind = &errorKinds[error->code];
+    char message[MAX_ERROR_MSG_LENGTH];
+    int length = formatError(error, message, sizeof(message));
+    
+    emitText(reportedErrors++ > 0 ? ",\n" : "\n");
+    if (reportFormat == REPORT_JSON) {
+        sinkPrintf(&output, "{\"code\":\"%s\",\"category\":\"%s\",\"line\":%d,\"column\":%d,\"message\":",
+                   kind->name, categoryNames[kind->category], errorLine(error), errorColumn(error));
+        sinkJsonString(&output, message, length);
+        emitText(",\"suggestions\":");
+        emitSuggestions(error);
+        emitText("}");
+        return;
+    }
+    
+    // SARIF lines and columns start at 1; an error about the whole file has no region
+    sinkPrintf(&output, "{\"ruleId\":\"%s\",\"ruleIndex\":%d,\"level\":\"error\",\"message\":{\"text\":",
+               kind->name, error->code);
+    sinkJsonString(&output, message, length);
+    emitText("},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":");
+    sinkJsonString(&output, reportSource, strlen(reportSource));
+    emitText("}");
+    if (error->offset >= 0) {
+        sinkPrintf(&output, ",\"region\":{\"startLine\":%d", errorLine(error));
+        if (errorColumn(error) > 0) {
+            sinkPrintf(&output, ",\"startColumn\":%d", errorColumn(error));
+        }
+        emitText("}");
+    }
+    sinkPrintf(&output, "}}],\"properties\":{\"category\":\"%s\",\"suggestions\":", categoryNames[kind->category]);
+    emitSuggestions(error);
+    emitText("}}");
+}
+
+/**
+ * Opens the JSON document or SARIF log the errors are streamed into
+ */
+void beginReport() {
+    if (reportFormat == REPORT_JSON) {
+        emitText("{\"file\":");
+        sinkJsonString(&output, reportSource, strlen(reportSource));
+        emitText(",\"diagnostics\":[");
+    } else if (reportFormat == REPORT_SARIF) {
+        sinkPrintf(&output, "{\"version\":\"2.1.0\",\"$schema\":\"%s\",\"runs\":[{\"tool\":{\"driver\":{\"name\":\"%s\",\"rules\":[",
+                   "https://json.schemastore.org/sarif-2.1.0.json", "c-syntax-checker");
+        for (int code = 0; code < ERROR_CODE_COUNT; code++) {
+            sinkPrintf(&output, "%s\n{\"id\":\"%s\",\"properties\":{\"category\":\"%s\"}}", code > 0 ? "," : "",
+                       errorKinds[code].name, categoryNames[errorKinds[code].category]);
+        }
+        emitText("]}},\"results\":[");
+    }
+}
+
+/**
+ * Closes the JSON document, with the error counts, or the SARIF log
  */
-void reportError(const char *message, int line, int column) {
-    if (errorCount < MAX_TOKENS) {
-        strcpy(errors[errorCount].message, message);
-        errors[errorCount].line = line;
-        errors[errorCount].column = column;
-        errorCount++;
+void endReport() {
+    if (reportFormat == REPORT_JSON) {
+        sinkPrintf(&output, "\n],\"errorCount\":%d,\"categories\":{", errorCount);
+        for (int c = 0; c < ERROR_CATEGORY_COUNT; c++) {
+            sinkPrintf(&output, "%s\"%s\":%d", c > 0 ? "," : "", categoryNames[c], errorCategoryCounts[c]);
+        }
+        emitText("}}\n");
+    } else if (reportFormat == REPORT_SARIF) {
+        emitText("\n]}]}\n");
+    }
+}
+
+/**
+ * Prints part of the report; quiet mode, JSON and SARIF leave out all but
+ * the errors
+ */
+void printReport(const char *format, ...) {
+    va_list arguments;
+    
+    if (quietMode || reportFormat != REPORT_TEXT) {
+        return;
+    }
+    va_start(arguments, format);
+    sinkVprintf(&output, format, arguments);
+    va_end(arguments);
+}
+
+/**
+ * Adds a phase or pass to the --profile record; does nothing without it
+ */
+void profilePhase(const char *name, double seconds, long long tokens, long long diagnostics, unsigned long long bytes) {
+    if (!profiling) {
+        return;
+    }
+    ProfileEntry *entry = profileRecord(&profile, name, seconds);
+    entry->tokens += tokens;
+    entry->diagnostics += diagnostics;
+    entry->bytes += bytes;
+}
+
+/**
+ * Writes the --profile record once the report is done: a table on the
+ * terminal, or JSON when it goes to a file
+ */
+void writeProfile() {
+    if (profileOutput.kind == SINK_FILE) {
+        profileWriteJson(&profile, &profileOutput);
+    } else {
+        profileWriteTable(&profile, &profileOutput);
+    }
+}
+
+/**
+ * Reports an error about a token at the given position, taking the
+ * arguments errorKinds[code] asks for as ints
+ */
+static void reportErrorArgs(ErrorCode code, int token, int offset, va_list arguments) {
+    Error error = {.code = (unsigned short)code, .token = token, .offset = offset};
+    
+    for (int k = 0; k < errorKinds[code].argCount; k++) {
+        error.args[k] = va_arg(arguments, int);
+    }
+    recordError(&error);
+}
+
+/**
+ * Returns the 1-based line an error points at, 0 for the whole file
+ */
+int errorLine(const Error *error) {
+    return error->offset < 0 ? 0 : offsetLine((unsigned int)error->offset);
+}
+
+/**
+ * Returns the 1-based column an error points at, 0 if it points at a whole
+ * line or the whole file
+ */
+int errorColumn(const Error *error) {
+    if (error->offset < 0 || errorKinds[error->code].wholeLine) {
+        return 0;
+    }
+    return error->offset - (int)lineStarts[errorLine(error) - 1] + 1;
+}
+
+/**
+ * Reports an error at the start of a token
+ */
+void reportError(ErrorCode code, int token, ...) {
+    va_list arguments;
+    va_start(arguments, token);
+    reportErrorArgs(code, token, (int)tokenOffsets[token], arguments);
+    va_end(arguments);
+}
+
+/**
+ * Reports an error about a token, or no token (-1), at a source offset, or
+ * about the whole file (-1)
+ */
+void reportErrorAt(ErrorCode code, int token, int offset, ...) {
+    va_list arguments;
+    va_start(arguments, offset);
+    reportErrorArgs(code, token, offset, arguments);
+    va_end(arguments);
+}
+
+/**
+ * Appends count bytes of text to a message buffer, as many as fit before
+ * its terminator
+ */
+static void appendText(char *buffer, size_t size, size_t *length, const char *text, size_t count) {
+    if (count > size - 1 - *length) {
+        count = size - 1 - *length;
+    }
+    memcpy(buffer + *length, text, count);
+    *length += count;
+}
+
+/**
+ * Writes the message of an error into a buffer of the given size, cutting
+ * it short if it does not fit. Returns its length.
+ */
+int formatError(const Error *error, char *buffer, size_t size) {
+    const char *format = errorKinds[error->code].message;
+    const int *arg = error->args;
+    size_t length = 0;
+    
+    for (const char *p = format; *p; p++) {
+        if (*p != '%') {
+            appendText(buffer, size, &length, p, 1);
+            continue;
+        }
         
-        printf("Error at line %d, column %d: %s\n", line, column, message);
+        char number[48];
+        const char *text;
+        switch (*++p) {
+            case 'c': {
+                char c = (char)*arg++;
+                appendText(buffer, size, &length, &c, 1);
+                break;
+            }
+            case 'd':
+                appendText(buffer, size, &length, number, snprintf(number, sizeof(number), "%d", *arg++));
+                break;
+            case 't':
+                appendText(buffer, size, &length, tokenText(error->token), tokenLengths[error->token]);
+                break;
+            case 'l':
+                appendText(buffer, size, &length, number,
+                           snprintf(number, sizeof(number), "line %d, column %d", tokenLine(*arg), tokenColumn(*arg)));
+                arg++;
+                break;
+            case 's':
+                appendText(buffer, size, &length, tokenText(error->token) + arg[0], arg[1]);
+                arg += 2;
+                break;
+            case 'h':
+            case 'k':
+            case 'f':
+            case 'y':
+                text = *p == 'h' ? stdHeaders[*arg] : *p == 'k' ? keywordNames[*arg] :
+                       *p == 'f' ? stdLibFunctionNames[*arg] : declarations[*arg].type;
+                arg++;
+                appendText(buffer, size, &length, text, strlen(text));
+                break;
+            case 'm': {
+                int count = 0;
+                // Only the arguments the kind takes: the rest are left zero, not -1
+                while (arg + count < error->args + errorKinds[error->code].argCount && arg[count] >= 0) {
+                    count++;
+                }
+                for (int k = 0; k < count; k++) {
+                    const char *separator = k == 0 ? ", did you mean '" : k == count - 1 ? " or '" : ", '";
+                    appendText(buffer, size, &length, separator, strlen(separator));
+                    appendText(buffer, size, &length, identifierTable.texts[arg[k]], identifierTable.lengths[arg[k]]);
+                    appendText(buffer, size, &length, k == count - 1 ? "'?" : "'", k == count - 1 ? 2 : 1);
+                }
+                arg += count;
+                break;
+            }
+            default:
+                appendText(buffer, size, &length, p, 1);
+                break;
+        }
     }
+    buffer[length] = '\0';
+    return (int)length;
 }
 
 /**
  * Prints the analysis results
  */
 void printResults() {
-    printf("\n=== C SYNTAX CHECKER RESULTS ===\n\n");
+    printReport("\n=== C SYNTAX CHECKER RESULTS ===\n\n");
     
     // Print errors
-    printf("ERRORS FOUND: %d\n", errorCount);
+    // Each error was printed as it was found; it is not rendered again here
+    printReport("ERRORS FOUND: %d\n", errorCount);
     if (errorCount > 0) {
-        printf("---------------------------\n");
-        for (int i = 0; i < errorCount; i++) {
-            printf("Error #%d at line %d, column %d: %s\n", 
-                   i + 1, errors[i].line, errors[i].column, errors[i].message);
-        }
-        printf("---------------------------\n\n");
-    }// Improved error categorization for include statements
-    int headerErrors = 0, bracketErrors = 0, semicolonErrors = 0, quoteErrors = 0, variableErrors = 0, otherErrors = 0;
-
-for (int i = 0; i < errorCount; i++) {
-    // Comprehensive check for header/include errors
-    if (strstr(errors[i].message, "header") != NULL || 
-        strstr(errors[i].message, "stdio") != NULL ||
-        strstr(errors[i].message, "include") != NULL ||
-        strstr(errors[i].message, "No such file") != NULL ||
-        strstr(errors[i].message, "cannot find") != NULL ||
-        strstr(errors[i].message, "Missing space") != NULL ||
-        strstr(errors[i].message, "space after") != NULL ||
-        strstr(errors[i].message, "expected") != NULL ||
-        strstr(errors[i].message, "not found") != NULL ||
-        strstr(errors[i].message, "file path") != NULL ||
-        strstr(errors[i].message, "directory") != NULL ||
-        strstr(errors[i].message, "path") != NULL ||
-        (strstr(errors[i].message, "case") != NULL && strstr(errors[i].message, "include") != NULL)) {
-        headerErrors++;
-    } else if (strstr(errors[i].message, "bracket") != NULL || 
-               strstr(errors[i].message, "parenthesis") != NULL ||
-               strstr(errors[i].message, "brace") != NULL || 
-               strstr(errors[i].message, "delimiter") != NULL) {
-        bracketErrors++;
-    } else if (strstr(errors[i].message, "semicolon") != NULL) {
-        semicolonErrors++;
-    } else if (strstr(errors[i].message, "quote") != NULL || 
-               strstr(errors[i].message, "string") != NULL ||
-               strstr(errors[i].message, "character") != NULL) {
-        quoteErrors++;
-    } else if (strstr(errors[i].message, "variable") != NULL) {
-        variableErrors++;
-    } else {
-        otherErrors++;
+        printReport("\n");
     }
-}
 // Print function statistics
 int userDefinedCount = 0;
 int userDefinedPrototypes = 0;
@@ -1879,31 +4129,31 @@ for (int i = 0; i < functionCount; i++) {
     }
 }
 
-printf("FUNCTION ANALYSIS:\n");
-printf("---------------------------\n");
-printf("Total functions found: %d\n", functionCount);
-printf("User-defined functions: %d\n", userDefinedCount);
-printf("User-defined prototypes: %d\n", userDefinedPrototypes);
-printf("Standard library functions: %d\n", stdLibCount);
-printf("---------------------------\n\n");
+printReport("FUNCTION ANALYSIS:\n");
+printReport("---------------------------\n");
+printReport("Total functions found: %d\n", functionCount);
+printReport("User-defined functions: %d\n", userDefinedCount);
+printReport("User-defined prototypes: %d\n", userDefinedPrototypes);
+printReport("Standard library functions: %d\n", stdLibCount);
+printReport("---------------------------\n\n");
     // Print function details
-    printf("FUNCTION DETAILS:\n");
-    printf("---------------------------\n");
-    printf("%-30s %-15s %-10s %-10s\n", "Name", "Type", "Prototype", "Line");
-    printf("---------------------------\n");
+    printReport("FUNCTION DETAILS:\n");
+    printReport("---------------------------\n");
+    printReport("%-30s %-15s %-10s %-10s\n", "Name", "Type", "Prototype", "Line");
+    printReport("---------------------------\n");
     for (int i = 0; i < functionCount; i++) {
-        printf("%-30s %-15s %-10s %-10d\n", 
+        printReport("%-30s %-15s %-10s %-10d\n", 
                functions[i].name, 
                functions[i].isUserDefined ? "User-defined" : "Standard Lib",
                functions[i].isPrototype ? "Yes" : "No",
                functions[i].line);
     }
-    printf("---------------------------\n\n");
+    printReport("---------------------------\n\n");
     
     // Print variable statistics
-    printf("VARIABLE ANALYSIS:\n");
-    printf("---------------------------\n");
-    printf("Total variables found: %d\n", variableCount);
+    printReport("VARIABLE ANALYSIS:\n");
+    printReport("---------------------------\n");
+    printReport("Total variables found: %d\n", variableCount);
     
     int intCount = 0, charCount = 0, floatCount = 0, doubleCount = 0, otherCount = 0;
     int arrayCount = 0;
@@ -1926,35 +4176,35 @@ printf("---------------------------\n\n");
         }
     }
     
-    printf("  int variables: %d\n", intCount);
-    printf("  char variables: %d\n", charCount);
-    printf("  float variables: %d\n", floatCount);
-    printf("  double variables: %d\n", doubleCount);
-    printf("  other variables: %d\n", otherCount);
-    printf("  array variables: %d\n", arrayCount);
-    printf("---------------------------\n\n");
+    printReport("  int variables: %d\n", intCount);
+    printReport("  char variables: %d\n", charCount);
+    printReport("  float variables: %d\n", floatCount);
+    printReport("  double variables: %d\n", doubleCount);
+    printReport("  other variables: %d\n", otherCount);
+    printReport("  array variables: %d\n", arrayCount);
+    printReport("---------------------------\n\n");
     
     // Print variable details
-    printf("VARIABLE DETAILS:\n");
-    printf("---------------------------\n");
-    printf("%-20s %-10s %-10s %-10s %-10s\n", "Name", "Type", "Size", "Array", "Line");
-    printf("---------------------------\n");
+    printReport("VARIABLE DETAILS:\n");
+    printReport("---------------------------\n");
+    printReport("%-20s %-10s %-10s %-10s %-10s\n", "Name", "Type", "Size", "Array", "Line");
+    printReport("---------------------------\n");
     for (int i = 0; i < variableCount; i++) {
-        printf("%-20s %-10s %-10d %-10s %-10d\n", 
+        printReport("%-20s %-10s %-10d %-10s %-10d\n", 
                variables[i].name, 
                variables[i].type, 
                variables[i].size * (variables[i].isArray ? variables[i].arraySize : 1),
                variables[i].isArray ? "Yes" : "No",
                variables[i].line);
     }
-    printf("---------------------------\n\n");
+    printReport("---------------------------\n\n");
     
     // Print token statistics
     int idCount = 0, kwCount = 0, numCount = 0, strCount = 0, charLitCount = 0, 
         opCount = 0, sepCount = 0, ppCount = 0, commCount = 0;
     
     for (int i = 0; i < tokenCount; i++) {
-        switch (tokens[i].type) {
+        switch (tokenTypes[i]) {
             case TOKEN_IDENTIFIER: idCount++; break;
             case TOKEN_KEYWORD: kwCount++; break;
             case TOKEN_NUMBER: numCount++; break;
@@ -1968,37 +4218,37 @@ printf("---------------------------\n\n");
         }
     }
     
-    printf("TOKEN STATISTICS:\n");
-    printf("---------------------------\n");
-    printf("Total tokens: %d\n", tokenCount - 1); // Exclude EOF token
-    printf("  Identifiers: %d\n", idCount);
-    printf("  Keywords: %d\n", kwCount);
-    printf("  Numbers: %d\n", numCount);
-    printf("  String literals: %d\n", strCount);
-    printf("  Character literals: %d\n", charLitCount);
-    printf("  Operators: %d\n", opCount);
-    printf("  Separators: %d\n", sepCount);
-    printf("  Preprocessor directives: %d\n", ppCount);
-    printf("  Comments: %d\n", commCount);
-    printf("---------------------------\n\n");
+    printReport("TOKEN STATISTICS:\n");
+    printReport("---------------------------\n");
+    printReport("Total tokens: %d\n", tokenCount - 1); // Exclude EOF token
+    printReport("  Identifiers: %d\n", idCount);
+    printReport("  Keywords: %d\n", kwCount);
+    printReport("  Numbers: %d\n", numCount);
+    printReport("  String literals: %d\n", strCount);
+    printReport("  Character literals: %d\n", charLitCount);
+    printReport("  Operators: %d\n", opCount);
+    printReport("  Separators: %d\n", sepCount);
+    printReport("  Preprocessor directives: %d\n", ppCount);
+    printReport("  Comments: %d\n", commCount);
+    printReport("---------------------------\n\n");
     
     // Summary statistics
-    printf("CODE SUMMARY:\n");
-    printf("---------------------------\n");
-    printf("Memory usage: %d bytes\n", totalMemory ); // Calculated in calculateMemoryUsage
-    printf("Error density: %.2f errors per 100 tokens\n", 
+    printReport("CODE SUMMARY:\n");
+    printReport("---------------------------\n");
+    printReport("Memory usage: %d bytes\n", totalMemory ); // Calculated in calculateMemoryUsage
+    printReport("Error density: %.2f errors per 100 tokens\n", 
            (float)errorCount / (tokenCount - 1) * 100);
-    printf("Function to variable ratio: %.2f\n", 
+    printReport("Function to variable ratio: %.2f\n", 
            (float)functionCount / (variableCount > 0 ? variableCount : 1));
-    printf("---------------------------\n");
+    printReport("---------------------------\n");
     
     // Overall verdict
-    printf("\nVERDICT: ");
+    printReport("\nVERDICT: ");
     if (errorCount == 0) {
-        printf("No syntax errors detected. Code appears to be syntactically correct.\n");
+        printReport("No syntax errors detected. Code appears to be syntactically correct.\n");
     } else if (errorCount < 5) {
-        printf("Minor syntax issues detected. Consider addressing them before compilation.\n");
+        printReport("Minor syntax issues detected. Consider addressing them before compilation.\n");
     } else {
-        printf("Significant syntax issues detected. Please fix the errors before proceeding.\n");
+        printReport("Significant syntax issues detected. Please fix the errors before proceeding.\n");
     }
 }
\ No newline at end of file
@@ -0,0 +1,369 @@
+/* Lexer throughput benchmark.
+ *
+ * Times latest.c's table-driven lexer, once per skip-kernel level the CPU
+ * supports and once split across threads, against the branchy
+ * isspace/strchr lexer it replaced and prints MB/s for each. latest.c is compiled in directly, so its main()
+ * is renamed out of the way.
+ *
+ *     gcc -O2 -o lexer_benchmark lexer_benchmark.c arena.c simd_scan.c dictionaries.c intern.c thread_pool.c scope.c fuzzy.c suggest.c format.c parser.c sink.c profile.c -pthread
+ *     ./lexer_benchmark [source_file] [repetitions]
+ *
+ * Without a file, a synthetic input of about 16 MB is generated.
+ */
+#include <time.h>
+
+#define main latestMain
+#include "latest.c"
+#undef main
+
+#define BENCH_DEFAULT_SIZE (16 * 1024 * 1024)
+#define BENCH_DEFAULT_REPETITIONS 10
+
+/* One unit of the synthetic input */
+static const char *benchSnippet =
+    "#include <stdio.h>\n"
+    "/*\n"
+    " * Sums the even entries of an array. Entries equal to -1 mark unused\n"
+    " * slots and are skipped; the result is printed before it is returned.\n"
+    " */\n"
+    "static long sumEven(const int *values, int count) {\n"
+    "    long total = 0; // running sum\n"
+    "    for (int i = 0; i < count; i++) {\n"
+    "        if ((values[i] & 1) == 0 && values[i] != -1) {\n"
+    "            total += values[i] << 1 >> 1;\n"
+    "        }\n"
+    "    }\n"
+    "    printf(\"%ld items, ratio %.2f\\n\", total, 0.5e+1);\n"
+    "    return total > 0x7fff ? 'x' : total;\n"
+    "}\n\n";
+
+/**
+ * Returns the kind of a one- or two-character punctuator
+ */
+static TokenKind branchyPunctuatorKind(const char *text, int length) {
+    if (length == 2) {
+        switch (text[0]) {
+            case '+': return text[1] == '+' ? KIND_INCREMENT : KIND_PLUS_ASSIGN;
+            case '-': return text[1] == '-' ? KIND_DECREMENT : text[1] == '>' ? KIND_ARROW : KIND_MINUS_ASSIGN;
+            case '=': return KIND_EQUAL;
+            case '!': return KIND_NOT_EQUAL;
+            case '<': return KIND_LESS_EQUAL;
+            case '>': return KIND_GREATER_EQUAL;
+            case '&': return text[1] == '&' ? KIND_AND : KIND_AND_ASSIGN;
+            case '|': return text[1] == '|' ? KIND_OR : KIND_OR_ASSIGN;
+            case '*': return KIND_STAR_ASSIGN;
+            case '/': return KIND_SLASH_ASSIGN;
+            case '%': return KIND_PERCENT_ASSIGN;
+            case '^': return KIND_XOR_ASSIGN;
+            default: return KIND_NONE;
+        }
+    }
+    
+    switch (text[0]) {
+        case '(': return KIND_LPAREN;
+        case ')': return KIND_RPAREN;
+        case '{': return KIND_LBRACE;
+        case '}': return KIND_RBRACE;
+        case '[': return KIND_LBRACKET;
+        case ']': return KIND_RBRACKET;
+        case ';': return KIND_SEMICOLON;
+        case ',': return KIND_COMMA;
+        case '.': return KIND_DOT;
+        case '+': return KIND_PLUS;
+        case '-': return KIND_MINUS;
+        case '*': return KIND_STAR;
+        case '/': return KIND_SLASH;
+        case '%': return KIND_PERCENT;
+        case '=': return KIND_ASSIGN;
+        case '<': return KIND_LESS;
+        case '>': return KIND_GREATER;
+        case '!': return KIND_NOT;
+        case '&': return KIND_AMPERSAND;
+        case '|': return KIND_PIPE;
+        case '^': return KIND_CARET;
+        case '~': return KIND_TILDE;
+        case '?': return KIND_QUESTION;
+        case ':': return KIND_COLON;
+        default: return KIND_NONE;
+    }
+}
+
+/**
+ * Keyword lookup as the previous lexer did it, one strncmp per keyword
+ */
+static int branchyKeywordIndex(const char *identifier, int length) {
+    for (int i = 0; i < KEYWORD_COUNT; i++) {
+        if (strncmp(identifier, keywordNames[i], length) == 0 && keywordNames[i][length] == '\0') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Line-start bookkeeping as the previous lexer did it, one entry per newline
+ */
+static void branchyAddLineStart(unsigned int offset) {
+    lineStarts = arenaGrowArray(&analysisArena, lineStarts, lineCount, &lineCapacity, sizeof(lineStarts[0]));
+    lineStarts[lineCount++] = offset;
+}
+
+/**
+ * The previous lexer: an if chain over isspace/isdigit/isalpha and strchr
+ */
+static void branchyLexSource() {
+    char *current = sourceCode;
+    char *start;
+    
+    tokenCount = 0;
+    if (tokenCapacity < (int)(sourceLength / 4) + 64) {
+        reserveTokens((int)(sourceLength / 4) + 64);
+    }
+    lineCount = 0;
+    branchyAddLineStart(0);
+    
+    while (*current != '\0') {
+        // Skip whitespace
+        if (isspace(*current)) {
+            if (*current == '\n') {
+                branchyAddLineStart(current + 1 - sourceCode);
+            }
+            current++;
+            continue;
+        }
+        
+        // Handle comments
+        if (*current == '/' && *(current + 1) == '/') {
+            // Single-line comment
+            while (*current != '\0' && *current != '\n') {
+                current++;
+            }
+            continue;
+        }
+        
+        if (*current == '/' && *(current + 1) == '*') {
+            // Multi-line comment
+            current += 2;
+            while (*current != '\0' && !(*current == '*' && *(current + 1) == '/')) {
+                if (*current == '\n') {
+                    branchyAddLineStart(current + 1 - sourceCode);
+                }
+                current++;
+            }
+            if (*current != '\0') {
+                current += 2;
+            }
+            continue;
+        }
+        
+        start = current;
+        
+        // Handle preprocessor directives (the token spans the rest of the line)
+        if (*current == '#') {
+            while (*current != '\0' && *current != '\n') {
+                current++;
+            }
+            
+            addToken(TOKEN_PREPROCESSOR, KIND_NONE, start, current);
+            continue;
+        }
+        
+        // Handle string literals
+        if (*current == '"') {
+            current++;
+            
+            while (*current != '\0' && *current != '"') {
+                if (*current == '\\' && *(current + 1) != '\0') {
+                    // Skip escaped characters
+                    current++;
+                }
+                
+                if (*current == '\n') {
+                    branchyAddLineStart(current + 1 - sourceCode);
+                }
+                
+                current++;
+            }
+            
+            if (*current == '"') {
+                current++;
+            }
+            
+            addToken(TOKEN_STRING, KIND_NONE, start, current);
+            continue;
+        }
+        
+        // Handle character literals
+        if (*current == '\'') {
+            current++;
+            
+            while (*current != '\0' && *current != '\'') {
+                if (*current == '\\' && *(current + 1) != '\0') {
+                    // Skip escaped characters
+                    current++;
+                }
+                
+                if (*current == '\n') {
+                    branchyAddLineStart(current + 1 - sourceCode);
+                }
+                
+                current++;
+            }
+            
+            if (*current == '\'') {
+                current++;
+            }
+            
+            addToken(TOKEN_CHAR, KIND_NONE, start, current);
+            continue;
+        }
+        
+        // Handle numbers
+        if (isdigit(*current)) {
+            while (isdigit(*current) || *current == '.' || *current == 'e' || *current == 'E' ||
+                   *current == 'f' || *current == 'F' || *current == 'l' || *current == 'L' ||
+                   ((*current == '+' || *current == '-') && (*(current - 1) == 'e' || *(current - 1) == 'E'))) {
+                current++;
+            }
+            
+            addToken(TOKEN_NUMBER, KIND_NONE, start, current);
+            continue;
+        }
+        
+        // Handle identifiers and keywords
+        if (isalpha(*current) || *current == '_') {
+            while (isalnum(*current) || *current == '_') {
+                current++;
+            }
+            
+            int keyword = branchyKeywordIndex(start, (int)(current - start));
+            if (keyword >= 0) {
+                addToken(TOKEN_KEYWORD, KIND_AUTO + keyword, start, current);
+            } else {
+                addToken(TOKEN_IDENTIFIER, KIND_NONE, start, current);
+            }
+            continue;
+        }
+        
+        // Handle operators and separators
+        if (strchr("+-*/%%=<>!&|^~?:.,;()[]{}", *current)) {
+            // Handle multi-character operators
+            if ((*current == '+' && *(current + 1) == '+') ||
+                (*current == '-' && *(current + 1) == '-') ||
+                (*current == '=' && *(current + 1) == '=') ||
+                (*current == '!' && *(current + 1) == '=') ||
+                (*current == '<' && *(current + 1) == '=') ||
+                (*current == '>' && *(current + 1) == '=') ||
+                (*current == '&' && *(current + 1) == '&') ||
+                (*current == '|' && *(current + 1) == '|') ||
+                (*current == '+' && *(current + 1) == '=') ||
+                (*current == '-' && *(current + 1) == '=') ||
+                (*current == '*' && *(current + 1) == '=') ||
+                (*current == '/' && *(current + 1) == '=') ||
+                (*current == '%' && *(current + 1) == '=') ||
+                (*current == '&' && *(current + 1) == '=') ||
+                (*current == '|' && *(current + 1) == '=') ||
+                (*current == '^' && *(current + 1) == '=') ||
+                (*current == '-' && *(current + 1) == '>')) {
+                
+                current += 2;
+            } else {
+                current++;
+            }
+            
+            addToken((strchr(".,;()[]{}", *start)) ? TOKEN_SEPARATOR : TOKEN_OPERATOR,
+                     branchyPunctuatorKind(start, (int)(current - start)), start, current);
+            continue;
+        }
+        
+        // Skip unrecognized characters
+        current++;
+    }
+    
+    // Add EOF token (an empty view at the end of the source)
+    addToken(TOKEN_EOF, KIND_NONE, current, current);
+}
+
+/**
+ * Returns a monotonic timestamp in seconds
+ */
+static double benchNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Threads benchParallelLexer() lexes with */
+static int benchThreads = 1;
+
+/**
+ * Runs the parallel lexer with benchThreads threads
+ */
+static void benchParallelLexer() {
+    lexSourceInParallel(benchThreads);
+}
+
+/**
+ * Runs a lexer the given number of times and returns the best MB/s
+ */
+static double benchLexer(void (*lexer)(), int repetitions) {
+    double best = 0;
+    
+    for (int i = 0; i < repetitions; i++) {
+        double start = benchNow();
+        lexer();
+        double elapsed = benchNow() - start;
+        
+        if (elapsed > 0 && sourceLength / elapsed / 1e6 > best) {
+            best = sourceLength / elapsed / 1e6;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_REPETITIONS;
+    
+    if (argc > 1) {
+        readSourceFile(argv[1]);
+    } else {
+        size_t snippetLength = strlen(benchSnippet);
+        size_t copies = BENCH_DEFAULT_SIZE / snippetLength;
+        
+        sourceCode = malloc(copies * snippetLength + 1 + SIMD_SCAN_PADDING);
+        if (sourceCode == NULL) {
+            printf("Error: Out of memory\n");
+            exit(1);
+        }
+        for (size_t i = 0; i < copies; i++) {
+            memcpy(sourceCode + i * snippetLength, benchSnippet, snippetLength);
+        }
+        sourceLength = copies * snippetLength;
+        memset(sourceCode + sourceLength, 0, 1 + SIMD_SCAN_PADDING);
+        indexLines();
+    }
+    
+    printf("Input: %.1f MB, best of %d runs\n", sourceLength / 1e6, repetitions);
+    
+    double speed = benchLexer(branchyLexSource, repetitions);
+    printf("  branchy lexer:               %8.1f MB/s  (%d tokens)\n", speed, tokenCount);
+    
+    for (SimdLevel limit = SIMD_SCALAR; limit <= SIMD_AVX2; limit++) {
+        SimdLevel level = simdScanInit(limit);
+        if (level != limit) {
+            continue;   // Not supported by this CPU
+        }
+        
+        speed = benchLexer(lexSource, repetitions);
+        printf("  table-driven lexer, %-6s   %8.1f MB/s  (%d tokens)\n", simdLevelName(level), speed, tokenCount);
+    }
+    
+    // With the best kernels, which the loop above leaves selected
+    benchThreads = threadPoolDefaultSize();
+    speed = benchLexer(benchParallelLexer, repetitions);
+    printf("  parallel lexer, %3d threads   %8.1f MB/s  (%d tokens)\n", benchThreads, speed, tokenCount);
+    
+    releaseSourceFile();
+    arenaFree(&analysisArena);
+    return 0;
+}
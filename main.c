@@ -2,7 +2,6 @@
 #include <string.h>
 #include <ctype.h>
 #include "lexer.h"
-#include "parser.h"
 #include "symbol_table.h"
 #include "analysis.h"
 #include "types.h"
@@ -28,6 +27,77 @@ const char *strcasestr(const char *haystack, const char *needle) {
     return NULL; // No match found
 }
 
+// The number of elements of an array whose dimensions start at line, such
+// as "[20]" or "[3][4]", or 0 if one of them is not a constant
+static int arrayElements(const char *line) {
+    int elements = 1;
+
+    while (*line == '[') {
+        int dimension = 0;
+        int digits = 0;
+
+        line++;
+        while (*line == ' ' || *line == '\t') line++;
+        while (isdigit((unsigned char)*line)) {
+            dimension = dimension * 10 + (*line - '0');
+            digits++;
+            line++;
+        }
+        while (*line == ' ' || *line == '\t') line++;
+        if (digits == 0 || *line != ']') {
+            return 0;
+        }
+        elements *= dimension;
+        line++;
+        while (*line == ' ' || *line == '\t') line++;
+    }
+    return elements;
+}
+
+// Add the variable declared by a line starting with the given type, such
+// as "int x;" or "char name[20];", to the symbol table. Arrays and pointers
+// are recorded with "[]" or " *" after the type, so their uses can be told
+// from the type's. An array's size counts all its elements, and is
+// MEMORY_SIZE_UNKNOWN when a dimension is not a constant.
+void addDeclaredVariable(const char *line, const char *type, int size) {
+    char varName[NAME_LENGTH];
+    char typeName[NAME_LENGTH];
+    int typeLength = (int)strlen(type);
+    int pointer = 0;
+    int length = 0;
+
+    while (*line == ' ' || *line == '\t') line++;
+    if (strncmp(line, type, typeLength) != 0 || (line[typeLength] != ' ' && line[typeLength] != '*')) {
+        return;
+    }
+    line += typeLength;
+    while (*line == ' ' || *line == '\t' || *line == '*') {
+        pointer |= *line == '*';
+        line++;
+    }
+    while ((isalnum((unsigned char)line[length]) || line[length] == '_') && length < NAME_LENGTH - 1) {
+        varName[length] = line[length];
+        length++;
+    }
+    varName[length] = '\0';
+    line += length;
+    while (*line == ' ' || *line == '\t') line++;
+    if (length == 0 || *line == '(') {
+        return; // Not a variable: a function's declaration or definition
+    }
+
+    if (*line == '[') {
+        // An array of pointers is as big as that many pointers
+        int elements = arrayElements(line);
+        size = elements > 0 ? elements * (pointer ? (int)sizeof(void *) : size) : MEMORY_SIZE_UNKNOWN;
+    } else if (pointer) {
+        size = (int)sizeof(void *);
+    }
+
+    snprintf(typeName, sizeof(typeName), "%s%s", type, *line == '[' ? "[]" : pointer ? " *" : "");
+    addSymbol(varName, typeName, 1, 0, 0, NULL, size); // Add to symbol table
+}
+
 int main() {
     // Open the input file
     FILE *input = fopen("input.txt", "r");
@@ -47,24 +117,10 @@ int main() {
         removeComments(line);
 
         // Check for variable declarations and add to symbol table
-        if (strstr(line, "int") != NULL) {
-            char varName[NAME_LENGTH];
-            if (sscanf(line, "int %s", varName) == 1) { // Extract variable name
-                addSymbol(varName, "int", 1, 0, 0, NULL, sizeof(int)); // Add to symbol table
-            }
-        }
-        if (strstr(line, "double") != NULL) {
-            char varName[NAME_LENGTH];
-            if (sscanf(line, "double %s", varName) == 1) { // Extract variable name
-                addSymbol(varName, "double", 1, 0, 0, NULL, sizeof(double)); // Add to symbol table
-            }
-        }
-        if (strstr(line, "char") != NULL) {
-            char varName[NAME_LENGTH];
-            if (sscanf(line, "char %s", varName) == 1) { // Extract variable name
-                addSymbol(varName, "char", 1, 0, 0, NULL, sizeof(char)); // Add to symbol table
-            }
-        }
+        addDeclaredVariable(line, "int", sizeof(int));
+        addDeclaredVariable(line, "float", sizeof(float));
+        addDeclaredVariable(line, "double", sizeof(double));
+        addDeclaredVariable(line, "char", sizeof(char));
 
         // Check for function declarations and add to symbol table
         if (strstr(line, "int main()") != NULL) {
@@ -91,8 +147,6 @@ int main() {
             printf("Complex expression found at line %d.\n", lineNumber);
         }
 
-        parse(line, lineNumber);
-
         lineNumber++;
     }
 
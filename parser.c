@@ -1,10 +1,1034 @@
-#include "parser.h"
-#include "symbol_table.h"
-#include <stdio.h>
+#include <stdbool.h>
 #include <string.h>
+#include "parser.h"
+
+#define PARSE_MAX_DEPTH 256     // Nesting past this is skipped rather than recursed into
+
+// Where the parser stands in the token stream
+typedef struct {
+    const ParseInput *input;
+    Arena *arena;
+    Ast *ast;
+    int current;                // The next token that is not a comment or preprocessor line
+    int depth;                  // Statements and expressions being parsed, one inside the other
+    int lastErrorToken;         // So that one bad token is reported once
+    int blockDepth;             // Blocks the current token is in, 0 at file scope
+    unsigned char *typedefNames;    // typedefNames[symbol]: declared by a typedef
+} Parser;
+
+// Precedence of each binary operator, 0 for other kinds; higher binds tighter
+static const unsigned char binaryPrecedence[256] = {
+    [KIND_OR] = 1, [KIND_AND] = 2, [KIND_PIPE] = 3, [KIND_CARET] = 4, [KIND_AMPERSAND] = 5,
+    [KIND_EQUAL] = 6, [KIND_NOT_EQUAL] = 6,
+    [KIND_LESS] = 7, [KIND_GREATER] = 7, [KIND_LESS_EQUAL] = 7, [KIND_GREATER_EQUAL] = 7,
+    [KIND_SHIFT_LEFT] = 8, [KIND_SHIFT_RIGHT] = 8,
+    [KIND_PLUS] = 9, [KIND_MINUS] = 9,
+    [KIND_STAR] = 10, [KIND_SLASH] = 10, [KIND_PERCENT] = 10
+};
+
+// Kinds that assign
+static const unsigned char assignmentOperators[256] = {
+    [KIND_ASSIGN] = 1, [KIND_PLUS_ASSIGN] = 1, [KIND_MINUS_ASSIGN] = 1, [KIND_STAR_ASSIGN] = 1,
+    [KIND_SLASH_ASSIGN] = 1, [KIND_PERCENT_ASSIGN] = 1, [KIND_AND_ASSIGN] = 1, [KIND_OR_ASSIGN] = 1,
+    [KIND_XOR_ASSIGN] = 1, [KIND_SHIFT_LEFT_ASSIGN] = 1, [KIND_SHIFT_RIGHT_ASSIGN] = 1
+};
+
+// Kinds that start a prefix expression
+static const unsigned char prefixOperators[256] = {
+    [KIND_INCREMENT] = 1, [KIND_DECREMENT] = 1, [KIND_PLUS] = 1, [KIND_MINUS] = 1,
+    [KIND_NOT] = 1, [KIND_TILDE] = 1, [KIND_STAR] = 1, [KIND_AMPERSAND] = 1
+};
+
+// Keywords that may begin a declaration, and what they are
+enum {
+    SPECIFIER_NONE,
+    SPECIFIER_STORAGE,          // auto, extern, register, static, typedef
+    SPECIFIER_QUALIFIER,        // const, volatile
+    SPECIFIER_BASIC,            // char, double, float, int, long, short, signed, unsigned, void
+    SPECIFIER_RECORD            // struct, union, enum
+};
+
+static const unsigned char specifierKinds[256] = {
+    [KIND_AUTO] = SPECIFIER_STORAGE, [KIND_EXTERN] = SPECIFIER_STORAGE, [KIND_REGISTER] = SPECIFIER_STORAGE,
+    [KIND_STATIC] = SPECIFIER_STORAGE, [KIND_TYPEDEF] = SPECIFIER_STORAGE,
+    [KIND_CONST] = SPECIFIER_QUALIFIER, [KIND_VOLATILE] = SPECIFIER_QUALIFIER,
+    [KIND_CHAR] = SPECIFIER_BASIC, [KIND_DOUBLE] = SPECIFIER_BASIC, [KIND_FLOAT] = SPECIFIER_BASIC,
+    [KIND_INT] = SPECIFIER_BASIC, [KIND_LONG] = SPECIFIER_BASIC, [KIND_SHORT] = SPECIFIER_BASIC,
+    [KIND_SIGNED] = SPECIFIER_BASIC, [KIND_UNSIGNED] = SPECIFIER_BASIC, [KIND_VOID] = SPECIFIER_BASIC,
+    [KIND_STRUCT] = SPECIFIER_RECORD, [KIND_UNION] = SPECIFIER_RECORD, [KIND_ENUM] = SPECIFIER_RECORD
+};
+
+static int parseStatement(Parser *p);
+static int parseExpression(Parser *p);
+static int parseAssignment(Parser *p);
+static int parseConditional(Parser *p);
+static int parseUnary(Parser *p);
+static int parseDeclaration(Parser *p, bool allowFunction);
+static int parseTypeName(Parser *p);
+static int parseDeclarator(Parser *p, bool abstract);
+
+// The first significant token at or after index
+static int skipTrivia(const Parser *p, int index) {
+    const unsigned char *types = p->input->types;
+
+    while (types[index] == TOKEN_COMMENT || types[index] == TOKEN_PREPROCESSOR) {
+        index++;
+    }
+    return index;
+}
+
+// The significant token after index, staying on the final TOKEN_EOF
+static int nextToken(const Parser *p, int index) {
+    if (p->input->types[index] == TOKEN_EOF) {
+        return index;
+    }
+    return skipTrivia(p, index + 1);
+}
+
+static int kindAt(const Parser *p, int index) {
+    return p->input->kinds[index];
+}
+
+static int typeAt(const Parser *p, int index) {
+    return p->input->types[index];
+}
+
+static int peek(const Parser *p) {
+    return kindAt(p, p->current);
+}
+
+static bool atEnd(const Parser *p) {
+    return typeAt(p, p->current) == TOKEN_EOF;
+}
+
+// Move past the current token, returning it
+static int advance(Parser *p) {
+    int token = p->current;
+    p->current = nextToken(p, token);
+    return token;
+}
+
+static bool accept(Parser *p, int kind) {
+    if (peek(p) != kind) {
+        return false;
+    }
+    advance(p);
+    return true;
+}
+
+static void parseError(Parser *p, int token, const char *message) {
+    Ast *ast = p->ast;
+
+    if (token == p->lastErrorToken) {
+        return;
+    }
+    p->lastErrorToken = token;
+    ast->errors = arenaGrowArray(p->arena, ast->errors, ast->errorCount, &ast->errorCapacity, sizeof(ParseError));
+    ast->errors[ast->errorCount].token = token;
+    ast->errors[ast->errorCount].message = message;
+    ast->errorCount++;
+}
+
+static bool expect(Parser *p, int kind, const char *message) {
+    if (accept(p, kind)) {
+        return true;
+    }
+    parseError(p, p->current, message);
+    return false;
+}
+
+// Nodes move when the array grows, so they are handed around by index
+static int addNode(Parser *p, NodeKind kind, int token) {
+    Ast *ast = p->ast;
+
+    ast->nodes = arenaGrowArray(p->arena, ast->nodes, ast->count, &ast->capacity, sizeof(Node));
+    Node *node = &ast->nodes[ast->count];
+    node->kind = (unsigned char)kind;
+    node->op = 0;
+    node->flags = 0;
+    node->token = token;
+    node->firstChild = -1;
+    node->nextSibling = -1;
+    return ast->count++;
+}
+
+// Link child after *last under parent; -1 children are left out
+static void appendChild(Parser *p, int parent, int *last, int child) {
+    Node *nodes = p->ast->nodes;
+
+    if (child < 0) {
+        return;
+    }
+    if (*last < 0) {
+        nodes[parent].firstChild = child;
+    } else {
+        nodes[*last].nextSibling = child;
+    }
+    *last = child;
+}
+
+static int lastChild(const Parser *p, int parent) {
+    const Node *nodes = p->ast->nodes;
+    int last = nodes[parent].firstChild;
+
+    while (last >= 0 && nodes[last].nextSibling >= 0) {
+        last = nodes[last].nextSibling;
+    }
+    return last;
+}
+
+// A node with the given children, any of which may be -1
+static int addParent(Parser *p, NodeKind kind, int token, int op, int first, int second) {
+    int node = addNode(p, kind, token), last = -1;
+
+    p->ast->nodes[node].op = (unsigned char)op;
+    appendChild(p, node, &last, first);
+    appendChild(p, node, &last, second);
+    return node;
+}
+
+static bool isTypedefName(const Parser *p, int index) {
+    int symbol = p->input->symbols[index];
+    return typeAt(p, index) == TOKEN_IDENTIFIER && symbol >= 0 && symbol < p->input->symbolCount &&
+           p->typedefNames[symbol];
+}
+
+// Whether the identifier at index names a type. Headers are not read, so
+// besides the file's own typedefs, a name is taken for a type when what
+// follows can only be a declaration: "size_t n;", "FILE *f = ...". Inside
+// functions "name name(" is rather a call after a forgotten ';'.
+static bool looksLikeTypeName(const Parser *p, int index) {
+    if (isTypedefName(p, index)) {
+        return true;
+    }
+
+    int next = nextToken(p, index);
+    if (specifierKinds[kindAt(p, next)] != SPECIFIER_NONE) {
+        return true;
+    }
+    while (kindAt(p, next) == KIND_STAR) {
+        next = nextToken(p, next);
+    }
+    if (typeAt(p, next) != TOKEN_IDENTIFIER) {
+        return false;
+    }
+    switch (kindAt(p, nextToken(p, next))) {
+        case KIND_SEMICOLON:
+        case KIND_COMMA:
+        case KIND_ASSIGN:
+        case KIND_LBRACKET:
+        case KIND_RPAREN:
+            return true;
+        case KIND_LPAREN:
+            return p->blockDepth == 0;
+        default:
+            return false;
+    }
+}
+
+// Whether a declaration starts at index
+static bool startsDeclaration(const Parser *p, int index) {
+    if (typeAt(p, index) == TOKEN_KEYWORD) {
+        return specifierKinds[kindAt(p, index)] != SPECIFIER_NONE;
+    }
+    return typeAt(p, index) == TOKEN_IDENTIFIER && looksLikeTypeName(p, index);
+}
+
+// Whether the '(' at index opens a type name, for a cast or sizeof
+static bool startsTypeName(const Parser *p, int index) {
+    int first = nextToken(p, index);
+
+    if (typeAt(p, first) == TOKEN_KEYWORD) {
+        return specifierKinds[kindAt(p, first)] != SPECIFIER_NONE;
+    }
+    if (typeAt(p, first) != TOKEN_IDENTIFIER) {
+        return false;
+    }
+    if (isTypedefName(p, first)) {
+        return true;
+    }
+
+    // "(name *)" and "(name) operand" cannot be expressions
+    int next = nextToken(p, first);
+    if (kindAt(p, next) == KIND_STAR) {
+        while (kindAt(p, next) == KIND_STAR) {
+            next = nextToken(p, next);
+        }
+        return kindAt(p, next) == KIND_RPAREN;
+    }
+    if (kindAt(p, next) != KIND_RPAREN) {
+        return false;
+    }
+    switch (typeAt(p, nextToken(p, next))) {
+        case TOKEN_IDENTIFIER:
+        case TOKEN_NUMBER:
+        case TOKEN_STRING:
+        case TOKEN_CHAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Whether a statement or declaration can start at the current token
+static bool startsStatement(const Parser *p) {
+    switch (typeAt(p, p->current)) {
+        case TOKEN_IDENTIFIER:
+        case TOKEN_KEYWORD:
+            return true;
+        default:
+            return peek(p) == KIND_LBRACE || peek(p) == KIND_RBRACE || peek(p) == KIND_SEMICOLON;
+    }
+}
+
+// Skip to just past the next ';', or to the '}' closing the current block,
+// whichever comes first, stepping over whole bracketed groups
+static void synchronize(Parser *p) {
+    int nesting = 0;
+
+    while (!atEnd(p)) {
+        switch (peek(p)) {
+            case KIND_SEMICOLON:
+                if (nesting == 0) {
+                    advance(p);
+                    return;
+                }
+                break;
+            case KIND_LBRACE:
+                nesting++;
+                break;
+            case KIND_RBRACE:
+                if (nesting == 0) {
+                    return;
+                }
+                nesting--;
+                if (nesting == 0) {
+                    advance(p);
+                    return;
+                }
+                break;
+        }
+        advance(p);
+    }
+}
+
+// The ';' ending a statement or declaration. When it is missing and a new
+// statement starts right there, the ';' is taken as forgotten; otherwise
+// the rest is skipped.
+static void expectSemicolon(Parser *p) {
+    if (!expect(p, KIND_SEMICOLON, "Expected ';'") && !startsStatement(p)) {
+        synchronize(p);
+    }
+}
+
+// Count a level of nesting; false, with the current token skipped, when too deep
+static bool enter(Parser *p) {
+    if (p->depth >= PARSE_MAX_DEPTH) {
+        parseError(p, p->current, "Nesting is too deep");
+        advance(p);
+        return false;
+    }
+    p->depth++;
+    return true;
+}
+
+/* Expressions */
+
+// Arguments of a call, after its '('
+static void parseArguments(Parser *p, int call, int *last) {
+    if (accept(p, KIND_RPAREN)) {
+        return;
+    }
+    do {
+        appendChild(p, call, last, parseAssignment(p));
+    } while (accept(p, KIND_COMMA));
+    expect(p, KIND_RPAREN, "Expected ')' after the arguments");
+}
+
+// { values }, with C99 designators
+static int parseInitializerList(Parser *p) {
+    if (!enter(p)) {
+        return -1;
+    }
+    int list = addNode(p, NODE_INITIALIZER_LIST, advance(p)), last = -1;
+
+    while (peek(p) != KIND_RBRACE && !atEnd(p)) {
+        int start = p->current;
+        bool designated = false;
+
+        for (;;) {
+            if (peek(p) == KIND_DOT) {
+                advance(p);
+                if (typeAt(p, p->current) == TOKEN_IDENTIFIER) {
+                    int member = addNode(p, NODE_MEMBER, advance(p));
+                    p->ast->nodes[member].op = KIND_DOT;
+                    appendChild(p, list, &last, member);
+                }
+                designated = true;
+            } else if (peek(p) == KIND_LBRACKET) {
+                advance(p);
+                appendChild(p, list, &last, parseConditional(p));
+                expect(p, KIND_RBRACKET, "Expected ']'");
+                designated = true;
+            } else {
+                break;
+            }
+        }
+        if (designated) {
+            expect(p, KIND_ASSIGN, "Expected '=' after the designator");
+        }
+
+        appendChild(p, list, &last, peek(p) == KIND_LBRACE ? parseInitializerList(p) : parseAssignment(p));
+        if (!accept(p, KIND_COMMA)) {
+            break;
+        }
+        if (p->current == start) {
+            advance(p);
+        }
+    }
+    expect(p, KIND_RBRACE, "Expected '}' after the initializers");
+    p->depth--;
+    return list;
+}
+
+static int parsePrimary(Parser *p) {
+    int token = p->current;
+
+    switch (typeAt(p, token)) {
+        case TOKEN_IDENTIFIER:
+            return addNode(p, NODE_IDENTIFIER, advance(p));
+        case TOKEN_NUMBER:
+            return addNode(p, NODE_NUMBER, advance(p));
+        case TOKEN_CHAR:
+            return addNode(p, NODE_CHAR, advance(p));
+        case TOKEN_STRING:
+            while (typeAt(p, advance(p)) == TOKEN_STRING) {
+            }
+            return addNode(p, NODE_STRING, token);
+    }
+
+    if (peek(p) == KIND_LPAREN) {
+        advance(p);
+        int inner = parseExpression(p);
+        expect(p, KIND_RPAREN, "Expected ')'");
+        return inner;
+    }
+
+    parseError(p, token, "Expected an expression");
+    return addNode(p, NODE_ERROR, token);
+}
+
+static int parsePostfix(Parser *p) {
+    int node = parsePrimary(p);
+
+    for (;;) {
+        int token = p->current, last;
+
+        switch (peek(p)) {
+            case KIND_LBRACKET:
+                advance(p);
+                node = addParent(p, NODE_INDEX, token, KIND_LBRACKET, node, parseExpression(p));
+                expect(p, KIND_RBRACKET, "Expected ']'");
+                break;
+            case KIND_LPAREN:
+                advance(p);
+                last = node;
+                node = addParent(p, NODE_CALL, token, KIND_LPAREN, node, -1);
+                parseArguments(p, node, &last);
+                break;
+            case KIND_DOT:
+            case KIND_ARROW:
+                advance(p);
+                if (typeAt(p, p->current) != TOKEN_IDENTIFIER) {
+                    parseError(p, p->current, "Expected a member name");
+                    return node;
+                }
+                node = addParent(p, NODE_MEMBER, advance(p), kindAt(p, token), node, -1);
+                break;
+            case KIND_INCREMENT:
+            case KIND_DECREMENT:
+                advance(p);
+                node = addParent(p, NODE_POSTFIX, token, kindAt(p, token), node, -1);
+                break;
+            default:
+                return node;
+        }
+    }
+}
+
+static int parseUnaryNested(Parser *p) {
+    int token = p->current;
+    int kind = peek(p);
+
+    if (prefixOperators[kind]) {
+        advance(p);
+        return addParent(p, NODE_UNARY, token, kind, parseUnary(p), -1);
+    }
+
+    if (kind == KIND_SIZEOF) {
+        advance(p);
+        if (peek(p) == KIND_LPAREN && startsTypeName(p, p->current)) {
+            advance(p);
+            int type = parseTypeName(p);
+            expect(p, KIND_RPAREN, "Expected ')' after the type");
+            return addParent(p, NODE_SIZEOF, token, kind, type, -1);
+        }
+        return addParent(p, NODE_SIZEOF, token, kind, parseUnary(p), -1);
+    }
+
+    if (kind == KIND_LPAREN && startsTypeName(p, token)) {
+        advance(p);
+        int type = parseTypeName(p);
+        expect(p, KIND_RPAREN, "Expected ')' after the type");
+        int operand = peek(p) == KIND_LBRACE ? parseInitializerList(p) : parseUnary(p);
+        return addParent(p, NODE_CAST, token, KIND_LPAREN, type, operand);
+    }
+
+    return parsePostfix(p);
+}
+
+static int parseUnary(Parser *p) {
+    if (!enter(p)) {
+        return addNode(p, NODE_ERROR, p->current);
+    }
+    int node = parseUnaryNested(p);
+    p->depth--;
+    return node;
+}
+
+// Binary operators binding at least as tight as minimum, by precedence climbing
+static int parseBinary(Parser *p, int minimum) {
+    int left = parseUnary(p);
+
+    for (;;) {
+        int kind = peek(p);
+        int precedence = binaryPrecedence[kind];
+        if (precedence < minimum || precedence == 0) {
+            return left;
+        }
+        int token = advance(p);
+        left = addParent(p, NODE_BINARY, token, kind, left, parseBinary(p, precedence + 1));
+    }
+}
+
+static int parseConditional(Parser *p) {
+    int condition = parseBinary(p, 1);
+
+    if (peek(p) != KIND_QUESTION) {
+        return condition;
+    }
+    int token = advance(p);
+    int node = addParent(p, NODE_CONDITIONAL, token, KIND_QUESTION, condition, parseExpression(p));
+    int last = lastChild(p, node);
+    expect(p, KIND_COLON, "Expected ':' in the conditional expression");
+    appendChild(p, node, &last, parseConditional(p));
+    return node;
+}
+
+static int parseAssignmentNested(Parser *p) {
+    int target = parseConditional(p);
+    int kind = peek(p);
+
+    if (!assignmentOperators[kind]) {
+        return target;
+    }
+    int token = advance(p);
+    return addParent(p, NODE_ASSIGN, token, kind, target, parseAssignment(p));
+}
+
+static int parseAssignment(Parser *p) {
+    if (!enter(p)) {
+        return addNode(p, NODE_ERROR, p->current);
+    }
+    int node = parseAssignmentNested(p);
+    p->depth--;
+    return node;
+}
+
+static int parseExpression(Parser *p) {
+    int node = parseAssignment(p);
+
+    while (peek(p) == KIND_COMMA) {
+        int token = advance(p);
+        node = addParent(p, NODE_COMMA, token, KIND_COMMA, node, parseAssignment(p));
+    }
+    return node;
+}
+
+/* Declarations */
+
+// A struct, union or enum specifier, with its body if given
+static int parseRecord(Parser *p) {
+    if (!enter(p)) {
+        return -1;
+    }
+    int keyword = advance(p);
+    int record = addNode(p, NODE_RECORD, keyword), last = -1;
+
+    p->ast->nodes[record].op = (unsigned char)kindAt(p, keyword);
+    if (typeAt(p, p->current) == TOKEN_IDENTIFIER) {
+        p->ast->nodes[record].token = advance(p);
+    }
+    if (!accept(p, KIND_LBRACE)) {
+        p->depth--;
+        return record;
+    }
+
+    while (peek(p) != KIND_RBRACE && !atEnd(p)) {
+        int start = p->current;
+
+        if (kindAt(p, keyword) == KIND_ENUM) {
+            if (typeAt(p, p->current) != TOKEN_IDENTIFIER) {
+                parseError(p, p->current, "Expected an enumerator");
+                synchronize(p);
+                break;
+            }
+            int enumerator = addNode(p, NODE_ENUMERATOR, advance(p)), valueLast = -1;
+            if (accept(p, KIND_ASSIGN)) {
+                appendChild(p, enumerator, &valueLast, parseConditional(p));
+            }
+            appendChild(p, record, &last, enumerator);
+            if (!accept(p, KIND_COMMA)) {
+                break;
+            }
+        } else {
+            appendChild(p, record, &last, parseDeclaration(p, false));
+        }
+        if (p->current == start) {
+            advance(p);
+        }
+    }
+    expect(p, KIND_RBRACE, "Expected '}'");
+    p->depth--;
+    return record;
+}
+
+// Storage classes, qualifiers and the type, as children of declaration;
+// returns whether any were found
+static bool parseSpecifiers(Parser *p, int declaration, int *last) {
+    Node *nodes;
+    bool sawType = false, sawAny = false;
+
+    for (;; sawAny = true) {
+        int token = p->current;
+        int kind = peek(p);
+
+        nodes = p->ast->nodes;
+        switch (typeAt(p, token) == TOKEN_KEYWORD ? specifierKinds[kind] : SPECIFIER_NONE) {
+            case SPECIFIER_STORAGE:
+                if (kind == KIND_TYPEDEF) {
+                    nodes[declaration].flags |= NODE_FLAG_TYPEDEF;
+                }
+                advance(p);
+                continue;
+            case SPECIFIER_QUALIFIER:
+                advance(p);
+                continue;
+            case SPECIFIER_BASIC:
+                // "unsigned int" and "long double" are named by their last word
+                nodes[declaration].op = (unsigned char)kind;
+                nodes[declaration].token = token;
+                sawType = true;
+                advance(p);
+                continue;
+            case SPECIFIER_RECORD:
+                appendChild(p, declaration, last, parseRecord(p));
+                sawType = true;
+                continue;
+        }
+
+        if (!sawType && typeAt(p, token) == TOKEN_IDENTIFIER && looksLikeTypeName(p, token)) {
+            appendChild(p, declaration, last, addNode(p, NODE_TYPE_NAME, advance(p)));
+            sawType = true;
+            continue;
+        }
+        break;
+    }
+
+    nodes = p->ast->nodes;
+    if (nodes[declaration].token < 0 && nodes[declaration].firstChild >= 0) {
+        nodes[declaration].token = nodes[nodes[declaration].firstChild].token;
+    }
+    return sawAny;
+}
+
+// Parameters of a function declarator, from its '('
+static int parseParameters(Parser *p) {
+    if (!enter(p)) {
+        return -1;
+    }
+    int parameters = addNode(p, NODE_PARAMETERS, advance(p)), last = -1;
+
+    if (accept(p, KIND_RPAREN)) {
+        p->depth--;
+        return parameters;
+    }
+    do {
+        if (accept(p, KIND_ELLIPSIS)) {
+            p->ast->nodes[parameters].flags |= NODE_FLAG_VARIADIC;
+            break;
+        }
+
+        // Old-style parameters are bare names
+        int parameter = addNode(p, NODE_DECLARATION, -1), parameterLast = -1;
+        parseSpecifiers(p, parameter, &parameterLast);
+        int declarator = parseDeclarator(p, true);
+        p->ast->nodes[declarator].flags |= NODE_FLAG_PARAMETER;
+        appendChild(p, parameter, &parameterLast, declarator);
+        appendChild(p, parameters, &last, parameter);
+    } while (accept(p, KIND_COMMA));
+
+    if (!expect(p, KIND_RPAREN, "Expected ')' after the parameters")) {
+        // Skip to the ')' closing the list
+        for (int nesting = 0; !atEnd(p) && peek(p) != KIND_LBRACE && peek(p) != KIND_SEMICOLON; advance(p)) {
+            if (peek(p) == KIND_LPAREN) {
+                nesting++;
+            } else if (peek(p) == KIND_RPAREN && nesting-- == 0) {
+                advance(p);
+                break;
+            }
+        }
+    }
+    p->depth--;
+    return parameters;
+}
+
+// Whether the '(' at index nests a declarator rather than opening parameters
+static bool nestsDeclarator(const Parser *p, int index, bool abstract) {
+    int next = nextToken(p, index);
+
+    switch (kindAt(p, next)) {
+        case KIND_STAR:
+            return true;
+        case KIND_LPAREN:
+        case KIND_LBRACKET:
+            return !abstract;
+    }
+    return typeAt(p, next) == TOKEN_IDENTIFIER && !isTypedefName(p, next) && !abstract;
+}
+
+// One level of a declarator: its '*'s, the name or a parenthesized inner
+// declarator, then its suffixes. Returns whether the level or one inside it
+// had a '*', in which case the suffixes describe what is pointed to.
+static bool parseDeclaratorLevel(Parser *p, int declarator, int *last, bool abstract) {
+    int stars = 0;
+    bool innerPointer = false;
+
+    while (accept(p, KIND_STAR)) {
+        stars++;
+        while (accept(p, KIND_CONST) || accept(p, KIND_VOLATILE)) {
+        }
+    }
+    Node *node = &p->ast->nodes[declarator];
+    node->op = (unsigned char)(node->op + stars > 255 ? 255 : node->op + stars);
+
+    if (typeAt(p, p->current) == TOKEN_IDENTIFIER) {
+        node->token = advance(p);
+    } else if (peek(p) == KIND_LPAREN && nestsDeclarator(p, p->current, abstract)) {
+        advance(p);
+        if (!enter(p)) {
+            return stars > 0;
+        }
+        innerPointer = parseDeclaratorLevel(p, declarator, last, abstract);
+        p->depth--;
+        expect(p, KIND_RPAREN, "Expected ')' in the declarator");
+    } else if (!abstract) {
+        parseError(p, p->current, "Expected a name to declare");
+    }
+
+    for (bool first = true;; first = false) {
+        unsigned short flag;
+        int suffix;
+
+        if (peek(p) == KIND_LBRACKET) {
+            suffix = addNode(p, NODE_ARRAY, advance(p));
+            int sizeLast = -1;
+            while (accept(p, KIND_STATIC) || accept(p, KIND_CONST) || accept(p, KIND_VOLATILE)) {
+            }
+            if (peek(p) != KIND_RBRACKET) {
+                appendChild(p, suffix, &sizeLast, parseAssignment(p));
+            }
+            expect(p, KIND_RBRACKET, "Expected ']'");
+            flag = NODE_FLAG_ARRAY;
+        } else if (peek(p) == KIND_LPAREN) {
+            suffix = parseParameters(p);
+            flag = NODE_FLAG_FUNCTION;
+        } else {
+            break;
+        }
+        appendChild(p, declarator, last, suffix);
+        if (first && !innerPointer) {
+            p->ast->nodes[declarator].flags |= flag;
+        }
+    }
+
+    if (stars > 0) {
+        p->ast->nodes[declarator].flags |= NODE_FLAG_POINTER;
+    }
+    return stars > 0 || innerPointer;
+}
+
+static int parseDeclarator(Parser *p, bool abstract) {
+    int declarator = addNode(p, NODE_DECLARATOR, -1), last = -1;
+
+    parseDeclaratorLevel(p, declarator, &last, abstract);
+    return declarator;
+}
+
+// The type in a cast or sizeof, after its '('
+static int parseTypeName(Parser *p) {
+    int declaration = addNode(p, NODE_DECLARATION, -1), last = -1;
+
+    parseSpecifiers(p, declaration, &last);
+    appendChild(p, declaration, &last, parseDeclarator(p, true));
+    return declaration;
+}
+
+static int parseBlock(Parser *p);
+
+// A declaration through its ';'; at file scope (allowFunction), a function
+// definition through its body. Member declarations may have bit-fields.
+static int parseDeclaration(Parser *p, bool allowFunction) {
+    Node *nodes;
+    int declaration = addNode(p, NODE_DECLARATION, -1), last = -1;
+    bool first = true;
+
+    parseSpecifiers(p, declaration, &last);
+    if (accept(p, KIND_SEMICOLON)) {
+        return declaration;
+    }
+
+    do {
+        int declarator = parseDeclarator(p, false);
+        int declaratorLast = lastChild(p, declarator);
+        appendChild(p, declaration, &last, declarator);
+
+        nodes = p->ast->nodes;
+        if (nodes[declaration].flags & NODE_FLAG_TYPEDEF) {
+            int name = nodes[declarator].token;
+            int symbol = name >= 0 ? p->input->symbols[name] : -1;
+            if (symbol >= 0 && symbol < p->input->symbolCount) {
+                p->typedefNames[symbol] = 1;
+            }
+        }
+
+        if (allowFunction && first && (nodes[declarator].flags & NODE_FLAG_FUNCTION) && peek(p) == KIND_LBRACE) {
+            nodes[declarator].flags |= NODE_FLAG_DEFINITION;
+            return addParent(p, NODE_FUNCTION, nodes[declarator].token, 0, declaration, parseBlock(p));
+        }
+        first = false;
+
+        if (accept(p, KIND_COLON)) {
+            appendChild(p, declarator, &declaratorLast, parseConditional(p));
+        }
+        if (peek(p) == KIND_ASSIGN) {
+            int initializer = addNode(p, NODE_INITIALIZER, advance(p)), valueLast = -1;
+            appendChild(p, initializer, &valueLast,
+                        peek(p) == KIND_LBRACE ? parseInitializerList(p) : parseAssignment(p));
+            appendChild(p, declarator, &declaratorLast, initializer);
+        }
+    } while (accept(p, KIND_COMMA));
+
+    expectSemicolon(p);
+    return declaration;
+}
+
+/* Statements */
+
+// { declarations and statements }
+static int parseBlock(Parser *p) {
+    int block = addNode(p, NODE_BLOCK, advance(p)), last = -1;
+
+    p->blockDepth++;
+    while (peek(p) != KIND_RBRACE && !atEnd(p)) {
+        int start = p->current;
+
+        appendChild(p, block, &last, parseStatement(p));
+        if (p->current == start) {
+            parseError(p, start, "Unexpected token");
+            advance(p);
+        }
+    }
+    p->blockDepth--;
+    expect(p, KIND_RBRACE, "Expected '}'");
+    return block;
+}
+
+// ( expression ), as if and the loops have it
+static int parseCondition(Parser *p) {
+    expect(p, KIND_LPAREN, "Expected '('");
+    int condition = parseExpression(p);
+    expect(p, KIND_RPAREN, "Expected ')'");
+    return condition;
+}
+
+// The statement a label labels, if the block does not end first
+static int parseLabelled(Parser *p) {
+    return peek(p) == KIND_RBRACE ? -1 : parseStatement(p);
+}
+
+static int parseStatementNested(Parser *p) {
+    int token = p->current;
+    int node, last;
+
+    switch (peek(p)) {
+        case KIND_LBRACE:
+            return parseBlock(p);
+        case KIND_SEMICOLON:
+            return addNode(p, NODE_EMPTY, advance(p));
+        case KIND_IF:
+            advance(p);
+            node = addParent(p, NODE_IF, token, 0, parseCondition(p), parseStatement(p));
+            if (peek(p) == KIND_ELSE) {
+                advance(p);
+                last = lastChild(p, node);
+                appendChild(p, node, &last, parseStatement(p));
+            }
+            return node;
+        case KIND_WHILE:
+            advance(p);
+            return addParent(p, NODE_WHILE, token, 0, parseCondition(p), parseStatement(p));
+        case KIND_DO:
+            advance(p);
+            node = parseStatement(p);
+            if (!expect(p, KIND_WHILE, "Expected 'while' after the body of 'do'")) {
+                return addParent(p, NODE_DO, token, 0, node, -1);
+            }
+            node = addParent(p, NODE_DO, token, 0, node, parseCondition(p));
+            expectSemicolon(p);
+            return node;
+        case KIND_FOR:
+            advance(p);
+            node = addNode(p, NODE_FOR, token);
+            last = -1;
+            expect(p, KIND_LPAREN, "Expected '('");
+            if (startsDeclaration(p, p->current)) {
+                appendChild(p, node, &last, parseDeclaration(p, false));
+            } else if (peek(p) == KIND_SEMICOLON) {
+                appendChild(p, node, &last, addNode(p, NODE_EMPTY, advance(p)));
+            } else {
+                appendChild(p, node, &last, parseExpression(p));
+                expect(p, KIND_SEMICOLON, "Expected ';' in 'for'");
+            }
+            appendChild(p, node, &last, peek(p) == KIND_SEMICOLON ? addNode(p, NODE_EMPTY, p->current)
+                                                                  : parseExpression(p));
+            expect(p, KIND_SEMICOLON, "Expected ';' in 'for'");
+            appendChild(p, node, &last, peek(p) == KIND_RPAREN ? addNode(p, NODE_EMPTY, p->current)
+                                                               : parseExpression(p));
+            expect(p, KIND_RPAREN, "Expected ')'");
+            appendChild(p, node, &last, parseStatement(p));
+            return node;
+        case KIND_SWITCH:
+            advance(p);
+            return addParent(p, NODE_SWITCH, token, 0, parseCondition(p), parseStatement(p));
+        case KIND_CASE:
+            advance(p);
+            node = parseConditional(p);
+            expect(p, KIND_COLON, "Expected ':' after the case value");
+            return addParent(p, NODE_CASE, token, 0, node, parseLabelled(p));
+        case KIND_DEFAULT:
+            advance(p);
+            expect(p, KIND_COLON, "Expected ':' after 'default'");
+            return addParent(p, NODE_DEFAULT, token, 0, parseLabelled(p), -1);
+        case KIND_GOTO:
+            advance(p);
+            node = addNode(p, NODE_GOTO, typeAt(p, p->current) == TOKEN_IDENTIFIER ? advance(p) : token);
+            expectSemicolon(p);
+            return node;
+        case KIND_BREAK:
+        case KIND_CONTINUE:
+            node = addNode(p, peek(p) == KIND_BREAK ? NODE_BREAK : NODE_CONTINUE, advance(p));
+            expectSemicolon(p);
+            return node;
+        case KIND_RETURN:
+            advance(p);
+            node = addParent(p, NODE_RETURN, token, 0, peek(p) == KIND_SEMICOLON ? -1 : parseExpression(p), -1);
+            expectSemicolon(p);
+            return node;
+        case KIND_ELSE:
+            parseError(p, token, "'else' without 'if'");
+            advance(p);
+            return parseStatement(p);
+    }
+
+    if (typeAt(p, token) == TOKEN_IDENTIFIER && kindAt(p, nextToken(p, token)) == KIND_COLON) {
+        advance(p);
+        advance(p);
+        return addParent(p, NODE_LABEL, token, 0, parseLabelled(p), -1);
+    }
+    if (startsDeclaration(p, token)) {
+        return parseDeclaration(p, false);
+    }
+
+    node = addParent(p, NODE_EXPRESSION_STATEMENT, token, 0, parseExpression(p), -1);
+    expectSemicolon(p);
+    return node;
+}
+
+static int parseStatement(Parser *p) {
+    if (!enter(p)) {
+        return -1;
+    }
+    int node = parseStatementNested(p);
+    p->depth--;
+    return node;
+}
+
+// Whether the identifier at index starts an old-style definition with the
+// type left out: "main() {"
+static bool startsImplicitFunction(const Parser *p, int index) {
+    int next = nextToken(p, index);
+    int nesting = 0;
+
+    if (kindAt(p, next) != KIND_LPAREN) {
+        return false;
+    }
+    for (; typeAt(p, next) != TOKEN_EOF; next = nextToken(p, next)) {
+        if (kindAt(p, next) == KIND_LPAREN) {
+            nesting++;
+        } else if (kindAt(p, next) == KIND_RPAREN && --nesting == 0) {
+            return kindAt(p, nextToken(p, next)) == KIND_LBRACE;
+        } else if (kindAt(p, next) == KIND_SEMICOLON || kindAt(p, next) == KIND_LBRACE) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Parse the whole token stream into ast, whose nodes and errors come from
+// arena. Code that does not parse becomes error nodes, or is skipped up to
+// the next ';' or '}', so the rest of the file still gets a tree. Statements
+// outside any function, as unbalanced braces leave them, are kept as
+// statements of the translation unit.
+void parseTokens(const ParseInput *input, Arena *arena, Ast *ast) {
+    Parser parser = {input, arena, ast, 0, 0, -1, 0, NULL};
+    Parser *p = &parser;
+    int last = -1;
+
+    memset(ast, 0, sizeof(*ast));
+    parser.typedefNames = arenaAlloc(arena, (size_t)input->symbolCount + 1);
+    memset(parser.typedefNames, 0, (size_t)input->symbolCount + 1);
+    parser.current = skipTrivia(p, 0);
+
+    int root = addNode(p, NODE_TRANSLATION_UNIT, -1);
+    while (!atEnd(p)) {
+        int start = p->current;
+        int node;
 
-// Placeholder for parsing logic
-int parse(const char *line, int lineNumber) {
-    // Add parsing logic here
-    return 1; // Return 1 if parsing succeeds, 0 otherwise
-}
\ No newline at end of file
+        if (startsDeclaration(p, start) ||
+            (typeAt(p, start) == TOKEN_IDENTIFIER && startsImplicitFunction(p, start))) {
+            node = parseDeclaration(p, true);
+        } else if (peek(p) == KIND_RBRACE) {
+            parseError(p, start, "Unmatched '}'");
+            advance(p);
+            continue;
+        } else {
+            node = parseStatement(p);
+        }
+        appendChild(p, root, &last, node);
+        if (p->current == start) {
+            parseError(p, start, "Unexpected token");
+            advance(p);
+        }
+    }
+}
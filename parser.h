@@ -1,7 +1,109 @@
 #ifndef PARSER_H
 #define PARSER_H
 
-// Function prototype for parsing
-int parse(const char *line, int lineNumber);
+#include "arena.h"
+#include "tokens.h"
 
-#endif // PARSER_H
\ No newline at end of file
+// What a syntax tree node is. Children are listed in source order.
+typedef enum {
+    NODE_ERROR,                 // Where an expression was expected but none was found
+    NODE_TRANSLATION_UNIT,      // The file: declarations, function definitions, and stray statements
+
+    // Declarations
+    NODE_FUNCTION,              // A definition: its NODE_DECLARATION, then its NODE_BLOCK
+    NODE_DECLARATION,           // token: the last basic type keyword (op is its kind), else the type;
+                                // children: a NODE_TYPE_NAME or NODE_RECORD, then the NODE_DECLARATORs
+    NODE_TYPE_NAME,             // A typedef name used as a type; token: the name
+    NODE_RECORD,                // struct, union or enum (op); token: the tag, else the keyword;
+                                // children: member declarations or enumerators
+    NODE_ENUMERATOR,            // token: the name; child: its value, if given
+    NODE_DECLARATOR,            // token: the name, -1 if abstract; op: '*' count (at most 255);
+                                // children: NODE_ARRAY and NODE_PARAMETERS suffixes, then a NODE_INITIALIZER
+    NODE_ARRAY,                 // [size]; child: the size, if given
+    NODE_PARAMETERS,            // (...); children: a NODE_DECLARATION per parameter
+    NODE_INITIALIZER,           // = value; child: an expression or NODE_INITIALIZER_LIST
+    NODE_INITIALIZER_LIST,      // { ... }; children: values, each after its designator if any
+
+    // Statements
+    NODE_BLOCK,                 // { ... }; children: declarations and statements
+    NODE_EXPRESSION_STATEMENT,  // child: the expression
+    NODE_EMPTY,                 // ';', or a for clause left out
+    NODE_IF,                    // children: condition, then, else if any
+    NODE_WHILE,                 // children: condition, body
+    NODE_DO,                    // children: body, condition
+    NODE_FOR,                   // children: init, condition, step (NODE_EMPTY when left out), body
+    NODE_SWITCH,                // children: value, body
+    NODE_CASE,                  // children: value, then the statement labelled if any
+    NODE_DEFAULT,               // child: the statement labelled, if any
+    NODE_LABEL,                 // token: the label; child: the statement labelled, if any
+    NODE_GOTO,                  // token: the label
+    NODE_BREAK,
+    NODE_CONTINUE,
+    NODE_RETURN,                // child: the value, if any
+
+    // Expressions: op is the operator's TokenKind
+    NODE_IDENTIFIER,
+    NODE_NUMBER,
+    NODE_STRING,                // Adjacent literals are one node, at the first
+    NODE_CHAR,
+    NODE_CALL,                  // children: the function, then the arguments
+    NODE_INDEX,                 // children: array, index
+    NODE_MEMBER,                // token: the member; child: the struct (none in a designator)
+    NODE_POSTFIX,               // x++ and x--; child: the operand
+    NODE_UNARY,                 // child: the operand
+    NODE_CAST,                  // children: the type's NODE_DECLARATION, then the operand
+    NODE_SIZEOF,                // child: an expression or a type's NODE_DECLARATION
+    NODE_BINARY,                // children: left, right
+    NODE_ASSIGN,                // children: target, value
+    NODE_CONDITIONAL,           // children: condition, then, else
+    NODE_COMMA                  // children: left, right
+} NodeKind;
+
+// Bits of Node.flags
+#define NODE_FLAG_POINTER   0x01    // Declarator: has a '*'
+#define NODE_FLAG_ARRAY     0x02    // Declarator: declares an array (of pointers, too)
+#define NODE_FLAG_FUNCTION  0x04    // Declarator: declares a function, not a pointer to one
+#define NODE_FLAG_TYPEDEF   0x08    // Declaration: a typedef
+#define NODE_FLAG_VARIADIC  0x10    // Parameters: end with "..."
+#define NODE_FLAG_PARAMETER 0x20    // Declarator: declares a parameter
+#define NODE_FLAG_DEFINITION 0x40   // Declarator: of the function a NODE_FUNCTION defines
+
+// One node, linked to its children by index so the tree can grow in place
+typedef struct {
+    unsigned char kind;         // NodeKind
+    unsigned char op;           // See NodeKind
+    unsigned short flags;       // NODE_FLAG_* bits
+    int token;                  // Token the node is about, -1 if none
+    int firstChild;             // -1 if none
+    int nextSibling;            // -1 after the last child of the parent
+} Node;
+
+typedef struct {
+    int token;                  // Where the parser was
+    const char *message;
+} ParseError;
+
+// The tokens to parse, column by column as latest.c stores them. The last
+// token is TOKEN_EOF; comments and preprocessor lines are skipped.
+typedef struct {
+    const unsigned char *types; // TokenType of each token
+    const unsigned char *kinds; // TokenKind of each token
+    const int *symbols;         // Symbol ID of each identifier, -1 for other tokens
+    int symbolCount;            // Symbol IDs are below this
+    int count;
+} ParseInput;
+
+// A syntax tree and the errors met building it, all in one arena
+typedef struct {
+    Node *nodes;                // nodes[0] is the NODE_TRANSLATION_UNIT
+    int count;
+    int capacity;
+    ParseError *errors;
+    int errorCount;
+    int errorCapacity;
+} Ast;
+
+// Function prototypes
+void parseTokens(const ParseInput *input, Arena *arena, Ast *ast);
+
+#endif // PARSER_H
@@ -1,4 +1,5 @@
 #include "printf_checker.h"
+#include "format.h"
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -40,9 +41,13 @@ bool isUnsupportedPrintfVariation(const char *line) {
     return false; // No unsupported variation found
 }
 
+// Format strings already parsed, so a line repeated through the file is parsed once
+static Arena formatArena = {0};
+static FormatCache formatCache;
+static bool formatCacheReady = false;
+
 // Validate printf format string
 int validatePrintfFormat(const char *line, int lineNumber) {
-    const char *validSpecifiers = "diuoxXfFeEgGaAcspn%";
     const char *formatStart = strchr(line, '"');
     const char *formatEnd = strrchr(line, '"');
 
@@ -51,14 +56,19 @@ int validatePrintfFormat(const char *line, int lineNumber) {
         return 1; // Error code 1: Unbalanced quotes
     }
 
+    if (!formatCacheReady) {
+        formatCacheInit(&formatCache, &formatArena, FORMAT_PRINTF);
+        formatCacheReady = true;
+    }
+
     // Check for invalid format specifiers
-    for (const char *p = formatStart; p <= formatEnd; p++) {
-        if (*p == '%') {
-            p++; // Skip '%'
-            if (!strchr(validSpecifiers, *p)) {
-                printf("Error at line %d: Invalid format specifier '%%%c'.\n", lineNumber, *p);
-                return 2; // Error code 2: Invalid format specifier
-            }
+    int formatLength = formatEnd > formatStart ? (int)(formatEnd - formatStart) - 1 : 0;
+    const FormatString *format = formatCompile(&formatCache, formatStart + 1, formatLength);
+    for (int i = 0; i < format->count; i++) {
+        if (format->specs[i].conversion == 0) {
+            printf("Error at line %d: Invalid format specifier '%%%c'.\n", lineNumber,
+                   format->specs[i].bad ? format->specs[i].bad : '"');
+            return 2; // Error code 2: Invalid format specifier
         }
     }
 
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "profile.h"
+
+// A monotonic timestamp in seconds
+double profileNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Start an empty profile, timing the run from now
+void profileStart(Profile *profile) {
+    profile->count = 0;
+    profile->started = profileNow();
+}
+
+// Add an entry that took seconds, for the caller to fill in its counters;
+// past MAX_PROFILE_ENTRIES the time goes to the last one
+ProfileEntry *profileRecord(Profile *profile, const char *name, double seconds) {
+    if (profile->count == MAX_PROFILE_ENTRIES) {
+        profile->entries[MAX_PROFILE_ENTRIES - 1].seconds += seconds;
+        return &profile->entries[MAX_PROFILE_ENTRIES - 1];
+    }
+    ProfileEntry *entry = &profile->entries[profile->count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->name = name;
+    entry->seconds = seconds;
+    return entry;
+}
+
+// Orders entries by time, longest first, then by when they were recorded
+static int compareEntryTimes(const void *a, const void *b) {
+    const ProfileEntry *first = *(const ProfileEntry * const *)a;
+    const ProfileEntry *second = *(const ProfileEntry * const *)b;
+
+    if (first->seconds != second->seconds) {
+        return first->seconds > second->seconds ? -1 : 1;
+    }
+    return first < second ? -1 : first > second;
+}
+
+// The entries sorted longest first, into sorted[]
+static void sortEntries(const Profile *profile, const ProfileEntry **sorted) {
+    for (int i = 0; i < profile->count; i++) {
+        sorted[i] = &profile->entries[i];
+    }
+    qsort(sorted, profile->count, sizeof(sorted[0]), compareEntryTimes);
+}
+
+// Write the entries as a table, longest first. Passes that ran on several
+// threads at once can add up to more than the run's wall time.
+void profileWriteTable(const Profile *profile, Sink *sink) {
+    const ProfileEntry *sorted[MAX_PROFILE_ENTRIES];
+    double total = profileNow() - profile->started;
+
+    sortEntries(profile, sorted);
+    sinkPrintf(sink, "\nProfile (%.3f ms in all):\n", total * 1e3);
+    sinkPrintf(sink, "  %-32s %10s %6s %10s %11s %12s %9s\n",
+               "phase", "ms", "%", "tokens", "diagnostics", "bytes", "MB/s");
+    for (int i = 0; i < profile->count; i++) {
+        const ProfileEntry *entry = sorted[i];
+
+        sinkPrintf(sink, "  %-32.32s %10.3f %5.1f%% %10lld %11lld %12llu ",
+                   entry->name, entry->seconds * 1e3, total > 0 ? entry->seconds / total * 100 : 0.0,
+                   entry->tokens, entry->diagnostics, entry->bytes);
+        if (entry->bytes > 0 && entry->seconds > 0) {
+            sinkPrintf(sink, "%9.1f\n", entry->bytes / entry->seconds / 1e6);
+        } else {
+            sinkPrintf(sink, "%9s\n", "-");
+        }
+    }
+}
+
+// Write the entries as one JSON document, longest first
+void profileWriteJson(const Profile *profile, Sink *sink) {
+    const ProfileEntry *sorted[MAX_PROFILE_ENTRIES];
+    double total = profileNow() - profile->started;
+
+    sortEntries(profile, sorted);
+    sinkPrintf(sink, "{\n  \"totalMs\": %.3f,\n  \"phases\": [", total * 1e3);
+    for (int i = 0; i < profile->count; i++) {
+        const ProfileEntry *entry = sorted[i];
+
+        sinkPrintf(sink, "%s\n    {\"name\": ", i > 0 ? "," : "");
+        sinkJsonString(sink, entry->name, strlen(entry->name));
+        sinkPrintf(sink, ", \"ms\": %.3f, \"tokens\": %lld, \"diagnostics\": %lld, \"bytes\": %llu}",
+                   entry->seconds * 1e3, entry->tokens, entry->diagnostics, entry->bytes);
+    }
+    sinkPrintf(sink, "%s]\n}\n", profile->count > 0 ? "\n  " : "");
+}
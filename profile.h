@@ -0,0 +1,31 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "sink.h"
+
+#define MAX_PROFILE_ENTRIES 64      // Phases and passes one run can record
+
+// What one phase or pass of a run cost
+typedef struct {
+    const char *name;
+    double seconds;                 // Wall time, summed over threads for split passes
+    long long tokens;               // Tokens visited, or produced by the lexer
+    long long diagnostics;          // Errors it reported
+    unsigned long long bytes;       // Source bytes it went through, or output bytes written
+} ProfileEntry;
+
+// The entries of one run, in the order they were recorded
+typedef struct {
+    ProfileEntry entries[MAX_PROFILE_ENTRIES];
+    int count;
+    double started;                 // profileNow() when the run began
+} Profile;
+
+// Function prototypes
+double profileNow(void);
+void profileStart(Profile *profile);
+ProfileEntry *profileRecord(Profile *profile, const char *name, double seconds);
+void profileWriteTable(const Profile *profile, Sink *sink);
+void profileWriteJson(const Profile *profile, Sink *sink);
+
+#endif // PROFILE_H
@@ -0,0 +1,51 @@
+// Declarations of every kind of type. The checker should report no errors
+// for this file: each name used here is declared, and enum constants
+// belong to the scope around their enum.
+#include <stdio.h>
+
+typedef int myint;
+
+struct node {
+    int value;
+    struct node *next;
+};
+
+enum color { RED, GREEN = 2, BLUE };
+
+typedef enum { SMALL, LARGE } size_class;
+
+static long total;
+
+int sum(struct node *head, myint start) {
+    myint result = start;
+    while (head != 0) {
+        result = result + head->value;
+        head = head->next;
+    }
+    return result;
+}
+
+int main() {
+    FILE *fp = fopen("numbers.txt", "r");
+    struct node n;
+    enum color c = RED;
+    size_class s = LARGE;
+    myint v = 3;
+    unsigned int count = 0;
+    const char *name = "numbers";
+    enum { LOW = 1, HIGH = 9 } level = LOW;
+
+    n.value = 1;
+    n.next = 0;
+    c = GREEN;
+    if (c == BLUE || s == SMALL || level == HIGH) {
+        v = v + n.value;
+    }
+    count = count + sum(&n, v);
+    total = count;
+    printf("%s %d\n", name, v);
+    if (fp != 0) {
+        fclose(fp);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <string.h>
+#include "scope.h"
+
+#define SCOPE_MIN_SLOTS 16      // Slots of a scope's first table
+
+// Spread the bits of a small integer key over the whole word
+static unsigned int scopeHash(int key) {
+    unsigned int hash = (unsigned int)key * 2654435769u;
+    return hash ^ (hash >> 16);
+}
+
+// Find the slot holding the key, or the empty slot where it belongs
+static int findSlot(const Scope *scope, int key) {
+    unsigned int mask = (unsigned int)scope->slotCount - 1;
+    unsigned int slot = scopeHash(key) & mask;
+
+    while (scope->keys[slot] != -1 && scope->keys[slot] != key) {
+        slot = (slot + 1) & mask;
+    }
+    return (int)slot;
+}
+
+// Put a key known to be absent into its slot and remember the slot
+static void placeKey(ScopeStack *stack, Scope *scope, int key, int value) {
+    int slot = findSlot(scope, key);
+
+    scope->keys[slot] = key;
+    scope->values[slot] = value;
+    scope->used = arenaGrowArray(stack->arena, scope->used, scope->count, &scope->usedCapacity, sizeof(int));
+    scope->used[scope->count++] = slot;
+}
+
+// Give the scope a table of slotCount slots holding the keys it has
+static void resizeScope(ScopeStack *stack, Scope *scope, int slotCount) {
+    int *oldKeys = scope->keys;
+    int *oldValues = scope->values;
+    int *oldUsed = scope->used;
+    int oldCount = scope->count;
+
+    scope->keys = arenaAlloc(stack->arena, (size_t)slotCount * sizeof(int));
+    scope->values = arenaAlloc(stack->arena, (size_t)slotCount * sizeof(int));
+    memset(scope->keys, 0xff, (size_t)slotCount * sizeof(int));
+    scope->slotCount = slotCount;
+    scope->used = NULL;
+    scope->usedCapacity = 0;
+    scope->count = 0;
+
+    for (int i = 0; i < oldCount; i++) {
+        placeKey(stack, scope, oldKeys[oldUsed[i]], oldValues[oldUsed[i]]);
+    }
+}
+
+// Start a stack holding only the empty file scope
+void scopeInit(ScopeStack *stack, Arena *arena) {
+    stack->arena = arena;
+    stack->scopes = NULL;
+    stack->depth = 0;
+    stack->capacity = 0;
+    scopePush(stack);
+}
+
+// Open an empty scope inside the current one
+void scopePush(ScopeStack *stack) {
+    if (stack->depth == stack->capacity) {
+        int capacity = stack->capacity;
+        stack->scopes = arenaGrowArray(stack->arena, stack->scopes, stack->depth, &capacity, sizeof(Scope));
+        memset(stack->scopes + stack->capacity, 0, (size_t)(capacity - stack->capacity) * sizeof(Scope));
+        stack->capacity = capacity;
+    }
+    stack->depth++;
+}
+
+// Close the innermost scope, forgetting its keys; the file scope stays open
+void scopePop(ScopeStack *stack) {
+    if (stack->depth <= 1) {
+        return;
+    }
+
+    Scope *scope = &stack->scopes[--stack->depth];
+    for (int i = 0; i < scope->count; i++) {
+        scope->keys[scope->used[i]] = -1;
+    }
+    scope->count = 0;
+}
+
+// Add a key to the innermost scope; a key it already has keeps its value
+void scopeDeclare(ScopeStack *stack, int key, int value) {
+    scopeDeclareAt(stack, stack->depth, key, value);
+}
+
+// Add a key to the scope depth scopes from the file scope, counting it as
+// 1, like an enum's constants that belong to the scope around its braces
+void scopeDeclareAt(ScopeStack *stack, int depth, int key, int value) {
+    Scope *scope = &stack->scopes[depth - 1];
+
+    if (scope->slotCount == 0) {
+        resizeScope(stack, scope, SCOPE_MIN_SLOTS);
+    }
+    if (scope->keys[findSlot(scope, key)] == key) {
+        return;
+    }
+
+    // Keep the load factor at or below one half
+    if ((scope->count + 1) * 2 > scope->slotCount) {
+        resizeScope(stack, scope, scope->slotCount * 2);
+    }
+    placeKey(stack, scope, key, value);
+}
+
+// Return the value of the key in the innermost scope that has it, or -1
+int scopeLookup(const ScopeStack *stack, int key) {
+    for (int depth = stack->depth - 1; depth >= 0; depth--) {
+        const Scope *scope = &stack->scopes[depth];
+
+        if (scope->count > 0) {
+            int slot = findSlot(scope, key);
+            if (scope->keys[slot] == key) {
+                return scope->values[slot];
+            }
+        }
+    }
+    return -1;
+}
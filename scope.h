@@ -0,0 +1,35 @@
+#ifndef SCOPE_H
+#define SCOPE_H
+
+#include "arena.h"
+
+// The declarations of one block: an open-addressing table from a key (a
+// symbol ID) to a value. Tables are kept when their block closes and reused
+// by the next block opened at the same depth.
+typedef struct {
+    int *keys;              // Key in each slot, -1 when empty
+    int *values;            // Value of the key in the same slot
+    int *used;              // Slots holding a key, so closing costs only those
+    int count;              // Keys in the scope
+    int usedCapacity;       // Room in used
+    int slotCount;          // Always a power of two, 0 before the first key
+} Scope;
+
+// Nested scopes, innermost last. The outermost is the file scope, which
+// stays open; lookups try each open scope from the innermost out.
+typedef struct {
+    Arena *arena;           // Where the tables live
+    Scope *scopes;
+    int depth;              // Open scopes, the file scope included
+    int capacity;           // Room in scopes
+} ScopeStack;
+
+// Function prototypes
+void scopeInit(ScopeStack *stack, Arena *arena);
+void scopePush(ScopeStack *stack);
+void scopePop(ScopeStack *stack);
+void scopeDeclare(ScopeStack *stack, int key, int value);
+void scopeDeclareAt(ScopeStack *stack, int depth, int key, int value);
+int scopeLookup(const ScopeStack *stack, int key);
+
+#endif // SCOPE_H
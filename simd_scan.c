@@ -0,0 +1,284 @@
+#include "simd_scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SCAN_X86
+#include <immintrin.h>
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2,popcnt,bmi")))
+#endif
+
+/* Scalar kernels: the reference behaviour, and the fallback on other CPUs */
+
+static const char *skipWhitespaceScalar(const char *text) {
+    while (*text == ' ' || (*text >= '\t' && *text <= '\r')) {
+        text++;
+    }
+    return text;
+}
+
+static const char *skipCommentBodyScalar(const char *text) {
+    while (*text != '\0' && !(*text == '*' && *(text + 1) == '/')) {
+        text++;
+    }
+    return text;
+}
+
+static const char *skipQuotedBodyScalar(const char *text, char quote) {
+    while (*text != '\0' && *text != quote && *text != '\\') {
+        text++;
+    }
+    return text;
+}
+
+static const char *skipToLineEndScalar(const char *text) {
+    while (*text != '\0' && *text != '\n') {
+        text++;
+    }
+    return text;
+}
+
+/**
+ * Scalar newline search over text[start, length); the vector versions use
+ * it for the bytes after their last whole block. Returns the new count.
+ */
+static size_t findNewlinesFrom(const char *text, size_t start, size_t length, unsigned int *offsets, size_t count) {
+    for (size_t i = start; i < length; i++) {
+        if (text[i] == '\n') {
+            if (offsets) {
+                offsets[count] = (unsigned int)(i + 1);
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+static size_t findNewlinesScalar(const char *text, size_t length, unsigned int *offsets) {
+    return findNewlinesFrom(text, 0, length, offsets, 0);
+}
+
+#ifdef SIMD_SCAN_X86
+
+/* SSE2 kernels: 16 bytes per step. Each block is turned into a bit mask of
+ * stopping bytes; the lowest stop bit is the answer. Newlines are only
+ * counted, with popcount, when the line-start index is built. */
+
+SSE2_TARGET static unsigned int byteMask16(__m128i block, char c) {
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+}
+
+SSE2_TARGET static unsigned int whitespaceMask16(__m128i block) {
+    // '\t' through '\r' are consecutive, so one unsigned range test covers them
+    __m128i controls = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(controls, _mm_set1_epi8('\r' - '\t')), controls);
+    __m128i isSpace = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+    return (unsigned int)_mm_movemask_epi8(_mm_or_si128(isSpace, isControl));
+}
+
+SSE2_TARGET static const char *skipWhitespaceSse2(const char *text) {
+    for (;; text += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)text);
+        unsigned int stops = ~whitespaceMask16(block) & 0xFFFF;
+
+        if (stops != 0) {
+            return text + __builtin_ctz(stops);
+        }
+    }
+}
+
+SSE2_TARGET static const char *skipCommentBodySse2(const char *text) {
+    for (;; text += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)text);
+        unsigned int stops = byteMask16(block, '*') | byteMask16(block, '\0');
+
+        // A '*' only stops the scan when a '/' follows it
+        for (; stops != 0; stops &= stops - 1) {
+            int index = __builtin_ctz(stops);
+            if (text[index] == '\0' || text[index + 1] == '/') {
+                return text + index;
+            }
+        }
+    }
+}
+
+SSE2_TARGET static const char *skipQuotedBodySse2(const char *text, char quote) {
+    for (;; text += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)text);
+        unsigned int stops = byteMask16(block, quote) | byteMask16(block, '\\') | byteMask16(block, '\0');
+
+        if (stops != 0) {
+            return text + __builtin_ctz(stops);
+        }
+    }
+}
+
+SSE2_TARGET static const char *skipToLineEndSse2(const char *text) {
+    for (;; text += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)text);
+        unsigned int stops = byteMask16(block, '\n') | byteMask16(block, '\0');
+
+        if (stops != 0) {
+            return text + __builtin_ctz(stops);
+        }
+    }
+}
+
+SSE2_TARGET static size_t findNewlinesSse2(const char *text, size_t length, unsigned int *offsets) {
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        unsigned int newlines = byteMask16(_mm_loadu_si128((const __m128i *)(text + i)), '\n');
+
+        if (offsets) {
+            for (; newlines != 0; newlines &= newlines - 1) {
+                offsets[count++] = (unsigned int)(i + __builtin_ctz(newlines) + 1);
+            }
+        } else {
+            count += __builtin_popcount(newlines);
+        }
+    }
+    return findNewlinesFrom(text, i, length, offsets, count);
+}
+
+/* AVX2 kernels: the same scheme, 32 bytes per step */
+
+AVX2_TARGET static unsigned int byteMask32(__m256i block, char c) {
+    return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)));
+}
+
+AVX2_TARGET static unsigned int whitespaceMask32(__m256i block) {
+    __m256i controls = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+    __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(controls, _mm256_set1_epi8('\r' - '\t')), controls);
+    __m256i isSpace = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+    return (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(isSpace, isControl));
+}
+
+AVX2_TARGET static const char *skipWhitespaceAvx2(const char *text) {
+    for (;; text += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)text);
+        unsigned int stops = ~whitespaceMask32(block);
+
+        if (stops != 0) {
+            return text + __builtin_ctz(stops);
+        }
+    }
+}
+
+AVX2_TARGET static const char *skipCommentBodyAvx2(const char *text) {
+    for (;; text += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)text);
+        unsigned int stops = byteMask32(block, '*') | byteMask32(block, '\0');
+
+        for (; stops != 0; stops &= stops - 1) {
+            int index = __builtin_ctz(stops);
+            if (text[index] == '\0' || text[index + 1] == '/') {
+                return text + index;
+            }
+        }
+    }
+}
+
+AVX2_TARGET static const char *skipQuotedBodyAvx2(const char *text, char quote) {
+    for (;; text += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)text);
+        unsigned int stops = byteMask32(block, quote) | byteMask32(block, '\\') | byteMask32(block, '\0');
+
+        if (stops != 0) {
+            return text + __builtin_ctz(stops);
+        }
+    }
+}
+
+AVX2_TARGET static const char *skipToLineEndAvx2(const char *text) {
+    for (;; text += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)text);
+        unsigned int stops = byteMask32(block, '\n') | byteMask32(block, '\0');
+
+        if (stops != 0) {
+            return text + __builtin_ctz(stops);
+        }
+    }
+}
+
+AVX2_TARGET static size_t findNewlinesAvx2(const char *text, size_t length, unsigned int *offsets) {
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        unsigned int newlines = byteMask32(_mm256_loadu_si256((const __m256i *)(text + i)), '\n');
+
+        if (offsets) {
+            for (; newlines != 0; newlines &= newlines - 1) {
+                offsets[count++] = (unsigned int)(i + __builtin_ctz(newlines) + 1);
+            }
+        } else {
+            count += __builtin_popcount(newlines);
+        }
+    }
+    return findNewlinesFrom(text, i, length, offsets, count);
+}
+
+#endif
+
+/* The active kernels; simdScanInit() repoints them */
+const char *(*skipWhitespace)(const char *text) = skipWhitespaceScalar;
+const char *(*skipCommentBody)(const char *text) = skipCommentBodyScalar;
+const char *(*skipQuotedBody)(const char *text, char quote) = skipQuotedBodyScalar;
+const char *(*skipToLineEnd)(const char *text) = skipToLineEndScalar;
+size_t (*findNewlines)(const char *text, size_t length, unsigned int *offsets) = findNewlinesScalar;
+
+/**
+ * Selects the fastest kernel set the CPU supports, capped at limit.
+ * Returns the level selected.
+ */
+SimdLevel simdScanInit(SimdLevel limit) {
+    SimdLevel level = SIMD_SCALAR;
+
+#ifdef SIMD_SCAN_X86
+    __builtin_cpu_init();
+    if (limit >= SIMD_AVX2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") &&
+        __builtin_cpu_supports("bmi")) {
+        level = SIMD_AVX2;
+    } else if (limit >= SIMD_SSE2 && __builtin_cpu_supports("sse2")) {
+        level = SIMD_SSE2;
+    }
+
+    if (level == SIMD_AVX2) {
+        skipWhitespace = skipWhitespaceAvx2;
+        skipCommentBody = skipCommentBodyAvx2;
+        skipQuotedBody = skipQuotedBodyAvx2;
+        skipToLineEnd = skipToLineEndAvx2;
+        findNewlines = findNewlinesAvx2;
+        return level;
+    }
+    if (level == SIMD_SSE2) {
+        skipWhitespace = skipWhitespaceSse2;
+        skipCommentBody = skipCommentBodySse2;
+        skipQuotedBody = skipQuotedBodySse2;
+        skipToLineEnd = skipToLineEndSse2;
+        findNewlines = findNewlinesSse2;
+        return level;
+    }
+#else
+    (void)limit;
+#endif
+
+    skipWhitespace = skipWhitespaceScalar;
+    skipCommentBody = skipCommentBodyScalar;
+    skipQuotedBody = skipQuotedBodyScalar;
+    skipToLineEnd = skipToLineEndScalar;
+    findNewlines = findNewlinesScalar;
+    return level;
+}
+
+/**
+ * Returns the printable name of a kernel set
+ */
+const char *simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX2: return "avx2";
+        case SIMD_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <stddef.h>
+
+// Zero bytes a buffer must have after its NUL terminator: the kernels read
+// whole 16- or 32-byte blocks and may run up to one block past the end
+#define SIMD_SCAN_PADDING 64
+
+// Kernel sets, from slowest to fastest
+typedef enum {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2
+} SimdLevel;
+
+// Skip kernels. Each returns the first byte at or after text that stops it
+// (never past the NUL terminator).
+
+// Stops at the first byte other than ' ', '\t', '\n', '\v', '\f' and '\r'
+extern const char *(*skipWhitespace)(const char *text);
+// Stops at the '*' of the next "*/"
+extern const char *(*skipCommentBody)(const char *text);
+// Stops at the next quote character or backslash
+extern const char *(*skipQuotedBody)(const char *text, char quote);
+// Stops at the next '\n'
+extern const char *(*skipToLineEnd)(const char *text);
+// Returns how many '\n' bytes text[0, length) holds; if offsets is not NULL,
+// also stores the offset just past each of them there
+extern size_t (*findNewlines)(const char *text, size_t length, unsigned int *offsets);
+
+// Function prototypes
+SimdLevel simdScanInit(SimdLevel limit);
+const char *simdLevelName(SimdLevel level);
+
+#endif // SIMD_SCAN_H
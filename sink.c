@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sink.h"
+
+// Start an empty sink writing to file
+static void sinkOpen(Sink *sink, SinkKind kind, FILE *file) {
+    sink->kind = kind;
+    sink->file = file;
+    sink->buffer = NULL;
+    sink->length = 0;
+    sink->bytes = 0;
+}
+
+// Write out everything gathered so far, in one block
+static void sinkDrain(Sink *sink) {
+    if (sink->length > 0 && sink->file) {
+        fwrite(sink->buffer, 1, sink->length, sink->file);
+    }
+    sink->length = 0;
+}
+
+// A sink writing to stdout
+void sinkOpenTerminal(Sink *sink) {
+    sinkOpen(sink, SINK_TERMINAL, stdout);
+}
+
+// A sink writing to stderr, for output that must stay out of the report
+void sinkOpenErrors(Sink *sink) {
+    sinkOpen(sink, SINK_TERMINAL, stderr);
+}
+
+// A sink writing to a new file at path; returns 0 if it cannot be created
+int sinkOpenFile(Sink *sink, const char *path) {
+    FILE *file = fopen(path, "wb");
+
+    if (!file) {
+        return 0;
+    }
+    // The sink gathers whole blocks itself
+    setvbuf(file, NULL, _IONBF, 0);
+    sinkOpen(sink, SINK_FILE, file);
+    return 1;
+}
+
+// A sink that drops everything, for timing the rendering alone
+void sinkOpenNull(Sink *sink) {
+    sinkOpen(sink, SINK_NULL, NULL);
+}
+
+// Room for size bytes (at most SINK_BUFFER_SIZE) at the end of the
+// buffer, to render into and then hand to sinkCommit()
+char *sinkReserve(Sink *sink, size_t size) {
+    if (!sink->buffer) {
+        sink->buffer = malloc(SINK_BUFFER_SIZE);
+        if (!sink->buffer) {
+            printf("Error: Out of memory (output buffer)\n");
+            exit(1);
+        }
+    }
+    if (SINK_BUFFER_SIZE - sink->length < size) {
+        sinkDrain(sink);
+    }
+    return sink->buffer + sink->length;
+}
+
+// Take the first length bytes of the room sinkReserve() gave
+void sinkCommit(Sink *sink, size_t length) {
+    sink->bytes += length;
+    sink->length += length;
+    if (sink->kind == SINK_NULL) {
+        sink->length = 0;
+    }
+}
+
+// Take length bytes of text
+void sinkWrite(Sink *sink, const char *text, size_t length) {
+    while (length > 0) {
+        size_t chunk = length < SINK_BUFFER_SIZE ? length : SINK_BUFFER_SIZE;
+        memcpy(sinkReserve(sink, chunk), text, chunk);
+        sinkCommit(sink, chunk);
+        text += chunk;
+        length -= chunk;
+    }
+}
+
+// Take printf-formatted text, from a va_list
+void sinkVprintf(Sink *sink, const char *format, va_list arguments) {
+    va_list again;
+    char *room = sinkReserve(sink, 0);
+    size_t space = SINK_BUFFER_SIZE - sink->length;
+
+    va_copy(again, arguments);
+    int length = vsnprintf(room, space, format, arguments);
+    if (length < 0) {
+        va_end(again);
+        return;
+    }
+    if ((size_t)length < space) {
+        sinkCommit(sink, (size_t)length);
+    } else if ((size_t)length < SINK_BUFFER_SIZE) {
+        // Did not fit behind what is waiting; it does once that is written
+        room = sinkReserve(sink, (size_t)length + 1);
+        vsnprintf(room, (size_t)length + 1, format, again);
+        sinkCommit(sink, (size_t)length);
+    } else {
+        char *text = malloc((size_t)length + 1);
+        if (!text) {
+            printf("Error: Out of memory (output buffer)\n");
+            exit(1);
+        }
+        vsnprintf(text, (size_t)length + 1, format, again);
+        sinkWrite(sink, text, (size_t)length);
+        free(text);
+    }
+    va_end(again);
+}
+
+// Take printf-formatted text
+void sinkPrintf(Sink *sink, const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    sinkVprintf(sink, format, arguments);
+    va_end(arguments);
+}
+
+// Length of the valid UTF-8 sequence at text, 0 if the bytes there are not one
+static size_t utf8SequenceLength(const unsigned char *text, size_t length) {
+    unsigned char lead = text[0];
+    unsigned char low = 0x80, high = 0xBF;  // Range of the second byte
+    size_t size;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+    if (size > length || text[1] < low || text[1] > high) {
+        return 0;
+    }
+    for (size_t i = 2; i < size; i++) {
+        if (text[i] < 0x80 || text[i] > 0xBF) {
+            return 0;
+        }
+    }
+    return size;
+}
+
+// Take text as a quoted JSON string. Control characters are escaped, and
+// bytes that are not valid UTF-8 become U+FFFD.
+void sinkJsonString(Sink *sink, const char *text, size_t length) {
+    const unsigned char *bytes = (const unsigned char *)text;
+    size_t run = 0;     // Start of the bytes that need no escaping
+
+    sinkWrite(sink, "\"", 1);
+    for (size_t i = 0; i < length; ) {
+        unsigned char byte = bytes[i];
+        size_t size = 1;
+
+        if (byte >= 0x20 && byte < 0x80 && byte != '"' && byte != '\\') {
+            i++;
+            continue;
+        }
+        if (byte >= 0x80 && (size = utf8SequenceLength(bytes + i, length - i)) > 0) {
+            i += size;
+            continue;
+        }
+        sinkWrite(sink, text + run, i - run);
+
+        char escape[8];
+        switch (byte) {
+            case '"': sinkWrite(sink, "\\\"", 2); break;
+            case '\\': sinkWrite(sink, "\\\\", 2); break;
+            case '\n': sinkWrite(sink, "\\n", 2); break;
+            case '\r': sinkWrite(sink, "\\r", 2); break;
+            case '\t': sinkWrite(sink, "\\t", 2); break;
+            default:
+                snprintf(escape, sizeof(escape), "\\u%04x", byte >= 0x80 ? 0xFFFD : byte);
+                sinkWrite(sink, escape, 6);
+                break;
+        }
+        run = ++i;
+    }
+    sinkWrite(sink, text + run, length - run);
+    sinkWrite(sink, "\"", 1);
+}
+
+// Show what has been gathered: a terminal sink writes it now, a file sink
+// keeps gathering until its buffer fills
+void sinkFlush(Sink *sink) {
+    if (sink->kind == SINK_TERMINAL) {
+        sinkDrain(sink);
+        fflush(sink->file);
+    }
+}
+
+// Write out what is left and release the sink
+void sinkClose(Sink *sink) {
+    sinkDrain(sink);
+    if (sink->kind == SINK_FILE) {
+        fclose(sink->file);
+    } else if (sink->file) {
+        fflush(sink->file);
+    }
+    free(sink->buffer);
+    sinkOpen(sink, SINK_NULL, NULL);
+}
@@ -0,0 +1,39 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#define SINK_BUFFER_SIZE (64 * 1024)    // Bytes gathered before a write
+
+// Where a sink's output goes. A zeroed Sink is a null sink.
+typedef enum {
+    SINK_NULL,          // Nowhere: output is rendered and dropped
+    SINK_TERMINAL,      // stdout or stderr, written at every sinkFlush() so progress shows
+    SINK_FILE           // A file, written only when the buffer fills or the sink closes
+} SinkKind;
+
+// Output gathered into one large buffer and written a block at a time
+typedef struct {
+    SinkKind kind;
+    FILE *file;                 // Destination; NULL for a null sink
+    char *buffer;               // SINK_BUFFER_SIZE bytes once the sink is open
+    size_t length;              // Bytes waiting in buffer
+    unsigned long long bytes;   // Bytes taken in since the sink opened
+} Sink;
+
+// Function prototypes
+void sinkOpenTerminal(Sink *sink);
+void sinkOpenErrors(Sink *sink);
+int sinkOpenFile(Sink *sink, const char *path);
+void sinkOpenNull(Sink *sink);
+char *sinkReserve(Sink *sink, size_t size);
+void sinkCommit(Sink *sink, size_t length);
+void sinkWrite(Sink *sink, const char *text, size_t length);
+void sinkPrintf(Sink *sink, const char *format, ...);
+void sinkVprintf(Sink *sink, const char *format, va_list arguments);
+void sinkJsonString(Sink *sink, const char *text, size_t length);
+void sinkFlush(Sink *sink);
+void sinkClose(Sink *sink);
+
+#endif // SINK_H
@@ -2,6 +2,9 @@
 #include<string.h>
 #include<ctype.h>
 #include<stdlib.h>
+#include "dictionaries.h"
+#include "fuzzy.h"
+#include "format.h"
 
 #define MAX_LINE_LENGTH 1024
 
@@ -144,42 +147,90 @@ void to_lowercase(char *str) {
 
 
 
+// scanf alone, and every standard library name, for catching misspelled scanf calls
+static Arena fuzzyArena = {0};
+static const char *const scanfName[] = {"scanf"};
+static FuzzyDictionary scanfDictionary = {0};
+static FuzzyDictionary stdLibDictionary = {0};
+
+// Function to check if a line has scanf in any case, or a call to a name a
+// typo or two away from it that no other library function is closer to
+int mentions_scanf(const char *line) {
+    if (scanfDictionary.count == 0) {
+        fuzzyInit(&scanfDictionary, &fuzzyArena, scanfName, 1);
+        fuzzyInit(&stdLibDictionary, &fuzzyArena, stdLibFunctionNames, STDLIB_FUNCTION_COUNT);
+    }
+
+    for (const char *p = line; *p; ) {
+        if (!isalnum((unsigned char)*p) && *p != '_') {
+            p++;
+            continue;
+        }
+
+        const char *word = p;
+        while (isalnum((unsigned char)*p) || *p == '_') p++;
+        int length = p - word;
+        int maxDistance = length >= 5 ? 2 : length == 4 ? 1 : 0;
+
+        FuzzyMatch match = fuzzyMatch(&scanfDictionary, word, length, maxDistance);
+        if (match.word < 0) {
+            continue;
+        }
+        if (match.distance == 0) {
+            return 1;
+        }
+
+        // A misspelling counts only when called, and when it is not closer to another function
+        const char *next = p;
+        while (*next == ' ' || *next == '\t') next++;
+        FuzzyMatch closest = fuzzyMatch(&stdLibDictionary, word, length, match.distance);
+        if (*next == '(' && closest.distance == match.distance) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static Arena formatArena = {0};
+static FormatCache printfFormats = {0};
+static FormatCache scanfFormats = {0};
+
+// The format string of a line, from its first to its last double quote,
+// parsed once per distinct string; NULL if the line has none
+const FormatString *line_format(const char *line, FormatCache *cache, FormatFlavor flavor) {
+    const char *start = strchr(line, '"');
+    const char *end = strrchr(line, '"');
+
+    if (start == NULL || start == end) {
+        return NULL;
+    }
+    if (cache->arena == NULL) {
+        formatCacheInit(cache, &formatArena, flavor);
+    }
+    return formatCompile(cache, start + 1, (int)(end - start) - 1);
+}
+
+// Whether a format string has a conversion of the given kind
+int format_uses(const FormatString *format, char conversion) {
+    if (format == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < format->count; i++) {
+        if (format->specs[i].conversion == (unsigned char)conversion) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 void check_scanf_errors(const char *line, int line_number) {
     char temp[MAX_LINE_LENGTH];
     strcpy(temp, line);
     to_lowercase(temp);
 
-    if (strstr(temp, "scanf") != NULL || strstr(temp, "scanff") != NULL 
-        || strstr(temp, "sanf") != NULL || strstr(temp, "scnaf") != NULL 
-        || strstr(temp, "scaanff") != NULL || strstr(temp, "sCnff") != NULL 
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scnff") != NULL 
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "scnff") != NULL 
-        || strstr(temp, "scnfff") != NULL || strstr(temp, "scnff") != NULL 
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scAnff") != NULL 
-        || strstr(temp, "SCnfff") != NULL || strstr(temp, "scNFf") != NULL 
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "sCANff") != NULL 
-        || strstr(temp, "SCANf") != NULL || strstr(temp, "scnaf") != NULL 
-        || strstr(temp, "sCaNf") != NULL || strstr(temp, "scnff") != NULL 
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnfff") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scAnff") != NULL
-        || strstr(temp, "SCnfff") != NULL || strstr(temp, "scNFf") != NULL
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "sCANff") != NULL
-        || strstr(temp, "SCANf") != NULL || strstr(temp, "scnaf") != NULL
-        || strstr(temp, "sCaNf") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnfff") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scAnff") != NULL
-        || strstr(temp, "SCnfff") != NULL || strstr(temp, "scNFf") != NULL
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "sCANff") != NULL
-        || strstr(temp, "SCANf") != NULL || strstr(temp, "scnaf") != NULL
-        || strstr(temp, "sCaNf") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "SCANF") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnfff") != NULL || strstr(temp, "scnff") != NULL
-        || strstr(temp, "scnff") != NULL || strstr(temp, "scAnff") != NULL){
+    if (mentions_scanf(line)) {
+        const FormatString *format = line_format(line, &scanfFormats, FORMAT_SCANF);
+
         if (strstr(line, "scanf") == NULL) {
             printf("Error: 'scanf' is case-sensitive, incorrect usage at line %d\n", line_number);
             printf("Fix: Use 'scanf' in lowercase.\n");
@@ -192,7 +243,7 @@ void check_scanf_errors(const char *line, int line_number) {
             printf("Error: Missing format specifier in scanf at line %d\n", line_number);
             printf("Fix: Add a format specifier like \"%%d\", \"%%f\", etc.\n");
         }
-        if (strstr(line, "&") == NULL && strstr(line, "%d") != NULL) {
+        if (strstr(line, "&") == NULL && format_uses(format, 'd')) {
             printf("Warning: Missing '&' for integer variable in scanf at line %d\n", line_number);
             printf("Fix: Use '&' before the variable (e.g., &var).\n");
         }
@@ -210,11 +261,11 @@ void check_scanf_errors(const char *line, int line_number) {
             printf("Warning: Missing semicolon at the end of scanf statement at line %d\n", line_number);
             printf("Fix: Add ';' at the end.\n");
         }
-        if (strstr(line, "%d") != NULL && strstr(line, "float") != NULL) {
+        if (format_uses(format, 'd') && strstr(line, "float") != NULL) {
             printf("Warning: Using '%%d' for float at line %d\n", line_number);
             printf("Fix: Use '%%f' for float variables.\n");
         }
-        if (strstr(line, "%f") != NULL && strstr(line, "int") != NULL) {
+        if (format_uses(format, 'f') && strstr(line, "int") != NULL) {
             printf("Warning: Using '%%f' for int at line %d\n", line_number);
             printf("Fix: Use '%%d' for int variables.\n");
         }
@@ -558,7 +609,8 @@ void check_printf_errors(const char *line, int line_number) {
         char *start = strchr(line, '"');  // Find first "
         char *end = strrchr(line, '"');   // Find last "
         if (start && end && start != end) { // Ensure valid format string
-            int contains_percent = strstr(start, "%") != NULL; 
+            const FormatString *format = line_format(line, &printfFormats, FORMAT_PRINTF);
+            int contains_percent = format->count > 0;
             char *after_quote = end + 1; 
 
             // Detect missing comma after format string
@@ -636,7 +688,6 @@ int main(){
     }
     
 
-    fclose(input);
     printf("\nScan complete.\n");
     
     
@@ -745,7 +796,6 @@ int findCommentStart(char arr[], int length){
 // Function to count built-in functions
 void countBuiltInFunctions(fileline arr[], int length){
     char currentLine[1000], wordBuffer[100];
-    char builtInFunctions[30][10] = {"printf", "scanf", "gets", "puts", "fscanf", "fprintf", "fgets", "fputs", "fputc", "fgetc", "fopen", "fclose", "feof", "fflush", "malloc", "calloc", "rand", "strcmp", "strlen", "strcpy", "strncpy", "strncmp", "tolower", "toupper", "strrev", "getch", "strcat",  "strncat", "sqrt", "pow"};
     int builtInCount = 0;
 
     for (int lineIndex = 0; lineIndex < length; lineIndex++) {
@@ -759,10 +809,8 @@ void countBuiltInFunctions(fileline arr[], int length){
 
                 if (bufferIndex > 0) {
                     wordBuffer[bufferIndex] = '\0'; 
-                    for (int functionIndex = 0; functionIndex < 30; functionIndex++) {
-                        if (strcmp(wordBuffer, builtInFunctions[functionIndex]) == 0) {
-                            builtInCount++;
-                        }
+                    if (lookupStdLibFunction(wordBuffer, bufferIndex) >= 0) {
+                        builtInCount++;
                     }
                     bufferIndex = 0; 
                 }
@@ -1062,12 +1110,6 @@ int forcheck(char arr[], int size) {
  
 void keyword(fileline arr[], int len) {
     
-    char keywords[32][10] = {
-        "auto", "double", "int", "struct", "break", "else", "long", "switch",
-        "case", "enum", "register", "typedef", "char", "extern", "return", "union",
-        "const", "float", "short", "unsigned", "continue", "for", "signed", "void",
-        "default", "goto", "sizeof", "volatile", "do", "if", "static", "while"
-    };
     char str[100], word[100];
         int k = 0; 
     
@@ -1083,10 +1125,8 @@ void keyword(fileline arr[], int len) {
                     word[k] = '\0'; 
                     
                     
-                    for (int l = 0; l < 32; l++) {
-                        if (strcmp(word, keywords[l]) == 0) {
-                            printf("Line %d: %s\n", arr[i].lineNumber, word);
-                        }
+                    if (lookupKeyword(word, k) >= 0) {
+                        printf("Line %d: %s\n", arr[i].lineNumber, word);
                     }
                     k = 0; 
                 }
@@ -0,0 +1,187 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suggest.h"
+
+// What a lookup carries down the trie
+typedef struct {
+    const SuggestIndex *index;
+    unsigned char name[SUGGEST_MAX_LENGTH];   // The name looked up, folded
+    int length;
+    int rows[SUGGEST_MAX_LENGTH + 1][SUGGEST_MAX_LENGTH + 1]; // rows[d][i]: distance between the node's prefix at depth d and the name's first i bytes
+    int best;               // Largest distance still of interest
+    bool (*accept)(int value, void *context);
+    void *context;
+    int *values;
+    int found;
+    int maxValues;
+} SuggestSearch;
+
+// Add a node with no children or words, returning its index
+static int addNode(SuggestIndex *index, unsigned char byte) {
+    index->nodes = arenaGrowArray(index->arena, index->nodes, index->nodeCount, &index->nodeCapacity, sizeof(SuggestNode));
+    index->nodes[index->nodeCount] = (SuggestNode){-1, -1, -1, byte};
+    return index->nodeCount++;
+}
+
+// Start an index holding no words
+void suggestInit(SuggestIndex *index, Arena *arena) {
+    memset(index, 0, sizeof(*index));
+    index->arena = arena;
+    addNode(index, 0);
+}
+
+// Add a word, following or creating the path of its folded bytes
+void suggestAdd(SuggestIndex *index, const char *text, int length, int value) {
+    int node = 0;
+
+    if (length > SUGGEST_MAX_LENGTH) {
+        return;
+    }
+    for (int i = 0; i < length; i++) {
+        unsigned char byte = (unsigned char)tolower((unsigned char)text[i]);
+        int child = index->nodes[node].firstChild;
+
+        while (child >= 0 && index->nodes[child].byte != byte) {
+            child = index->nodes[child].nextSibling;
+        }
+        if (child < 0) {
+            child = addNode(index, byte);
+            index->nodes[child].nextSibling = index->nodes[node].firstChild;
+            index->nodes[node].firstChild = child;
+        }
+        node = child;
+    }
+
+    index->words = arenaGrowArray(index->arena, index->words, index->wordCount, &index->wordCapacity, sizeof(SuggestWord));
+    index->words[index->wordCount] = (SuggestWord){text, value, index->nodes[node].firstWord};
+    index->nodes[node].firstWord = index->wordCount++;
+}
+
+// Record a word at the given distance, keeping only the nearest ones
+static void recordWord(SuggestSearch *search, int value, int distance) {
+    if (distance < search->best) {
+        // Closer than all found so far: only this distance counts from now on
+        search->best = distance;
+        search->found = 0;
+    }
+    for (int k = 0; k < search->found; k++) {
+        if (search->values[k] == value) {
+            return;
+        }
+    }
+
+    if (search->found < search->maxValues) {
+        search->values[search->found++] = value;
+        return;
+    }
+    // Keep the smallest values, so the result does not depend on the trie's shape
+    int largest = 0;
+    for (int k = 1; k < search->found; k++) {
+        if (search->values[k] > search->values[largest]) {
+            largest = k;
+        }
+    }
+    if (value < search->values[largest]) {
+        search->values[largest] = value;
+    }
+}
+
+// Visit the node at the given depth, whose row the caller has filled in
+static void searchNode(SuggestSearch *search, int node, int depth) {
+    const SuggestNode *current = &search->index->nodes[node];
+    const int *row = search->rows[depth];
+
+    // The row is only filled in within best of the diagonal
+    if (abs(search->length - depth) <= search->best && row[search->length] <= search->best) {
+        for (int w = current->firstWord; w >= 0; w = search->index->words[w].next) {
+            const SuggestWord *word = &search->index->words[w];
+            if (row[search->length] <= search->best &&
+                (search->accept == NULL || search->accept(word->value, search->context))) {
+                recordWord(search, word->value, row[search->length]);
+            }
+        }
+    }
+    if (depth == SUGGEST_MAX_LENGTH) {
+        return;
+    }
+
+    for (int child = current->firstChild; child >= 0; child = search->index->nodes[child].nextSibling) {
+        unsigned char byte = search->index->nodes[child].byte;
+        int *next = search->rows[depth + 1];
+        int smallest = next[0] = depth + 1;
+        // Cells further than best from the diagonal cannot be within best;
+        // the band's borders hold best + 1 in their place
+        int from = depth + 1 - search->best, to = depth + 1 + search->best;
+
+        if (from < 1) {
+            from = 1;
+        } else {
+            next[from - 1] = search->best + 1;
+        }
+        if (to >= search->length) {
+            to = search->length;
+        } else {
+            next[to + 1] = search->best + 1;
+        }
+        if (from > 1) {
+            smallest = search->best + 1;
+        }
+        for (int i = from; i <= to; i++) {
+            int cost = row[i - 1] + (search->name[i - 1] != byte);
+            if (row[i] + 1 < cost) {
+                cost = row[i] + 1;
+            }
+            if (next[i - 1] + 1 < cost) {
+                cost = next[i - 1] + 1;
+            }
+            next[i] = cost;
+            if (cost < smallest) {
+                smallest = cost;
+            }
+        }
+        // Longer prefixes only add edits, so nothing below can get closer than this row's best
+        if (smallest <= search->best) {
+            searchNode(search, child, depth + 1);
+        }
+    }
+}
+
+// Find the words nearest to a name, within maxDistance edits ignoring case,
+// that accept() takes (NULL takes all). Stores up to maxValues of their
+// values, all at the smallest distance found, smallest values first, and
+// returns how many.
+int suggestNearest(const SuggestIndex *index, const char *text, int length, int maxDistance,
+                   bool (*accept)(int value, void *context), void *context, int *values, int maxValues) {
+    SuggestSearch search;
+
+    if (index->wordCount == 0 || length > SUGGEST_MAX_LENGTH || maxValues <= 0 || maxDistance < 0) {
+        return 0;
+    }
+
+    search.index = index;
+    search.length = length;
+    search.best = maxDistance;
+    search.accept = accept;
+    search.context = context;
+    search.values = values;
+    search.found = 0;
+    search.maxValues = maxValues;
+    for (int i = 0; i < length; i++) {
+        search.name[i] = (unsigned char)tolower((unsigned char)text[i]);
+    }
+    for (int i = 0; i <= length; i++) {
+        search.rows[0][i] = i;
+    }
+    searchNode(&search, 0, 0);
+
+    // Insertion sort: there are only a few
+    for (int k = 1; k < search.found; k++) {
+        int value = values[k], j = k - 1;
+        for (; j >= 0 && values[j] > value; j--) {
+            values[j + 1] = values[j];
+        }
+        values[j + 1] = value;
+    }
+    return search.found;
+}
@@ -0,0 +1,44 @@
+#ifndef SUGGEST_H
+#define SUGGEST_H
+
+#include <stdbool.h>
+#include "arena.h"
+
+#define SUGGEST_MAX_LENGTH 64   // Longest word indexed, and so the trie's depth
+
+// An index for finding the words nearest to a misspelled name: a trie of
+// the words folded to lower case. A lookup walks it computing one row of
+// the edit distance table per trie level, shared by every word with that
+// prefix, and leaves a branch as soon as no entry in the row is within the
+// distance sought. Words can be added at any time; those longer than
+// SUGGEST_MAX_LENGTH are not indexed.
+typedef struct {
+    const char *text;       // The word; it must outlive the index
+    int value;              // What the caller stored with the word
+    int next;               // Next word ending at the same node, -1 after the last
+} SuggestWord;
+
+typedef struct {
+    int firstChild;         // -1 if none
+    int nextSibling;        // Next child of the same parent, -1 after the last
+    int firstWord;          // First word ending here, -1 if none
+    unsigned char byte;     // Folded byte on the edge from the parent
+} SuggestNode;
+
+typedef struct {
+    Arena *arena;           // Where the arrays live
+    SuggestNode *nodes;     // nodes[0] is the root, the empty prefix
+    int nodeCount;
+    int nodeCapacity;
+    SuggestWord *words;
+    int wordCount;
+    int wordCapacity;
+} SuggestIndex;
+
+// Function prototypes
+void suggestInit(SuggestIndex *index, Arena *arena);
+void suggestAdd(SuggestIndex *index, const char *text, int length, int value);
+int suggestNearest(const SuggestIndex *index, const char *text, int length, int maxDistance,
+                   bool (*accept)(int value, void *context), void *context, int *values, int maxValues);
+
+#endif // SUGGEST_H
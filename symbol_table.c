@@ -2,78 +2,180 @@
 #include <string.h>
 #include "symbol_table.h"
 
-Symbol symbolTable[MAX_SYMBOLS];    // Array to store symbols
+#define SYMBOL_MIN_SLOTS 64     // Slots of the first (name, scope) index
+
+Symbol *symbolTable = NULL;         // Array to store symbols
 int symbolCount = 0;                // Total number of symbols
+InternTable symbolNames = {0};      // Names and type names, NUL-terminated copies
+
+static int symbolCapacity = 0;
+static Arena symbolArena = {0};     // Symbols, names, parameter lists and the index
+static int *symbolSlots = NULL;     // (name, scope) index: symbol + 1, or 0 when empty
+static int symbolSlotCount = 0;     // Always a power of two
+
+// Hash of a (name ID, scope) key
+static unsigned int slotHash(int name, int scope) {
+    unsigned int hash = (unsigned int)name * 2654435769u ^ (unsigned int)scope * 40503u;
+    return hash ^ (hash >> 15);
+}
+
+// Find the slot of the symbol with this name and scope, or the empty slot where it belongs
+static int findSlot(int name, int scope) {
+    unsigned int mask = (unsigned int)symbolSlotCount - 1;
+    unsigned int slot = slotHash(name, scope) & mask;
+
+    while (symbolSlots[slot] != 0) {
+        const Symbol *symbol = &symbolTable[symbolSlots[slot] - 1];
+        if (symbol->name == name && symbol->scope == scope) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return (int)slot;
+}
+
+// Replace the index with one of slotCount slots holding every symbol
+static void resizeSlots(int slotCount) {
+    symbolSlots = arenaAlloc(&symbolArena, (size_t)slotCount * sizeof(int));
+    memset(symbolSlots, 0, (size_t)slotCount * sizeof(int));
+    symbolSlotCount = slotCount;
+
+    for (int i = 0; i < symbolCount; i++) {
+        symbolSlots[findSlot(symbolTable[i].name, symbolTable[i].scope)] = i + 1;
+    }
+}
+
+// Return the ID of a name, copying it into the arena the first time it is seen
+static int internText(const char *text) {
+    int length = (int)strlen(text);
+    int id = internFind(&symbolNames, text, length);
+
+    if (id < 0) {
+        id = internName(&symbolNames, arenaStrndup(&symbolArena, text, length), length);
+    }
+    return id;
+}
+
+// Text of a name or type name ID
+const char *symbolText(int id) {
+    return symbolNames.texts[id];
+}
 
 // Add a symbol to the symbol table
 int addSymbol(const char *name, const char *type, int scope, int isFunction, int paramCount, char paramTypes[][NAME_LENGTH], int memorySize) {
+    if (symbolSlotCount == 0) {
+        internInit(&symbolNames, &symbolArena, SYMBOL_MIN_SLOTS);
+        resizeSlots(SYMBOL_MIN_SLOTS);
+    }
+
     // Check if the symbol already exists
-    for (int i = 0; i < symbolCount; i++) {
-        if (strcmp(symbolTable[i].name, name) == 0 && symbolTable[i].scope == scope) {
-            return 0; // Symbol already exists
-        }
+    int nameId = internText(name);
+    int slot = findSlot(nameId, scope);
+    if (symbolSlots[slot] != 0) {
+        return 0; // Symbol already exists
     }
 
     // Add the new symbol to the symbol table
-    strcpy(symbolTable[symbolCount].name, name);
-    strcpy(symbolTable[symbolCount].type, type);
-    symbolTable[symbolCount].scope = scope;
-    symbolTable[symbolCount].isFunction = isFunction;
-    symbolTable[symbolCount].paramCount = paramCount;
-    symbolTable[symbolCount].memorySize = memorySize;
+    symbolTable = arenaGrowArray(&symbolArena, symbolTable, symbolCount, &symbolCapacity, sizeof(Symbol));
+    Symbol *symbol = &symbolTable[symbolCount];
+    symbol->name = nameId;
+    symbol->type = internText(type);
+    symbol->scope = scope;
+    symbol->isFunction = isFunction;
+    symbol->paramCount = paramCount;
+    symbol->paramTypes = NULL;
+    symbol->memorySize = memorySize;
 
     // Add parameter types for functions
-    if (isFunction) {
+    if (isFunction && paramCount > 0) {
+        int *types = arenaAlloc(&symbolArena, (size_t)paramCount * sizeof(int));
         for (int i = 0; i < paramCount; i++) {
-            strcpy(symbolTable[symbolCount].paramTypes[i], paramTypes[i]);
+            types[i] = internText(paramTypes[i]);
         }
+        symbol->paramTypes = types;
     }
 
+    symbolSlots[slot] = symbolCount + 1;
     symbolCount++; // Increment the symbol count
+
+    // Keep the load factor at or below one half
+    if (symbolCount * 2 > symbolSlotCount) {
+        resizeSlots(symbolSlotCount * 2);
+    }
     return 1;
 }
 
-// Lookup a symbol in the symbol table
+// Lookup a symbol in the symbol table: the first one added with this name,
+// in the given scope or the global one
 int lookupSymbol(const char *name, int scope, Symbol *result) {
-    for (int i = 0; i < symbolCount; i++) {
-        if (strcmp(symbolTable[i].name, name) == 0 && (symbolTable[i].scope == scope || symbolTable[i].scope == 0)) {
-            if (result) *result = symbolTable[i];
-            return 1;
-        }
+    if (symbolSlotCount == 0) {
+        return 0;
+    }
+
+    int nameId = internFind(&symbolNames, name, (int)strlen(name));
+    if (nameId < 0) {
+        return 0;
+    }
+
+    int local = symbolSlots[findSlot(nameId, scope)];
+    int global = symbolSlots[findSlot(nameId, 0)];
+    int found = local == 0 || (global != 0 && global < local) ? global : local;
+    if (found == 0) {
+        return 0;
+    }
+    if (result) *result = symbolTable[found - 1];
+    return 1;
+}
+
+// A symbol's memory size as text: the number of bytes, or "unknown"
+static const char *memorySizeText(const Symbol *symbol, char *buffer, size_t size) {
+    if (symbol->memorySize == MEMORY_SIZE_UNKNOWN) {
+        return "unknown";
     }
-    return 0;
+    snprintf(buffer, size, "%d", symbol->memorySize);
+    return buffer;
 }
 
 // Print the symbol table
 void printSymbolTable() {
+    char sizeText[16];
+
     printf("\nSymbol Table:\n");
     printf("Name\tType\tScope\tIsFunction\tParamCount\tMemorySize\n");
     for (int i = 0; i < symbolCount; i++) {
-        printf("%s\t%s\t%s\t%d\t%d\t%d\n", symbolTable[i].name, symbolTable[i].type,
+        printf("%s\t%s\t%s\t%d\t%d\t%s\n", symbolText(symbolTable[i].name), symbolText(symbolTable[i].type),
                symbolTable[i].scope == 0 ? "Global" : "Local",
-               symbolTable[i].isFunction, symbolTable[i].paramCount, symbolTable[i].memorySize);
+               symbolTable[i].isFunction, symbolTable[i].paramCount,
+               memorySizeText(&symbolTable[i], sizeText, sizeof(sizeText)));
     }
 }
 
 // Calculate memory usage
 void calculateMemoryUsage() {
     int totalMemory = 0;
+    int unknownCount = 0;
+    char sizeText[16];
     printf("\nDebug: Symbol Table Contents:\n");
     for (int i = 0; i < symbolCount; i++) {
-        printf("Name: %s, Type: %s, Scope: %d, IsFunction: %d, MemorySize: %d\n",
-               symbolTable[i].name, symbolTable[i].type, symbolTable[i].scope,
-               symbolTable[i].isFunction, symbolTable[i].memorySize);
+        printf("Name: %s, Type: %s, Scope: %d, IsFunction: %d, MemorySize: %s\n",
+               symbolText(symbolTable[i].name), symbolText(symbolTable[i].type), symbolTable[i].scope,
+               symbolTable[i].isFunction, memorySizeText(&symbolTable[i], sizeText, sizeof(sizeText)));
     }
+
+    // Each variable's size was recorded with it, whatever its type, arrays
+    // with all their elements; those of unknown size are counted apart
     for (int i = 0; i < symbolCount; i++) {
-        if (!symbolTable[i].isFunction) { // Only calculate memory for variables, not functions
-            if (strcmp(symbolTable[i].type, "int") == 0) {
-                totalMemory += sizeof(int); // int typically uses 4 bytes
-            } else if (strcmp(symbolTable[i].type, "double") == 0) {
-                totalMemory += sizeof(double); // double typically uses 8 bytes
-            } else if (strcmp(symbolTable[i].type, "char") == 0) {
-                totalMemory += sizeof(char); // char typically uses 1 byte
-            }
+        if (symbolTable[i].isFunction) {
+            continue; // Only calculate memory for variables, not functions
+        }
+        if (symbolTable[i].memorySize == MEMORY_SIZE_UNKNOWN) {
+            unknownCount++;
+        } else {
+            totalMemory += symbolTable[i].memorySize;
         }
     }
     printf("\nTotal Memory Used: %d bytes\n", totalMemory);
-}
\ No newline at end of file
+    if (unknownCount > 0) {
+        printf("Arrays of unknown size, not counted: %d\n", unknownCount);
+    }
+}
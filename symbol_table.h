@@ -1,28 +1,33 @@
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
-#define MAX_SYMBOLS 1000
+#include "arena.h"
+#include "intern.h"
+
 #define NAME_LENGTH 100
-#define MAX_PARAMS 100
+#define MEMORY_SIZE_UNKNOWN -1      // memorySize of an array whose dimension is not a constant
 
-// Symbol Table Structure
+// Symbol Table Structure. Names and type names are interned in symbolNames
+// and parameter lists live in symbolArena, so a symbol is a few words.
 typedef struct {
-    char name[NAME_LENGTH];          // Name of the symbol (variable or function)
-    char type[NAME_LENGTH];         // Data type (e.g., int, char, double)
+    int name;                       // ID of the symbol's name (variable or function)
+    int type;                       // ID of its data type (e.g., int, char, double)
     int scope;                      // Scope level (0 for global, 1 for local)
     int isFunction;                 // 1 if it's a function, 0 otherwise
     int paramCount;                 // Number of parameters (for functions)
-    char paramTypes[MAX_PARAMS][NAME_LENGTH]; // Types of parameters (for functions)
-    int memorySize;                 // Memory used by the variable in bytes
+    const int *paramTypes;          // IDs of the parameter types (for functions)
+    int memorySize;                 // Memory used by the variable in bytes, or MEMORY_SIZE_UNKNOWN
 } Symbol;
 
-extern Symbol symbolTable[MAX_SYMBOLS];    // Array to store symbols
-extern int symbolCount;                    // Total number of symbols
+extern Symbol *symbolTable;         // Symbols in the order they were added
+extern int symbolCount;             // Total number of symbols
+extern InternTable symbolNames;     // Every name and type name, by ID
 
 // Function prototypes
 int addSymbol(const char *name, const char *type, int scope, int isFunction, int paramCount, char paramTypes[][NAME_LENGTH], int memorySize);
 int lookupSymbol(const char *name, int scope, Symbol *result);
+const char *symbolText(int id);
 void printSymbolTable();
 void calculateMemoryUsage();
 
-#endif // SYMBOL_TABLE_H
\ No newline at end of file
+#endif // SYMBOL_TABLE_H
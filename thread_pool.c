@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+#define THREAD_POOL_MIN_DEQUE 16    // First capacity of a worker's deque
+
+typedef struct {
+    ThreadTask task;
+    void *argument;
+} QueuedTask;
+
+// One worker's tasks. The owner pushes and pops at the bottom (newest
+// first, which keeps its working set warm); idle workers steal from the
+// top (oldest first, which tends to be the biggest remaining work).
+typedef struct {
+    pthread_mutex_t lock;
+    QueuedTask *tasks;      // Ring buffer
+    int capacity;
+    int top;                // Index of the oldest task
+    int count;
+} TaskDeque;
+
+typedef struct {
+    ThreadPool *pool;
+    int index;
+} Worker;
+
+struct ThreadPool {
+    pthread_t *threads;
+    Worker *workers;
+    TaskDeque *deques;      // deques[i] belongs to worker i
+    int threadCount;
+    int nextDeque;          // Where the next task from outside the pool goes
+    pthread_mutex_t lock;           // Guards the fields below
+    pthread_cond_t workAvailable;   // Signalled when a task is queued or the pool stops
+    pthread_cond_t allDone;         // Signalled when pending drops to zero
+    int queued;             // Tasks sitting in the deques
+    int pending;            // Tasks submitted and not yet finished
+    bool stopping;
+};
+
+// The worker running on this thread, NULL for threads outside any pool
+static _Thread_local Worker *currentWorker = NULL;
+
+static void *checkedAlloc(void *block, size_t size) {
+    block = realloc(block, size);
+    if (!block) {
+        printf("Error: Out of memory (thread pool)\n");
+        exit(1);
+    }
+    return block;
+}
+
+static void pushBottom(TaskDeque *deque, QueuedTask task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        // Grow the ring, unwrapping it so the oldest task is at index 0
+        int capacity = deque->capacity ? deque->capacity * 2 : THREAD_POOL_MIN_DEQUE;
+        QueuedTask *tasks = checkedAlloc(NULL, capacity * sizeof(QueuedTask));
+        for (int i = 0; i < deque->count; i++) {
+            tasks[i] = deque->tasks[(deque->top + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->capacity = capacity;
+        deque->top = 0;
+    }
+    deque->tasks[(deque->top + deque->count) % deque->capacity] = task;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+}
+
+static bool popBottom(TaskDeque *deque, QueuedTask *task) {
+    bool found = false;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        deque->count--;
+        *task = deque->tasks[(deque->top + deque->count) % deque->capacity];
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static bool stealTop(TaskDeque *deque, QueuedTask *task) {
+    bool found = false;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        *task = deque->tasks[deque->top];
+        deque->top = (deque->top + 1) % deque->capacity;
+        deque->count--;
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Take the worker's own newest task, or else steal the oldest from another
+static bool findTask(Worker *worker, QueuedTask *task) {
+    ThreadPool *pool = worker->pool;
+
+    if (popBottom(&pool->deques[worker->index], task)) {
+        return true;
+    }
+    for (int i = 1; i < pool->threadCount; i++) {
+        if (stealTop(&pool->deques[(worker->index + i) % pool->threadCount], task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Worker loop: run tasks until the pool stops and nothing is left
+static void *workerMain(void *argument) {
+    Worker *worker = argument;
+    ThreadPool *pool = worker->pool;
+
+    currentWorker = worker;
+    for (;;) {
+        QueuedTask task;
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->queued == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->workAvailable, &pool->lock);
+        }
+        if (pool->queued == 0) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        // Another worker may get there first; then just wait again
+        if (!findTask(worker, &task)) {
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->queued--;
+        pthread_mutex_unlock(&pool->lock);
+
+        task.task(task.argument);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_broadcast(&pool->allDone);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    currentWorker = NULL;
+    return NULL;
+}
+
+// Start a pool of the given number of worker threads (at least one)
+ThreadPool *threadPoolCreate(int threads) {
+    ThreadPool *pool = checkedAlloc(NULL, sizeof(ThreadPool));
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    pool->threads = checkedAlloc(NULL, threads * sizeof(pthread_t));
+    pool->workers = checkedAlloc(NULL, threads * sizeof(Worker));
+    pool->deques = checkedAlloc(NULL, threads * sizeof(TaskDeque));
+    pool->threadCount = threads;
+    pool->nextDeque = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workAvailable, NULL);
+    pthread_cond_init(&pool->allDone, NULL);
+    pool->queued = 0;
+    pool->pending = 0;
+    pool->stopping = false;
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+        pool->deques[i].tasks = NULL;
+        pool->deques[i].capacity = 0;
+        pool->deques[i].top = 0;
+        pool->deques[i].count = 0;
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, workerMain, &pool->workers[i]) != 0) {
+            printf("Error: Could not start worker thread %d\n", i + 1);
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+// Queue a task. From one of the pool's workers it goes on that worker's own
+// deque; from outside, the deques are filled in turn.
+void threadPoolSubmit(ThreadPool *pool, ThreadTask task, void *argument) {
+    int target;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending++;
+    if (currentWorker && currentWorker->pool == pool) {
+        target = currentWorker->index;
+    } else {
+        target = pool->nextDeque;
+        pool->nextDeque = (pool->nextDeque + 1) % pool->threadCount;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    pushBottom(&pool->deques[target], (QueuedTask){task, argument});
+
+    pthread_mutex_lock(&pool->lock);
+    pool->queued++;
+    pthread_cond_signal(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Block until every submitted task has finished
+void threadPoolWait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->allDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Finish the queued tasks, stop the workers and release the pool
+void threadPoolDestroy(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->threadCount; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (int i = 0; i < pool->threadCount; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->workAvailable);
+    pthread_cond_destroy(&pool->allDone);
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->threads);
+    free(pool);
+}
+
+// Number of worker threads in the pool
+int threadPoolSize(ThreadPool *pool) {
+    return pool->threadCount;
+}
+
+// Index of the calling thread among the pool's workers, -1 if it is not one
+int threadPoolWorkerIndex(ThreadPool *pool) {
+    return currentWorker && currentWorker->pool == pool ? currentWorker->index : -1;
+}
+
+// Number of CPUs online, the natural size for a pool
+int threadPoolDefaultSize(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
@@ -0,0 +1,21 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// A fixed set of worker threads that run submitted tasks. Each worker keeps
+// its own deque and steals from the others when it runs dry. A task may
+// submit more tasks; threadPoolWait() returns once every task, including
+// those, has finished.
+typedef struct ThreadPool ThreadPool;
+
+typedef void (*ThreadTask)(void *argument);
+
+// Function prototypes
+ThreadPool *threadPoolCreate(int threads);
+void threadPoolSubmit(ThreadPool *pool, ThreadTask task, void *argument);
+void threadPoolWait(ThreadPool *pool);
+void threadPoolDestroy(ThreadPool *pool);
+int threadPoolSize(ThreadPool *pool);
+int threadPoolWorkerIndex(ThreadPool *pool);
+int threadPoolDefaultSize(void);
+
+#endif // THREAD_POOL_H
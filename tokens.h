@@ -0,0 +1,48 @@
+#ifndef TOKENS_H
+#define TOKENS_H
+
+// What a token is, as the lexer sorts them
+typedef enum {
+    TOKEN_IDENTIFIER,
+    TOKEN_KEYWORD,
+    TOKEN_NUMBER,
+    TOKEN_STRING,
+    TOKEN_CHAR,
+    TOKEN_OPERATOR,
+    TOKEN_SEPARATOR,
+    TOKEN_PREPROCESSOR,
+    TOKEN_COMMENT,
+    TOKEN_EOF
+} TokenType;
+
+#define TOKEN_TYPE_COUNT (TOKEN_EOF + 1)
+
+// The punctuator or keyword a token spells, KIND_NONE otherwise
+typedef enum {
+    KIND_NONE,
+
+    // Separators
+    KIND_LPAREN, KIND_RPAREN, KIND_LBRACE, KIND_RBRACE, KIND_LBRACKET, KIND_RBRACKET,
+    KIND_SEMICOLON, KIND_COMMA, KIND_DOT, KIND_ELLIPSIS,
+
+    // Single-character operators
+    KIND_PLUS, KIND_MINUS, KIND_STAR, KIND_SLASH, KIND_PERCENT, KIND_ASSIGN, KIND_LESS, KIND_GREATER,
+    KIND_NOT, KIND_AMPERSAND, KIND_PIPE, KIND_CARET, KIND_TILDE, KIND_QUESTION, KIND_COLON,
+
+    // Two-character operators
+    KIND_INCREMENT, KIND_DECREMENT, KIND_EQUAL, KIND_NOT_EQUAL, KIND_LESS_EQUAL, KIND_GREATER_EQUAL,
+    KIND_AND, KIND_OR, KIND_PLUS_ASSIGN, KIND_MINUS_ASSIGN, KIND_STAR_ASSIGN, KIND_SLASH_ASSIGN,
+    KIND_PERCENT_ASSIGN, KIND_AND_ASSIGN, KIND_OR_ASSIGN, KIND_XOR_ASSIGN, KIND_ARROW,
+    KIND_SHIFT_LEFT, KIND_SHIFT_RIGHT,
+
+    // Three-character operators
+    KIND_SHIFT_LEFT_ASSIGN, KIND_SHIFT_RIGHT_ASSIGN,
+
+    // Keywords, in the same order as keywordNames[]
+    KIND_AUTO, KIND_BREAK, KIND_CASE, KIND_CHAR, KIND_CONST, KIND_CONTINUE, KIND_DEFAULT, KIND_DO,
+    KIND_DOUBLE, KIND_ELSE, KIND_ENUM, KIND_EXTERN, KIND_FLOAT, KIND_FOR, KIND_GOTO, KIND_IF,
+    KIND_INT, KIND_LONG, KIND_REGISTER, KIND_RETURN, KIND_SHORT, KIND_SIGNED, KIND_SIZEOF, KIND_STATIC,
+    KIND_STRUCT, KIND_SWITCH, KIND_TYPEDEF, KIND_UNION, KIND_UNSIGNED, KIND_VOID, KIND_VOLATILE, KIND_WHILE
+} TokenKind;
+
+#endif // TOKENS_H
@@ -1,7 +1,7 @@
 #ifndef TYPES_H
 #define TYPES_H
 
-// Placeholder for type-related functions
+// Checks printf and scanf arguments against their format strings (analysis.c)
 void detectTypeMismatches(const char *line, int lineNumber);
 
 #endif // TYPES_H
\ No newline at end of file